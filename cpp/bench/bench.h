@@ -0,0 +1,138 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+// Minimal micro-benchmark harness shared by the walink benchmarks.
+// Prints one line per case: name, iterations, ns/op, Mops/s (and MB/s for
+// cases with a payload size).
+//
+// Command line (see init()):
+//   --json          one JSON object per case (JSON Lines) instead of the table:
+//                   {"suite","target","name","iterations","ns_per_op","bytes_per_op"}
+//   --filter=TEXT   run only the cases whose name contains TEXT
+//   --scale=X       multiply every iteration count by X (e.g. 0.1 for a quick run)
+
+namespace walink_bench {
+
+struct Options {
+    const char* suite = "walink";
+    bool json = false;
+    const char* filter = nullptr;
+    double scale = 1.0;
+};
+
+inline Options& options() noexcept {
+    static Options opts;
+    return opts;
+}
+
+inline const char* target() noexcept {
+#if defined(__wasm__)
+    return "wasm";
+#else
+    return "native";
+#endif
+}
+
+inline void init(int argc, char** argv, const char* suite) noexcept {
+    Options& opts = options();
+    opts.suite = suite;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0) {
+            opts.json = true;
+        } else if (strncmp(argv[i], "--filter=", 9) == 0) {
+            opts.filter = argv[i] + 9;
+        } else if (strncmp(argv[i], "--scale=", 8) == 0) {
+            opts.scale = atof(argv[i] + 8);
+        } else {
+            fprintf(stderr, "%s: unknown argument %s\n", suite, argv[i]);
+        }
+    }
+}
+
+template <typename T>
+inline void do_not_optimize(T const& value) noexcept {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void print_json_string(const char* s) noexcept {
+    putchar('"');
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') {
+            putchar('\\');
+        }
+        putchar(*s);
+    }
+    putchar('"');
+}
+
+inline void report(const char* name, uint64_t iterations, uint64_t bytes_per_op, double ns_per_op) noexcept {
+    const Options& opts = options();
+    if (opts.json) {
+        printf("{\"suite\":");
+        print_json_string(opts.suite);
+        printf(",\"target\":\"%s\",\"name\":", target());
+        print_json_string(name);
+        printf(",\"iterations\":%llu,\"ns_per_op\":%.3f,\"bytes_per_op\":%llu}\n",
+               static_cast<unsigned long long>(iterations),
+               ns_per_op,
+               static_cast<unsigned long long>(bytes_per_op));
+    } else if (bytes_per_op != 0) {
+        printf("%-40s %12llu %10.2f ns/op %10.2f Mops/s %10.1f MB/s\n",
+               name,
+               static_cast<unsigned long long>(iterations),
+               ns_per_op,
+               1e3 / ns_per_op,
+               static_cast<double>(bytes_per_op) * 1e3 / ns_per_op);
+    } else {
+        printf("%-40s %12llu %10.2f ns/op %10.2f Mops/s\n",
+               name,
+               static_cast<unsigned long long>(iterations),
+               ns_per_op,
+               1e3 / ns_per_op);
+    }
+    fflush(stdout);
+}
+
+// Runs fn() `iterations` times (after a 10% warm-up) and reports the mean.
+// bytes_per_op is the payload size a case moves per call, 0 if none.
+// Returns ns/op, or 0 when the case is filtered out.
+template <typename Fn>
+inline double run(const char* name, uint64_t iterations, uint64_t bytes_per_op, Fn&& fn) {
+    const Options& opts = options();
+    if (opts.filter != nullptr && strstr(name, opts.filter) == nullptr) {
+        return 0;
+    }
+    iterations = static_cast<uint64_t>(static_cast<double>(iterations) * opts.scale);
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    // warm-up
+    for (uint64_t i = 0; i < iterations / 10 + 1; ++i) {
+        fn();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    const double ns_per_op = ns / static_cast<double>(iterations);
+    report(name, iterations, bytes_per_op, ns_per_op);
+    return ns_per_op;
+}
+
+template <typename Fn>
+inline double run(const char* name, uint64_t iterations, Fn&& fn) {
+    return run(name, iterations, 0, static_cast<Fn&&>(fn));
+}
+
+} // namespace walink_bench
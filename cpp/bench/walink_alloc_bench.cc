@@ -0,0 +1,144 @@
+#include "walink.h"
+
+#include <stdlib.h>
+
+#include <string>
+
+#if WALINK_THREADS
+#include <atomic>
+#include <thread>
+#endif
+
+#include "bench.h"
+
+// Compares the default malloc/free path behind walink_alloc/walink_free with
+// the size-class pool allocator (wl_pool_alloc/wl_pool_free) on the block
+// sizes that dominate walink traffic. Threaded builds also measure blocks
+// allocated on one thread and released on another (producer/consumer), which
+// goes through the pool's remote free queue. The result round-trip cases
+// compare walink_free with the walink_recycle cache.
+
+namespace {
+
+constexpr uint64_t kIterations = 10'000'000;
+constexpr uint32_t kBatch = 1024;
+
+// Float64Container, empty BaseContainer and typical small string/bytes payloads.
+constexpr uint32_t kMixedSizes[] = {8, 8, 24, 40, 72, 136, 264, 8};
+constexpr uint32_t kMixedCount = sizeof(kMixedSizes) / sizeof(kMixedSizes[0]);
+
+struct MallocApi {
+    static void* alloc(uint32_t size) { return malloc(size); }
+    static void release(void* ptr) { free(ptr); }
+};
+
+struct PoolApi {
+    static void* alloc(uint32_t size) { return walink::wl_pool_alloc(size); }
+    static void release(void* ptr) { walink::wl_pool_free(ptr); }
+};
+
+template <typename Api>
+void bench_pair(const char* name, uint32_t size) {
+    walink_bench::run(name, kIterations, [size] {
+        void* p = Api::alloc(size);
+        walink_bench::do_not_optimize(p);
+        Api::release(p);
+    });
+}
+
+template <typename Api>
+void bench_batch(const char* name) {
+    static void* ptrs[kBatch];
+    walink_bench::run(name, kIterations / kBatch, [] {
+        for (uint32_t i = 0; i < kBatch; ++i) {
+            ptrs[i] = Api::alloc(kMixedSizes[i % kMixedCount]);
+        }
+        walink_bench::do_not_optimize(ptrs);
+        for (uint32_t i = 0; i < kBatch; ++i) {
+            Api::release(ptrs[i]);
+        }
+    });
+}
+
+// Result container round trip as a host sees it: build a 64-byte string,
+// then release it with walink_free or hand it back with walink_recycle.
+template <bool Recycle>
+void bench_result_roundtrip(const char* name) {
+    static const std::string payload(64, 'x');
+    walink_bench::run(name, kIterations, [] {
+        const WL_VALUE v = walink::wl_make_string(payload, /*free_flag_for_receiver*/ true);
+        walink_bench::do_not_optimize(v);
+        if constexpr (Recycle) {
+            walink_recycle(v);
+        } else {
+            walink_free(v);
+        }
+    });
+}
+
+#if WALINK_THREADS
+// Main thread allocates a batch, a second thread frees it while the next batch
+// is being filled (double-buffered handoff).
+template <typename Api>
+void bench_cross_thread(const char* name) {
+    static void* ptrs[2][kBatch];
+    std::atomic<int> ready{-1};
+    std::atomic<bool> done{false};
+
+    std::thread consumer([&] {
+        for (;;) {
+            const int b = ready.load(std::memory_order_acquire);
+            if (b < 0) {
+                if (done.load(std::memory_order_acquire)) {
+                    return;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+            for (uint32_t i = 0; i < kBatch; ++i) {
+                Api::release(ptrs[b][i]);
+            }
+            ready.store(-1, std::memory_order_release);
+        }
+    });
+
+    int buffer = 0;
+    walink_bench::run(name, kIterations / kBatch, [&] {
+        for (uint32_t i = 0; i < kBatch; ++i) {
+            ptrs[buffer][i] = Api::alloc(kMixedSizes[i % kMixedCount]);
+        }
+        while (ready.load(std::memory_order_acquire) >= 0) {
+            std::this_thread::yield();
+        }
+        ready.store(buffer, std::memory_order_release);
+        buffer ^= 1;
+    });
+
+    while (ready.load(std::memory_order_acquire) >= 0) {
+        std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+}
+#endif
+
+} // namespace
+
+int main(int argc, char** argv) {
+    walink_bench::init(argc, argv, "walink_alloc_bench");
+    bench_pair<MallocApi>("malloc/free 8B (Float64Container)", 8);
+    bench_pair<PoolApi>("pool   alloc/free 8B (Float64Container)", 8);
+    bench_pair<MallocApi>("malloc/free 72B (BaseContainer)", 72);
+    bench_pair<PoolApi>("pool   alloc/free 72B (BaseContainer)", 72);
+    bench_pair<MallocApi>("malloc/free 4096B (large)", 4096);
+    bench_pair<PoolApi>("pool   alloc/free 4096B (large)", 4096);
+    bench_batch<MallocApi>("malloc/free mixed x1024");
+    bench_batch<PoolApi>("pool   alloc/free mixed x1024");
+    bench_result_roundtrip<false>("string 64B + walink_free");
+    bench_result_roundtrip<true>("string 64B + walink_recycle");
+#if WALINK_THREADS
+    bench_cross_thread<MallocApi>("malloc/free cross-thread x1024");
+    bench_cross_thread<PoolApi>("pool   alloc/free cross-thread x1024");
+#endif
+    return 0;
+}
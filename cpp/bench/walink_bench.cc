@@ -0,0 +1,199 @@
+#include "walink.h"
+#include "walink_export.h"
+#include "walink_msgpack.h"
+#include "walink_utf.h"
+
+#include <stdio.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench.h"
+
+// Marshalling hot paths of the C++ side, per payload size:
+//   - encode: wl_make_string / wl_make_bytes / wl_make_array / msgpack::Writer
+//     / wl_make_text (each followed by walink_free, as the host would)
+//   - decode: wl_read_base_container (copy), wl_try_borrow_string (view),
+//     wl_to_f64
+//   - walink_alloc / walink_free on the host-argument path
+//   - a WL_EXPORT call through its packed entry (argument checks + codecs)
+//
+// The same source builds natively and with em++ (run the .js with node), so
+// the two targets can be compared case by case; `--json` output carries a
+// "target" field for that.
+
+namespace {
+
+constexpr uint32_t kSizes[] = {16, 1024, 65536};
+
+// Roughly constant time per case across payload sizes.
+uint64_t iterations_for(uint64_t bytes) {
+    const uint64_t n = (64ull << 20) / (bytes + 64);
+    return n < 1000 ? 1000 : (n > 2'000'000 ? 2'000'000 : n);
+}
+
+std::string ascii_payload(uint32_t size) {
+    std::string s(size, '\0');
+    for (uint32_t i = 0; i < size; ++i) {
+        s[i] = static_cast<char>('a' + i % 26);
+    }
+    return s;
+}
+
+// 3-byte UTF-8 sequences (Hangul), rounded up to whole characters so the
+// 1KiB case reaches WL_STRING16_MIN_BYTES and takes the UTF-16 path.
+std::string text_payload(uint32_t size) {
+    std::string s;
+    s.reserve(size + 2);
+    while (s.size() < size) {
+        s += "\xea\xb0\x80";
+    }
+    return s;
+}
+
+std::string case_name(const char* what, uint32_t size) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%s %uB", what, size);
+    return buf;
+}
+
+void bench_strings() {
+    for (const uint32_t size : kSizes) {
+        const std::string payload = ascii_payload(size);
+        const uint64_t n = iterations_for(size);
+
+        walink_bench::run(case_name("wl_make_string + free", size).c_str(), n, size, [&] {
+            const WL_VALUE v = walink::wl_make_string(payload, true);
+            walink_bench::do_not_optimize(v);
+            walink_free(v);
+        });
+        walink_bench::run(case_name("wl_make_bytes + free", size).c_str(), n, size, [&] {
+            const WL_VALUE v = walink::wl_make_bytes(payload, true);
+            walink_bench::do_not_optimize(v);
+            walink_free(v);
+        });
+
+        const WL_VALUE value = walink::wl_make_string(payload, false);
+        walink_bench::run(case_name("wl_read_base_container", size).c_str(), n, size, [&] {
+            const std::string s = walink::wl_read_base_container(value, false);
+            walink_bench::do_not_optimize(s.data());
+        });
+        walink_bench::run(case_name("wl_try_borrow_string", size).c_str(), n, [&] {
+            const auto ref = walink::wl_try_borrow_string(value, false);
+            walink_bench::do_not_optimize(ref->str().data());
+        });
+        walink_free(value);
+
+        walink_bench::run(case_name("wl_make_string + wl_to_string", size).c_str(), n, size, [&] {
+            const std::string s = walink::wl_to_string(walink::wl_make_string(payload, true), true);
+            walink_bench::do_not_optimize(s.data());
+        });
+    }
+}
+
+void bench_text() {
+    for (const uint32_t size : kSizes) {
+        const std::string payload = text_payload(size);
+        const uint64_t n = iterations_for(size);
+        const std::span<const uint8_t> bytes(reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+
+        walink_bench::run(case_name("wl_utf8_validate (non-ASCII)", size).c_str(), n, bytes.size(), [&] {
+            walink_bench::do_not_optimize(walink::wl_utf8_validate(bytes));
+        });
+        walink_bench::run(case_name("wl_make_text + free (non-ASCII)", size).c_str(), n, bytes.size(), [&] {
+            const WL_VALUE v = walink::wl_make_text(payload, true);
+            walink_bench::do_not_optimize(v);
+            walink_free(v);
+        });
+    }
+}
+
+void bench_alloc() {
+    constexpr uint32_t kBlockSizes[] = {8, 72, 4096};
+    for (const uint32_t size : kBlockSizes) {
+        walink_bench::run(case_name("walink_alloc/free", size).c_str(), 5'000'000, [size] {
+            // walink_alloc hands out a bare pointer; the host tags it before
+            // passing (or freeing) it
+            const WL_VALUE v = walink_alloc(size);
+            walink_bench::do_not_optimize(v);
+            walink_free(walink::wl_make(WL_META_IS_ADDRESS | WL_TAG_BYTES, walink::wl_get_payload32(v)));
+        });
+    }
+}
+
+void bench_scalars() {
+    double x = 1.5;
+    walink_bench::run("wl_make_f64 + wl_to_f64", 5'000'000, [&] {
+        x = walink::wl_to_f64(walink::wl_make_f64(x, true), true) + 1.0;
+        walink_bench::do_not_optimize(x);
+    });
+
+    for (const uint32_t size : kSizes) {
+        const std::vector<double> items(size / sizeof(double), 0.25);
+        walink_bench::run(case_name("wl_make_array<double> + free", size).c_str(), iterations_for(size), size, [&] {
+            const WL_VALUE v = walink::wl_make_array<double>(items, true);
+            walink_bench::do_not_optimize(v);
+            walink_free(v);
+        });
+    }
+}
+
+void bench_msgpack() {
+    walink_bench::run("msgpack::Writer map x8 + free", 2'000'000, [] {
+        walink::msgpack::Writer w(128, true);
+        w.write_map_header(8);
+        for (int i = 0; i < 8; ++i) {
+            const char key[2] = {static_cast<char>('a' + i), '\0'};
+            w.write_str(key);
+            w.write_int(i * 1000);
+        }
+        const WL_VALUE v = w.finish();
+        walink_bench::do_not_optimize(v);
+        walink_free(v);
+    });
+}
+
+uint32_t bench_length(std::string_view s, uint32_t extra) {
+    return static_cast<uint32_t>(s.size()) + extra;
+}
+
+} // namespace
+
+WL_EXPORT(wl_bench_length, bench_length);
+
+namespace {
+
+void bench_export() {
+    const walink::ExportInfo* info = walink::wl_export_find("wl_bench_length");
+    for (const uint32_t size : kSizes) {
+        const std::string payload = ascii_payload(size);
+        const WL_VALUE args[2] = {walink::wl_make_string(payload, false), walink::wl_from_uint32(7)};
+        walink_bench::run(case_name("WL_EXPORT (string, uint32) call", size).c_str(), iterations_for(size), [&] {
+            walink_bench::do_not_optimize(info->invoke(args, 2));
+        });
+        walink_free(args[0]);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    walink_bench::init(argc, argv, "walink_bench");
+#if defined(__GLIBC__)
+    // WL_VALUE payloads are 32-bit addresses: keep the 64KiB cases out of
+    // mmap, which places blocks above 4GiB on 64-bit hosts.
+    mallopt(M_MMAP_MAX, 0);
+#endif
+    bench_strings();
+    bench_text();
+    bench_alloc();
+    bench_scalars();
+    bench_msgpack();
+    bench_export();
+    return 0;
+}
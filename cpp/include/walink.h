@@ -4,8 +4,13 @@
 #include <stddef.h>
 #include <string.h>
 
+#include <bit>
+#include <initializer_list>
+#include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
 // Public C ABI for walink wasm side
 
@@ -23,12 +28,23 @@ using WL_VALUE = uint64_t;
 //   0x14 : sint32
 //   0x24 : uint32
 //   0x30 : float32
+//   0x0400: handle (generation | slot index of a wasm-resident object;
+//           see walink_handle.h)
+//   0x0500: symbol (id of an interned string; see walink_symbol.h)
 //
 // is-address = 1 (payload is an address)
 //   0x31     : float64 (Float64Container*)
+//   0x18     : sint64  (8-byte slot; usually a scratch slot, see below)
+//   0x28     : uint64  (8-byte slot; usually a scratch slot, see below)
 //   0x01     : Bytes  (BaseContainer*; Node 에서는 Buffer)
 //   0x02     : String (BaseContainer*)
+//   0x03     : String16 (BaseContainer*; UTF-16LE code units, see walink_utf.h)
 //   0x0100   : Object (BaseContainer*; MsgPack 직렬화, Node 에서는 Object)
+//   0x02xx   : Typed numeric array (BaseContainer*; 0x0200 | element scalar tag,
+//              Node 에서는 Int8Array ~ Float64Array / BigInt64Array)
+//   0x0300   : Stream (chunked bytes/string/msgpack body; see walink_stream.h)
+//   0x0600   : Flat   (BaseContainer*; offset-indexed object, see walink_flat.h)
+//   0x0700   : IoVec  (BaseContainer*; list of borrowed byte segments, see wl_make_iovec)
 //   0x7fffff0: Error  (BaseContainer*; 문자열 오류 메세지, host 에서는 예외로 throw)
 enum WL_TAG : uint32_t {
     // region: direct values (is-address = 0)
@@ -42,6 +58,14 @@ enum WL_TAG : uint32_t {
     WL_TAG_SINT32   = 0x14,
     WL_TAG_UINT32   = 0x24,
     WL_TAG_FLOAT32  = 0x30,
+    // Generational handle to a wasm-resident object (see walink_handle.h).
+    // Released with walink_handle_release, never walink_free.
+    WL_TAG_HANDLE   = 0x0400,
+    // Interned string id (see walink_symbol.h). Never freed.
+    WL_TAG_SYMBOL   = 0x0500,
+    // Unfinished walink::Task (see walink_task.h); advanced with walink_poll,
+    // dropped with walink_cancel, never freed.
+    WL_TAG_PENDING  = 0x0800,
 
     // endregion
 
@@ -49,12 +73,36 @@ enum WL_TAG : uint32_t {
 
     // Float64Container*
     WL_TAG_FLOAT64  = 0x31,
+    // int64_t* / uint64_t*
+    WL_TAG_SINT64   = 0x18,
+    WL_TAG_UINT64   = 0x28,
     // BaseContainer*
     WL_TAG_BYTES    = 0x01,
     // BaseContainer*
     WL_TAG_STRING   = 0x02,
+    // BaseContainer*; UTF-16LE code units, size in bytes (walink_utf.h)
+    WL_TAG_STRING16 = 0x03,
     // MsgPack 직렬화, Node 에서는 Any (Object)
     WL_TAG_MSGPACK   = 0x0100,
+    // BaseContainer*; homogeneous little-endian element array, size in bytes.
+    // Tag = WL_TAG_ARRAY_BASE | element scalar tag.
+    WL_TAG_ARRAY_BASE    = 0x0200,
+    WL_TAG_ARRAY_SINT8   = 0x0211,
+    WL_TAG_ARRAY_UINT8   = 0x0221,
+    WL_TAG_ARRAY_SINT16  = 0x0212,
+    WL_TAG_ARRAY_UINT16  = 0x0222,
+    WL_TAG_ARRAY_SINT32  = 0x0214,
+    WL_TAG_ARRAY_UINT32  = 0x0224,
+    WL_TAG_ARRAY_FLOAT32 = 0x0230,
+    WL_TAG_ARRAY_FLOAT64 = 0x0231,
+    WL_TAG_ARRAY_SINT64  = 0x0218,
+    WL_TAG_ARRAY_UINT64  = 0x0228,
+    // Opaque stream handle; released with walink_stream_close (never walink_free)
+    WL_TAG_STREAM   = 0x0300,
+    // BaseContainer*; offset-indexed object read lazily by the host (walink_flat.h)
+    WL_TAG_FLAT     = 0x0600,
+    // BaseContainer*; { u32 count; { u32 ptr; u32 len }[count] } of borrowed segments
+    WL_TAG_IOVEC    = 0x0700,
     // BaseContainer*; 문자열 오류 메세지, host 에서는 예외로 throw
     WL_TAG_ERROR    = 0x7fffff0,
 
@@ -65,13 +113,17 @@ enum WL_TAG : uint32_t {
 // bit 31: user-defined tag flag
 // bit 30: is-address flag (1: payload is address, 0: direct value)
 // bit 29: free flag (1: receiver must walink_free the address)
-// bit 28: reserved
+// bit 28: arena flag (1: address lives in the per-call arena; released by
+//         walink_arena_reset, receiver must NOT walink_free it)
 // bit 27-0: 28-bit tag value
 constexpr uint32_t WL_META_USER_DEFINED = 0x80000000u;
 constexpr uint32_t WL_META_IS_ADDRESS   = 0x40000000u;
 constexpr uint32_t WL_META_FREE_FLAG    = 0x20000000u;
+constexpr uint32_t WL_META_ARENA_FLAG   = 0x10000000u;
 constexpr uint32_t WL_META_TAG_MASK     = 0x0FFFFFFFu;
 
+// Containers are always allocated 8-byte aligned, so `data` is suitably
+// aligned for every typed array element type.
 struct BaseContainer {
     uint32_t cap;
     uint32_t size;
@@ -82,34 +134,58 @@ struct Float64Container {
     double v;
 };
 
+// Number of 8-byte scratch slots per direction (wasm->host, host->wasm).
+// 64-bit scalars produced with wl_from_f64/wl_from_sint64/wl_from_uint64 are
+// written into the next slot of a fixed table instead of a heap container; the
+// value stays valid until WL_SCRATCH_SLOT_COUNT further scalars have been
+// produced on the same side. Such values never carry the free flag.
+constexpr uint32_t WL_SCRATCH_SLOT_COUNT = 64;
+
+// Per-thread runtime state (scratch slots, pool cache, arena) is thread_local
+// in threaded builds (WALINK_THREADS=1) and plain static storage otherwise.
+#if WALINK_THREADS
+#define WL_THREAD_LOCAL thread_local
+#else
+#define WL_THREAD_LOCAL
+#endif
+
 namespace walink {
 
 // Inline low-level meta/payload helpers
-inline uint32_t wl_get_meta(WL_VALUE v) noexcept {
+constexpr uint32_t wl_get_meta(WL_VALUE v) noexcept {
     return static_cast<uint32_t>(v >> 32);
 }
 
-inline uint32_t wl_get_payload32(WL_VALUE v) noexcept {
+constexpr uint32_t wl_get_payload32(WL_VALUE v) noexcept {
     return static_cast<uint32_t>(v & 0xffffffffu);
 }
 
-inline WL_VALUE wl_make(uint32_t meta, uint32_t payload) noexcept {
+constexpr WL_VALUE wl_make(uint32_t meta, uint32_t payload) noexcept {
     return (static_cast<WL_VALUE>(meta) << 32) | static_cast<WL_VALUE>(payload);
 }
 
-inline uint32_t wl_get_tag(WL_VALUE v) noexcept {
+constexpr uint32_t wl_get_tag(WL_VALUE v) noexcept {
     const auto meta = wl_get_meta(v);
     return (meta & WL_META_TAG_MASK);
 }
 
-inline bool wl_is_address(WL_VALUE v) noexcept {
+constexpr bool wl_is_address(WL_VALUE v) noexcept {
     return (wl_get_meta(v) & WL_META_IS_ADDRESS) != 0;
 }
 
-inline uint32_t wl_build_meta(uint32_t tag,
+constexpr bool wl_has_free_flag(WL_VALUE v) noexcept {
+    return (wl_get_meta(v) & WL_META_FREE_FLAG) != 0;
+}
+
+constexpr bool wl_has_arena_flag(WL_VALUE v) noexcept {
+    return (wl_get_meta(v) & WL_META_ARENA_FLAG) != 0;
+}
+
+constexpr uint32_t wl_build_meta(uint32_t tag,
                               bool is_address,
                               bool free_flag = false,
-                              bool user_defined = false) noexcept {
+                              bool user_defined = false,
+                              bool arena_flag = false) noexcept {
     uint32_t meta = (tag & WL_META_TAG_MASK);
     if (user_defined) {
         meta |= WL_META_USER_DEFINED;
@@ -120,6 +196,9 @@ inline uint32_t wl_build_meta(uint32_t tag,
     if (free_flag) {
         meta |= WL_META_FREE_FLAG;
     }
+    if (arena_flag) {
+        meta |= WL_META_ARENA_FLAG;
+    }
     return meta;
 }
 
@@ -134,56 +213,471 @@ inline WL_VALUE wl_from_address(void* ptr,
     return wl_make(meta, payload);
 }
 
+// ---- Size-class pool allocator -------------------------------------------
+//
+// Segregated free lists for blocks up to 256 bytes, malloc fallback above.
+// Backs walink_alloc / walink_free when built with WALINK_POOL_ALLOCATOR=1
+// (CMake option WALINK_POOL_ALLOCATOR) and always under WALINK_THREADS=1,
+// where each thread allocates from its own heap and blocks freed by another
+// thread are queued back to their owner. Blocks must be released with
+// wl_pool_free, never free().
+
+extern void* wl_pool_alloc(uint32_t size) noexcept;
+
+extern void wl_pool_free(void* ptr) noexcept;
+
+// ---- Per-call arena -------------------------------------------------------
+//
+// Opt-in bump allocator. While arena mode is enabled, every factory below that
+// would hand ownership to the receiver (free flag) allocates from the arena
+// instead and marks the value with WL_META_ARENA_FLAG. All arena allocations
+// are released at once by wl_arena_reset() (exported as walink_arena_reset),
+// so the host does not need a walink_free call per value.
+
+// Returns 8-byte aligned memory valid until the next wl_arena_reset().
+extern void* wl_arena_alloc(uint32_t size) noexcept;
+
+// Releases every arena allocation. Chunks are kept for reuse.
+extern void wl_arena_reset() noexcept;
+
+extern bool wl_arena_enabled() noexcept;
+
+// Enables/disables arena mode for the factories; returns the previous state.
+extern bool wl_arena_set_enabled(bool enabled) noexcept;
+
+// Builds the meta word for a value handed to the receiver. When
+// free_flag_for_receiver is set and arena mode is enabled, the arena flag is
+// used instead of the free flag.
+extern uint32_t wl_owned_meta(uint32_t tag, bool free_flag_for_receiver) noexcept;
+
+// ---- Scalar codecs -------------------------------------------------------
+//
+// codec<T> is the single definition of how a C++ scalar maps to a WL_VALUE:
+//   tag       : WL tag of the type
+//   check(v)  : true if v carries this type
+//   encode(x) : C++ value -> WL_VALUE
+//   decode(v) : WL_VALUE -> C++ value (no tag check; see check)
+// Direct-value codecs are constexpr and reduce to shifts and masks.
+
+// Next wasm->host scratch slot (round robin).
+extern uint64_t* wl_scratch_slot() noexcept;
+
+template <typename T> struct codec;
+
+template <uint32_t Tag>
+struct direct_codec {
+    static constexpr uint32_t tag = Tag;
+
+    static constexpr bool check(WL_VALUE v) noexcept {
+        return !wl_is_address(v) && wl_get_tag(v) == Tag;
+    }
+
+protected:
+    static constexpr WL_VALUE make(uint32_t payload) noexcept {
+        return wl_make(wl_build_meta(Tag, /*is_address*/ false), payload);
+    }
+};
+
+template <> struct codec<bool> : direct_codec<WL_TAG_BOOLEAN> {
+    static constexpr WL_VALUE encode(bool b) noexcept { return make(b ? 1u : 0u); }
+    static constexpr bool decode(WL_VALUE v) noexcept { return wl_get_payload32(v) != 0; }
+};
+
+template <> struct codec<int8_t> : direct_codec<WL_TAG_SINT8> {
+    static constexpr WL_VALUE encode(int8_t x) noexcept { return make(static_cast<uint32_t>(static_cast<int32_t>(x))); }
+    static constexpr int8_t decode(WL_VALUE v) noexcept { return static_cast<int8_t>(wl_get_payload32(v)); }
+};
+
+template <> struct codec<uint8_t> : direct_codec<WL_TAG_UINT8> {
+    static constexpr WL_VALUE encode(uint8_t x) noexcept { return make(x); }
+    static constexpr uint8_t decode(WL_VALUE v) noexcept { return static_cast<uint8_t>(wl_get_payload32(v)); }
+};
+
+template <> struct codec<int16_t> : direct_codec<WL_TAG_SINT16> {
+    static constexpr WL_VALUE encode(int16_t x) noexcept { return make(static_cast<uint32_t>(static_cast<int32_t>(x))); }
+    static constexpr int16_t decode(WL_VALUE v) noexcept { return static_cast<int16_t>(wl_get_payload32(v)); }
+};
+
+template <> struct codec<uint16_t> : direct_codec<WL_TAG_UINT16> {
+    static constexpr WL_VALUE encode(uint16_t x) noexcept { return make(x); }
+    static constexpr uint16_t decode(WL_VALUE v) noexcept { return static_cast<uint16_t>(wl_get_payload32(v)); }
+};
+
+template <> struct codec<int32_t> : direct_codec<WL_TAG_SINT32> {
+    static constexpr WL_VALUE encode(int32_t x) noexcept { return make(static_cast<uint32_t>(x)); }
+    static constexpr int32_t decode(WL_VALUE v) noexcept { return static_cast<int32_t>(wl_get_payload32(v)); }
+};
+
+template <> struct codec<uint32_t> : direct_codec<WL_TAG_UINT32> {
+    static constexpr WL_VALUE encode(uint32_t x) noexcept { return make(x); }
+    static constexpr uint32_t decode(WL_VALUE v) noexcept { return wl_get_payload32(v); }
+};
+
+template <> struct codec<float> : direct_codec<WL_TAG_FLOAT32> {
+    static constexpr WL_VALUE encode(float x) noexcept { return make(std::bit_cast<uint32_t>(x)); }
+    static constexpr float decode(WL_VALUE v) noexcept { return std::bit_cast<float>(wl_get_payload32(v)); }
+};
+
+// 64-bit scalars live behind an address (scratch slot or legacy
+// Float64Container). encode never allocates; decode only reads, releasing a
+// free-flagged value is up to the caller (see wl_to_f64 & co).
+template <uint32_t Tag, typename T>
+struct slot64_codec {
+    static constexpr uint32_t tag = Tag;
+
+    static bool check(WL_VALUE v) noexcept {
+        return wl_is_address(v) && wl_get_tag(v) == Tag && wl_get_payload32(v) != 0;
+    }
+
+    static WL_VALUE encode(T x) noexcept {
+        uint64_t* slot = wl_scratch_slot();
+        *slot = std::bit_cast<uint64_t>(x);
+        return wl_from_address(slot, Tag, /*free_flag_for_receiver*/ false);
+    }
+
+    static T decode(WL_VALUE v) noexcept {
+        uint64_t bits;
+        memcpy(&bits, reinterpret_cast<const void*>(static_cast<uintptr_t>(wl_get_payload32(v))), sizeof(bits));
+        return std::bit_cast<T>(bits);
+    }
+};
+
+template <> struct codec<double> : slot64_codec<WL_TAG_FLOAT64, double> {};
+template <> struct codec<int64_t> : slot64_codec<WL_TAG_SINT64, int64_t> {};
+template <> struct codec<uint64_t> : slot64_codec<WL_TAG_UINT64, uint64_t> {};
+
+template <typename T>
+concept wl_has_codec = requires { codec<T>::tag; };
+
 // ---- Convenience factories for direct-value scalars (to/from) -----------
 
-extern WL_VALUE wl_from_bool(bool b) noexcept;
+constexpr WL_VALUE wl_from_bool(bool b) noexcept { return codec<bool>::encode(b); }
 
-extern bool wl_to_bool(WL_VALUE v) noexcept;
+constexpr bool wl_to_bool(WL_VALUE v) noexcept { return codec<bool>::decode(v); }
 
-extern WL_VALUE wl_from_sint8(int32_t v) noexcept;
+constexpr WL_VALUE wl_from_sint8(int32_t v) noexcept { return codec<int8_t>::encode(static_cast<int8_t>(v)); }
 
-extern int32_t wl_to_sint8(WL_VALUE v) noexcept;
+constexpr int32_t wl_to_sint8(WL_VALUE v) noexcept { return codec<int8_t>::decode(v); }
 
-extern WL_VALUE wl_from_uint8(uint32_t v) noexcept;
+constexpr WL_VALUE wl_from_uint8(uint32_t v) noexcept { return codec<uint8_t>::encode(static_cast<uint8_t>(v)); }
 
-extern uint32_t wl_to_uint8(WL_VALUE v) noexcept;
+constexpr uint32_t wl_to_uint8(WL_VALUE v) noexcept { return codec<uint8_t>::decode(v); }
 
-extern WL_VALUE wl_from_sint16(int32_t v) noexcept;
+constexpr WL_VALUE wl_from_sint16(int32_t v) noexcept { return codec<int16_t>::encode(static_cast<int16_t>(v)); }
 
-extern int32_t wl_to_sint16(WL_VALUE v) noexcept;
+constexpr int32_t wl_to_sint16(WL_VALUE v) noexcept { return codec<int16_t>::decode(v); }
 
-extern WL_VALUE wl_from_uint16(uint32_t v) noexcept;
+constexpr WL_VALUE wl_from_uint16(uint32_t v) noexcept { return codec<uint16_t>::encode(static_cast<uint16_t>(v)); }
 
-extern uint32_t wl_to_uint16(WL_VALUE v) noexcept;
+constexpr uint32_t wl_to_uint16(WL_VALUE v) noexcept { return codec<uint16_t>::decode(v); }
 
-extern WL_VALUE wl_from_uint32(uint32_t v) noexcept;
+constexpr WL_VALUE wl_from_uint32(uint32_t v) noexcept { return codec<uint32_t>::encode(v); }
 
-extern uint32_t wl_to_uint32(WL_VALUE v) noexcept;
+constexpr uint32_t wl_to_uint32(WL_VALUE v) noexcept { return codec<uint32_t>::decode(v); }
 
-extern WL_VALUE wl_from_float32(float f) noexcept;
+constexpr WL_VALUE wl_from_float32(float f) noexcept { return codec<float>::encode(f); }
 
-extern float wl_to_float32(WL_VALUE v) noexcept;
+constexpr float wl_to_float32(WL_VALUE v) noexcept { return codec<float>::decode(v); }
 
-extern WL_VALUE wl_from_sint32(int32_t v) noexcept;
+constexpr WL_VALUE wl_from_sint32(int32_t v) noexcept { return codec<int32_t>::encode(v); }
 
-extern int32_t wl_to_sint32(WL_VALUE v) noexcept;
+constexpr int32_t wl_to_sint32(WL_VALUE v) noexcept { return codec<int32_t>::decode(v); }
 
 // ---- Address-based factories (containers / float64) ---------------------
 
+// Allocates from the arena when `meta` carries WL_META_ARENA_FLAG, from the
+// heap otherwise.
 extern BaseContainer* wl_alloc_container(uint32_t meta, uint32_t size) noexcept;
+
+// Releases a container allocated with wl_alloc_container using the same meta
+// (no-op for arena containers).
+extern void wl_free_container(BaseContainer* c, uint32_t meta) noexcept;
+
+// Moves `c` (may be null) into a new container with cap >= min_cap, growing
+// geometrically, and releases the old one. Returns nullptr on failure, in
+// which case `c` is left untouched.
+extern BaseContainer* wl_grow_container(BaseContainer* c, uint32_t meta, uint32_t min_cap) noexcept;
+
+// ---- Container recycling ---------------------------------------------------
+//
+// Instead of walink_free, a receiver that owns a container can hand it back
+// with wl_recycle / walink_recycle. The block goes into a small per-thread
+// cache, and the next heap wl_alloc_container or walink_alloc of a similar
+// size reuses it, so a steady-state request loop does not hit the allocator.
+// Only BaseContainer tags (bytes, string, msgpack, arrays, error) are cached;
+// anything else is released as by walink_free. Arena values are ignored.
+
+constexpr uint32_t WL_RECYCLE_SLOTS = 8;
+// Larger containers are freed rather than kept.
+constexpr uint32_t WL_RECYCLE_MAX_BYTES = 1u << 20;
+
+constexpr bool wl_is_container_tag(uint32_t tag) noexcept {
+    return tag == WL_TAG_BYTES || tag == WL_TAG_STRING || tag == WL_TAG_STRING16 || tag == WL_TAG_MSGPACK ||
+           tag == WL_TAG_FLAT || tag == WL_TAG_IOVEC || tag == WL_TAG_ERROR || (tag & ~0xffu) == WL_TAG_ARRAY_BASE;
+}
+
+// The caller must own `v` (free flag, or a host-kept container).
+extern void wl_recycle(WL_VALUE v) noexcept;
+
+// Appends into a growable container in place and hands it over with
+// finish(). Capacity grows geometrically (wl_grow_container); the initial
+// block may come from the recycle cache, so cap > size is normal.
+class ContainerWriter {
+public:
+    explicit ContainerWriter(uint32_t tag, uint32_t initial_cap = 256, bool free_flag_for_receiver = true) noexcept
+        : meta_(wl_owned_meta(tag, free_flag_for_receiver)) {
+        c_ = wl_alloc_container(meta_, initial_cap);
+        ok_ = c_ != nullptr;
+    }
+
+    ContainerWriter(const ContainerWriter&) = delete;
+    ContainerWriter& operator=(const ContainerWriter&) = delete;
+
+    ~ContainerWriter() {
+        wl_free_container(c_, meta_);
+    }
+
+    // false once an allocation has failed; every later append is a no-op.
+    bool ok() const noexcept { return ok_; }
+
+    uint32_t size() const noexcept { return c_ ? c_->size : 0; }
+    uint32_t capacity() const noexcept { return c_ ? c_->cap : 0; }
+
+    // Written bytes so far (invalidated by the next append).
+    std::span<uint8_t> data() noexcept {
+        return c_ ? std::span<uint8_t>(c_->data, c_->size) : std::span<uint8_t>();
+    }
+
+    // Appends `n` uninitialized bytes and returns them, or nullptr on failure.
+    uint8_t* reserve(uint32_t n) noexcept {
+        if (!ok_) {
+            return nullptr;
+        }
+        if (c_->cap - c_->size < n) {
+            if (n > UINT32_MAX - c_->size) {
+                ok_ = false;
+                return nullptr;
+            }
+            BaseContainer* grown = wl_grow_container(c_, meta_, c_->size + n);
+            if (!grown) {
+                ok_ = false;
+                return nullptr;
+            }
+            c_ = grown;
+        }
+        uint8_t* p = c_->data + c_->size;
+        c_->size += n;
+        return p;
+    }
+
+    ContainerWriter& append(const void* data, uint32_t n) noexcept {
+        if (n == 0) {
+            return *this;
+        }
+        if (uint8_t* p = reserve(n)) {
+            memcpy(p, data, n);
+        }
+        return *this;
+    }
+
+    ContainerWriter& append(std::string_view sv) noexcept {
+        return append(sv.data(), static_cast<uint32_t>(sv.size()));
+    }
+
+    ContainerWriter& push_back(uint8_t b) noexcept {
+        if (uint8_t* p = reserve(1)) {
+            *p = b;
+        }
+        return *this;
+    }
+
+    // Drops the contents, keeps the capacity.
+    void clear() noexcept {
+        if (c_) {
+            c_->size = 0;
+        }
+    }
+
+    // Hands the container over as a value of the writer's tag. Returns 0 if
+    // any append failed. The writer is empty afterwards.
+    WL_VALUE finish() noexcept {
+        if (!ok_) {
+            return 0;
+        }
+        BaseContainer* c = c_;
+        c_ = nullptr;
+        ok_ = false;
+        return wl_make(meta_, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(c)));
+    }
+
+private:
+    BaseContainer* c_ = nullptr;
+    uint32_t meta_;
+    bool ok_ = false;
+};
  
 extern WL_VALUE wl_make_string(std::string_view sv, bool free_flag_for_receiver) noexcept;
+
+// Scatter-gather: one container sized for the sum of `segments`, each segment
+// copied exactly once (no intermediate concatenation).
+extern WL_VALUE wl_make_string(std::span<const std::string_view> segments, bool free_flag_for_receiver) noexcept;
+
+inline WL_VALUE wl_make_string(std::initializer_list<std::string_view> segments, bool free_flag_for_receiver) noexcept {
+    return wl_make_string(std::span<const std::string_view>(segments.begin(), segments.size()), free_flag_for_receiver);
+}
  
 extern WL_VALUE wl_make_error(std::string_view msg) noexcept;
  
 extern WL_VALUE wl_make_f64(double v, bool free_flag_for_receiver) noexcept;
+
+// ---- Allocation-free 64-bit scalars (scratch slots) ---------------------
+
+inline WL_VALUE wl_from_f64(double v) noexcept { return codec<double>::encode(v); }
+
+inline WL_VALUE wl_from_sint64(int64_t v) noexcept { return codec<int64_t>::encode(v); }
+
+inline WL_VALUE wl_from_uint64(uint64_t v) noexcept { return codec<uint64_t>::encode(v); }
+
+// True if `p` points into this thread's scratch slot tables (either direction).
+extern bool wl_is_scratch_slot(const void* p) noexcept;
+
+// Copies a scratch-slot FLOAT64/SINT64/UINT64 value into an owned 8-byte
+// block (free flag, or arena flag in arena mode) so it outlives the slot ring.
+// Any other value is returned unchanged; 0 if the allocation fails.
+extern WL_VALUE wl_detach_scalar64(WL_VALUE v) noexcept;
  
 extern WL_VALUE wl_make_bytes(std::string_view sv, bool free_flag_for_receiver) noexcept;
+
+// Scatter-gather BYTES (see the wl_make_string overload).
+extern WL_VALUE wl_make_bytes(std::span<const std::string_view> segments, bool free_flag_for_receiver) noexcept;
+extern WL_VALUE wl_make_bytes(std::span<const std::span<const uint8_t>> segments, bool free_flag_for_receiver) noexcept;
+
+inline WL_VALUE wl_make_bytes(std::initializer_list<std::string_view> segments, bool free_flag_for_receiver) noexcept {
+    return wl_make_bytes(std::span<const std::string_view>(segments.begin(), segments.size()), free_flag_for_receiver);
+}
+
+// IOVEC: no copy at all. The container only lists the segments, which must
+// stay valid and unchanged until the host releases the value (static data,
+// interned strings, buffers owned by a handle). Releasing an IOVEC frees the
+// list, never the segments. The host reads it as a list of views.
+extern WL_VALUE wl_make_iovec(std::span<const std::span<const uint8_t>> segments, bool free_flag_for_receiver) noexcept;
+extern WL_VALUE wl_make_iovec(std::span<const std::string_view> segments, bool free_flag_for_receiver) noexcept;
+
+inline WL_VALUE wl_make_iovec(std::initializer_list<std::string_view> segments, bool free_flag_for_receiver) noexcept {
+    return wl_make_iovec(std::span<const std::string_view>(segments.begin(), segments.size()), free_flag_for_receiver);
+}
  
 extern WL_VALUE wl_make_msgpack(std::string_view sv, bool free_flag_for_receiver) noexcept;
 
+// ---- Typed numeric arrays -------------------------------------------------
+
+template <typename T> struct wl_array_traits;
+template <> struct wl_array_traits<int8_t>   { static constexpr uint32_t tag = WL_TAG_ARRAY_SINT8; };
+template <> struct wl_array_traits<uint8_t>  { static constexpr uint32_t tag = WL_TAG_ARRAY_UINT8; };
+template <> struct wl_array_traits<int16_t>  { static constexpr uint32_t tag = WL_TAG_ARRAY_SINT16; };
+template <> struct wl_array_traits<uint16_t> { static constexpr uint32_t tag = WL_TAG_ARRAY_UINT16; };
+template <> struct wl_array_traits<int32_t>  { static constexpr uint32_t tag = WL_TAG_ARRAY_SINT32; };
+template <> struct wl_array_traits<uint32_t> { static constexpr uint32_t tag = WL_TAG_ARRAY_UINT32; };
+template <> struct wl_array_traits<float>    { static constexpr uint32_t tag = WL_TAG_ARRAY_FLOAT32; };
+template <> struct wl_array_traits<double>   { static constexpr uint32_t tag = WL_TAG_ARRAY_FLOAT64; };
+template <> struct wl_array_traits<int64_t>  { static constexpr uint32_t tag = WL_TAG_ARRAY_SINT64; };
+template <> struct wl_array_traits<uint64_t> { static constexpr uint32_t tag = WL_TAG_ARRAY_UINT64; };
+
+// Allocates an array container for `count` elements of `elem_size` bytes
+// (size already set) and returns its data pointer through `data`.
+// Returns 0 on allocation failure or size overflow.
+extern WL_VALUE wl_alloc_array(uint32_t tag,
+                               uint32_t elem_size,
+                               uint32_t count,
+                               bool free_flag_for_receiver,
+                               void** data) noexcept;
+
+// Copies `items` into a new array container (a single memcpy).
+template <typename T>
+WL_VALUE wl_make_array(std::span<const T> items, bool free_flag_for_receiver) noexcept {
+    if (items.size() > UINT32_MAX / sizeof(T)) {
+        return 0;
+    }
+    void* data = nullptr;
+    const WL_VALUE v = wl_alloc_array(wl_array_traits<T>::tag,
+                                      sizeof(T),
+                                      static_cast<uint32_t>(items.size()),
+                                      free_flag_for_receiver,
+                                      &data);
+    if (v && !items.empty()) {
+        memcpy(data, items.data(), items.size_bytes());
+    }
+    return v;
+}
+
+// Allocates an uninitialized array container to be filled in place.
+template <typename T>
+struct ArrayAlloc {
+    WL_VALUE value;
+    std::span<T> items;
+};
+
+template <typename T>
+ArrayAlloc<T> wl_new_array(uint32_t count, bool free_flag_for_receiver) noexcept {
+    void* data = nullptr;
+    const WL_VALUE v = wl_alloc_array(wl_array_traits<T>::tag, sizeof(T), count, free_flag_for_receiver, &data);
+    if (!v) {
+        return {0, {}};
+    }
+    return {v, std::span<T>(static_cast<T*>(data), count)};
+}
+
 // Null value (tag = 0)
 extern WL_VALUE wl_null() noexcept;
+
+// ---- Error codes / Result --------------------------------------------------
+//
+// Minimal expected-style result for the non-throwing (wl_try_*) API. Errors
+// carry a static message, so a failed check costs a branch and converting it
+// into an ERROR value (wl_make_error(Error)) needs no formatting.
+
+enum class Errc : uint32_t {
+    ok = 0,
+    type_mismatch,
+    null_address,
+    out_of_memory,
+    stale_handle,
+};
+
+struct Error {
+    Errc code;
+    const char* message; // static storage, never freed
+};
+
+// Holds either a T (default-constructible) or an Error.
+template <typename T>
+class Result {
+public:
+    Result(T value) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : value_(std::move(value)), error_{Errc::ok, nullptr} {}
+    Result(Error error) noexcept : value_(), error_(error) {}
+
+    bool has_value() const noexcept { return error_.code == Errc::ok; }
+    explicit operator bool() const noexcept { return has_value(); }
+
+    T& value() & noexcept { return value_; }
+    const T& value() const& noexcept { return value_; }
+    T&& value() && noexcept { return std::move(value_); }
+
+    T& operator*() & noexcept { return value_; }
+    const T& operator*() const& noexcept { return value_; }
+    T&& operator*() && noexcept { return std::move(value_); }
+    T* operator->() noexcept { return &value_; }
+    const T* operator->() const noexcept { return &value_; }
+
+    const Error& error() const noexcept { return error_; }
+
+private:
+    T value_;
+    Error error_;
+};
+
+extern WL_VALUE wl_make_error(const Error& err) noexcept;
  
 // Converters: extract data from WL_VALUE. If allow_free is true and the value
 // has the meta free-flag set, the underlying allocation will be freed via
@@ -193,9 +687,150 @@ extern std::string wl_to_bytes(WL_VALUE v, bool allow_free);
 extern std::string wl_to_msgpack(WL_VALUE v, bool allow_free);
 extern std::string wl_read_base_container(WL_VALUE v, bool allow_free);
 extern double wl_to_f64(WL_VALUE v, bool allow_free);
+extern int64_t wl_to_sint64(WL_VALUE v, bool allow_free);
+extern uint64_t wl_to_uint64(WL_VALUE v, bool allow_free);
+
+// ---- Borrowed views (zero-copy) -------------------------------------------
+//
+// Views point straight into the container in wasm memory. They stay valid only
+// as long as the container does; nothing is freed here.
+extern std::string_view wl_view_string(WL_VALUE v);
+extern std::span<const uint8_t> wl_view_bytes(WL_VALUE v);
+extern std::span<const uint8_t> wl_view_msgpack(WL_VALUE v);
+extern std::span<const uint8_t> wl_view_base_container(WL_VALUE v);
+
+// Typed view over an array container; throws if the tag does not match T.
+extern std::span<const uint8_t> wl_view_array_bytes(WL_VALUE v, uint32_t tag);
+
+template <typename T>
+std::span<const T> wl_view_array(WL_VALUE v) {
+    const auto bytes = wl_view_array_bytes(v, wl_array_traits<T>::tag);
+    return {reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T)};
+}
+
+// Move-only owner of a borrowed container. When constructed with ownership
+// (allow_free and the value's free flag set), the container is released via
+// walink_free on destruction, so callers can parse in place without copying.
+class ContainerRef {
+public:
+    ContainerRef() noexcept = default;
+    ContainerRef(WL_VALUE value, std::span<const uint8_t> data, bool owns) noexcept
+        : value_(value), data_(data), owns_(owns) {}
+
+    ContainerRef(const ContainerRef&) = delete;
+    ContainerRef& operator=(const ContainerRef&) = delete;
+
+    ContainerRef(ContainerRef&& other) noexcept
+        : value_(other.value_), data_(other.data_), owns_(other.owns_) {
+        other.owns_ = false;
+    }
+
+    ContainerRef& operator=(ContainerRef&& other) noexcept {
+        if (this != &other) {
+            reset();
+            value_ = other.value_;
+            data_ = other.data_;
+            owns_ = other.owns_;
+            other.owns_ = false;
+        }
+        return *this;
+    }
+
+    ~ContainerRef() { reset(); }
+
+    WL_VALUE value() const noexcept { return value_; }
+    bool owns() const noexcept { return owns_; }
+
+    std::span<const uint8_t> bytes() const noexcept { return data_; }
+
+    std::string_view str() const noexcept {
+        return {reinterpret_cast<const char*>(data_.data()), data_.size()};
+    }
+
+    // Gives up ownership without freeing; returns the underlying value.
+    WL_VALUE release() noexcept {
+        owns_ = false;
+        return value_;
+    }
+
+    // Frees the container now if owned, and empties the view.
+    void reset() noexcept;
+
+private:
+    WL_VALUE value_ = 0;
+    std::span<const uint8_t> data_;
+    bool owns_ = false;
+};
+
+// Same tag checks as the wl_to_* converters, but borrow instead of copy.
+extern ContainerRef wl_borrow_string(WL_VALUE v, bool allow_free);
+extern ContainerRef wl_borrow_bytes(WL_VALUE v, bool allow_free);
+extern ContainerRef wl_borrow_msgpack(WL_VALUE v, bool allow_free);
+extern ContainerRef wl_borrow_base_container(WL_VALUE v, bool allow_free);
+
+// ---- Non-throwing converters ------------------------------------------------
+//
+// Same checks, ownership rules and messages as the converters and views above
+// (which are thin wrappers over these), but failures come back as Error
+// instead of std::runtime_error. Use these from -fno-exceptions builds.
+
+extern Result<std::string> wl_try_to_string(WL_VALUE v, bool allow_free);
+extern Result<std::string> wl_try_to_bytes(WL_VALUE v, bool allow_free);
+extern Result<std::string> wl_try_to_msgpack(WL_VALUE v, bool allow_free);
+extern Result<double> wl_try_to_f64(WL_VALUE v, bool allow_free) noexcept;
+extern Result<int64_t> wl_try_to_sint64(WL_VALUE v, bool allow_free) noexcept;
+extern Result<uint64_t> wl_try_to_uint64(WL_VALUE v, bool allow_free) noexcept;
+
+extern Result<std::string_view> wl_try_view_string(WL_VALUE v) noexcept;
+extern Result<std::span<const uint8_t>> wl_try_view_bytes(WL_VALUE v) noexcept;
+extern Result<std::span<const uint8_t>> wl_try_view_msgpack(WL_VALUE v) noexcept;
+extern Result<std::span<const uint8_t>> wl_try_view_base_container(WL_VALUE v) noexcept;
+extern Result<std::span<const uint8_t>> wl_try_view_array_bytes(WL_VALUE v, uint32_t tag) noexcept;
+
+template <typename T>
+Result<std::span<const T>> wl_try_view_array(WL_VALUE v) noexcept {
+    auto bytes = wl_try_view_array_bytes(v, wl_array_traits<T>::tag);
+    if (!bytes) {
+        return bytes.error();
+    }
+    return std::span<const T>(reinterpret_cast<const T*>(bytes->data()), bytes->size() / sizeof(T));
+}
+
+// Also accepts STRING16: the text is transcoded into a new UTF-8 container
+// owned by the returned ref (and an owned STRING16 is released right away).
+extern Result<ContainerRef> wl_try_borrow_string(WL_VALUE v, bool allow_free) noexcept;
+extern Result<ContainerRef> wl_try_borrow_bytes(WL_VALUE v, bool allow_free) noexcept;
+extern Result<ContainerRef> wl_try_borrow_msgpack(WL_VALUE v, bool allow_free) noexcept;
+extern Result<ContainerRef> wl_try_borrow_base_container(WL_VALUE v, bool allow_free) noexcept;
+
+// ---- Batched calls ------------------------------------------------------
+//
+// walink_call_batch runs many registered functions in one boundary crossing.
+// Functions are looked up by a small integer id (< WL_BATCH_MAX_FUNCTIONS)
+// and receive their arguments as a WL_VALUE array.
+
+constexpr uint32_t WL_BATCH_MAX_FUNCTIONS = 256;
+
+using wl_batch_fn = WL_VALUE (*)(const WL_VALUE* args, uint32_t argc);
+
+// Registers `fn` under `fn_id`. Returns false if the id is out of range or
+// already taken.
+extern bool wl_batch_register(uint32_t fn_id, wl_batch_fn fn) noexcept;
+
+extern wl_batch_fn wl_batch_lookup(uint32_t fn_id) noexcept;
 
 } // namespace walink
 
+#define WL_CONCAT_IMPL_(a, b) a##b
+#define WL_CONCAT_(a, b) WL_CONCAT_IMPL_(a, b)
+
+// Registers a batchable function at static-initialization time. Standalone
+// reactor modules run static initializers from the exported `_initialize`,
+// which the Node Walink class calls once per instance.
+#define WL_BATCH_REGISTER(fn_id, fn) \
+    static const bool WL_CONCAT_(wl_batch_registered_, __LINE__) = \
+        ::walink::wl_batch_register((fn_id), (fn))
+
 extern "C" {
 
 // Helper API to be consumed from the host side
@@ -210,6 +845,60 @@ WL_VALUE walink_alloc(uint32_t size) noexcept;
 
 // Deallocate a container previously allocated in wasm memory.
 // The input must be a value whose payload is the container address.
+// Arena-owned values (WL_META_ARENA_FLAG) and scratch-slot scalars are
+// ignored (boolean false), so walink_recycle / walink_free_many may be handed
+// any received value.
 WL_VALUE walink_free(WL_VALUE value);
 
+// Like walink_free, but keeps BaseContainer blocks in the recycle cache for
+// the next allocation of a similar size (see wl_recycle).
+WL_VALUE walink_recycle(WL_VALUE value) noexcept;
+
+// Release every value listed in `values`, an ARRAY_UINT64 container of
+// WL_VALUEs (walink_recycle when `recycle` is non-zero, walink_free
+// otherwise), so draining many results costs one crossing. The list itself is
+// not freed; its size is reset to 0. Returns the count as uint32.
+WL_VALUE walink_free_many(WL_VALUE values, uint32_t recycle) noexcept;
+
+// Address of the host->wasm scratch slot table (WL_SCRATCH_SLOT_COUNT
+// 8-byte slots). The host writes float64/sint64/uint64 arguments there
+// instead of calling walink_alloc; the table never moves.
+WL_VALUE walink_scratch_slots() noexcept;
+
+// Linear-memory generation as uint32: the memory size in 64KiB pages, which
+// changes exactly when memory grows (and with it the host's memory.buffer).
+// Host views built at one generation stay valid until it changes. Always 0
+// natively, where nothing moves.
+WL_VALUE walink_memory_generation() noexcept;
+
+// Grow linear memory up front so that about `bytes` more of heap allocations
+// fit without another memory.grow, keeping growth off the per-call path.
+// Returns the generation after growing (see walink_memory_generation), or 0
+// (NULL) when memory cannot grow that far. A no-op natively.
+WL_VALUE walink_reserve(uint32_t bytes) noexcept;
+
+// Allocate `size` bytes from the per-call arena. Same return convention as
+// walink_alloc; the block is released by walink_arena_reset.
+WL_VALUE walink_arena_alloc(uint32_t size) noexcept;
+
+// Release every arena allocation made since the previous reset.
+WL_VALUE walink_arena_reset() noexcept;
+
+// Enable (non-zero) or disable (zero) arena mode. Returns the previous state
+// as a boolean WL_VALUE.
+WL_VALUE walink_arena_enable(uint32_t enabled) noexcept;
+
+// Execute a batch of registered calls in one crossing.
+//
+// `calls` is a BaseContainer holding back-to-back records
+//     uint32_t fn_id; uint32_t argc; WL_VALUE args[argc];
+// `results` is a BaseContainer with cap >= 8 * record count; one WL_VALUE
+// result per record is written to it and its size is updated. Neither
+// container is freed. 64-bit scalar results are detached from the scratch
+// slots (wl_detach_scalar64), so a batch may return any number of them; the
+// host owns and releases them like any free-flagged result. Unknown function
+// ids yield an ERROR result for that record. Returns the record count as
+// uint32, or an ERROR for a malformed batch.
+WL_VALUE walink_call_batch(WL_VALUE calls, WL_VALUE results);
+
 } // extern "C"
\ No newline at end of file
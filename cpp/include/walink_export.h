@@ -0,0 +1,366 @@
+#pragma once
+
+#include "walink.h"
+#include "walink_trace.h"
+
+#include <stdint.h>
+
+#include <array>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Compile-time auto-marshalling for wasm exports.
+//
+//     static int32_t add(int32_t a, int32_t b) { return a + b; }
+//     WL_EXPORT(wl_add, add);
+//
+// WL_EXPORT generates a wasm export `wl_add(WL_VALUE, WL_VALUE) -> WL_VALUE`
+// whose arity follows the C++ signature. Each parameter is tag-checked and
+// decoded by its arg_codec<T> specialization and the result is encoded by
+// ret_codec<R>, all resolved at compile time (no runtime type switch). A tag
+// mismatch returns an ERROR value instead of throwing; free-flagged arguments
+// are released either way.
+//
+// Every export is also recorded in a signature manifest (name, parameter tags,
+// result tag) returned by walink_manifest(), from which the host can build
+// specialized call stubs. With WALINK_TRACE, calls are traced under their
+// manifest index (see walink_trace.h).
+
+namespace walink {
+
+// Pass-through parameter/result: the raw WL_VALUE, unchecked (manifest tag 0).
+struct RawValue {
+    WL_VALUE value;
+};
+
+// ---- Parameter codecs -------------------------------------------------------
+//
+// check(v)  : tag test, no side effects
+// decode(v) : returns a holder that keeps borrowed data alive for the call;
+//             holder.get() yields the parameter value. Only called after
+//             check(v), through the non-throwing wl_try_* API.
+
+template <typename T> struct arg_codec;
+
+template <typename T>
+struct value_holder {
+    T v;
+    T get() const noexcept { return v; }
+};
+
+// Scalars: tag check and decode straight from codec<T>. A free-flagged
+// 64-bit scalar (legacy Float64Container) is released after reading.
+template <wl_has_codec T>
+struct arg_codec<T> {
+    static constexpr uint32_t tag = codec<T>::tag;
+    static bool check(WL_VALUE v) noexcept { return codec<T>::check(v); }
+    static value_holder<T> decode(WL_VALUE v) noexcept {
+        const T x = codec<T>::decode(v);
+        if (wl_has_free_flag(v)) {
+            ::walink_free(v);
+        }
+        return {x};
+    }
+};
+
+template <uint32_t Tag>
+inline bool wl_check_address_tag(WL_VALUE v) noexcept {
+    return wl_is_address(v) && wl_get_tag(v) == Tag && wl_get_payload32(v) != 0;
+}
+
+template <> struct arg_codec<RawValue> {
+    static constexpr uint32_t tag = WL_TAG_NULL;
+    static bool check(WL_VALUE) noexcept { return true; }
+    static value_holder<RawValue> decode(WL_VALUE v) noexcept { return {RawValue{v}}; }
+};
+
+// STRING or STRING16 (transcoded to UTF-8, see wl_try_borrow_string).
+inline bool wl_check_string_tag(WL_VALUE v) noexcept {
+    return wl_check_address_tag<WL_TAG_STRING>(v) || wl_check_address_tag<WL_TAG_STRING16>(v);
+}
+
+// Owned copy; the container is released right away.
+template <> struct arg_codec<std::string> {
+    static constexpr uint32_t tag = WL_TAG_STRING;
+    static bool check(WL_VALUE v) noexcept { return wl_check_string_tag(v); }
+    static value_holder<std::string> decode(WL_VALUE v) { return {*wl_try_to_string(v, true)}; }
+};
+
+// Borrowed view; the container is released when the call returns.
+template <> struct arg_codec<std::string_view> {
+    static constexpr bool borrowed = true;
+    struct holder {
+        ContainerRef ref;
+        std::string_view get() const noexcept { return ref.str(); }
+    };
+    static constexpr uint32_t tag = WL_TAG_STRING;
+    static bool check(WL_VALUE v) noexcept { return wl_check_string_tag(v); }
+    static holder decode(WL_VALUE v) noexcept { return {*wl_try_borrow_string(v, true)}; }
+};
+
+template <> struct arg_codec<std::span<const uint8_t>> {
+    static constexpr bool borrowed = true;
+    struct holder {
+        ContainerRef ref;
+        std::span<const uint8_t> get() const noexcept { return ref.bytes(); }
+    };
+    static constexpr uint32_t tag = WL_TAG_BYTES;
+    static bool check(WL_VALUE v) noexcept { return wl_check_address_tag<tag>(v); }
+    static holder decode(WL_VALUE v) noexcept { return {*wl_try_borrow_bytes(v, true)}; }
+};
+
+// Typed numeric arrays (std::span<const double> etc.), borrowed.
+template <typename E>
+struct typed_array_arg_codec {
+    static constexpr bool borrowed = true;
+    struct holder {
+        ContainerRef ref;
+        std::span<const E> get() const noexcept {
+            const auto bytes = ref.bytes();
+            return {reinterpret_cast<const E*>(bytes.data()), bytes.size() / sizeof(E)};
+        }
+    };
+    static constexpr uint32_t tag = wl_array_traits<E>::tag;
+    static bool check(WL_VALUE v) noexcept { return wl_check_address_tag<tag>(v); }
+    static holder decode(WL_VALUE v) noexcept { return {*wl_try_borrow_base_container(v, true)}; }
+};
+
+template <> struct arg_codec<std::span<const int8_t>>   : typed_array_arg_codec<int8_t> {};
+template <> struct arg_codec<std::span<const int16_t>>  : typed_array_arg_codec<int16_t> {};
+template <> struct arg_codec<std::span<const uint16_t>> : typed_array_arg_codec<uint16_t> {};
+template <> struct arg_codec<std::span<const int32_t>>  : typed_array_arg_codec<int32_t> {};
+template <> struct arg_codec<std::span<const uint32_t>> : typed_array_arg_codec<uint32_t> {};
+template <> struct arg_codec<std::span<const float>>    : typed_array_arg_codec<float> {};
+template <> struct arg_codec<std::span<const double>>   : typed_array_arg_codec<double> {};
+template <> struct arg_codec<std::span<const int64_t>>  : typed_array_arg_codec<int64_t> {};
+template <> struct arg_codec<std::span<const uint64_t>> : typed_array_arg_codec<uint64_t> {};
+
+// Parameter types whose value points into the argument container (released
+// when the call returns).
+template <typename T>
+concept wl_borrowed_arg = requires { requires arg_codec<T>::borrowed; };
+
+// ---- Result codecs ------------------------------------------------------------
+
+template <typename T> struct ret_codec;
+
+template <> struct ret_codec<void> {
+    static constexpr uint32_t tag = WL_TAG_NULL;
+};
+
+template <wl_has_codec T>
+struct ret_codec<T> {
+    static constexpr uint32_t tag = codec<T>::tag;
+    static WL_VALUE encode(T x) noexcept { return codec<T>::encode(x); }
+};
+
+template <> struct ret_codec<RawValue> {
+    static constexpr uint32_t tag = WL_TAG_NULL;
+    static WL_VALUE encode(RawValue v) noexcept { return v.value; }
+};
+
+template <> struct ret_codec<std::string_view> {
+    static constexpr uint32_t tag = WL_TAG_STRING;
+    static WL_VALUE encode(std::string_view v) noexcept { return wl_make_string(v, true); }
+};
+
+template <> struct ret_codec<std::string> : ret_codec<std::string_view> {};
+
+template <> struct ret_codec<const char*> : ret_codec<std::string_view> {};
+
+// Results whose encode() keeps running the function body after the call
+// returns (ret_codec<Task>, walink_task.h).
+template <typename T>
+concept wl_deferred_result = requires { requires ret_codec<T>::deferred; };
+
+template <typename E>
+struct ret_codec<std::vector<E>> {
+    static constexpr uint32_t tag = wl_array_traits<E>::tag;
+    static WL_VALUE encode(const std::vector<E>& v) noexcept {
+        return wl_make_array<E>(std::span<const E>(v), true);
+    }
+};
+
+// ---- Signature manifest --------------------------------------------------------
+
+struct ExportInfo {
+    const char* name;
+    uint32_t result_tag;
+    uint32_t argc;
+    const uint32_t* param_tags;
+    // Packed-argument entry point (same shape as batch functions).
+    wl_batch_fn invoke;
+    ExportInfo* next;
+    // manifest index, set by wl_export_register
+    uint32_t id;
+};
+
+// Appends `info` to the manifest; returns its export id (registration order).
+extern uint32_t wl_export_register(ExportInfo* info) noexcept;
+
+extern const ExportInfo* wl_export_first() noexcept;
+
+extern const ExportInfo* wl_export_find(std::string_view name) noexcept;
+
+namespace detail {
+
+template <typename F> struct fn_traits;
+
+template <typename R, typename... A>
+struct fn_traits<R (*)(A...)> {
+    using result = R;
+    using args = std::tuple<std::remove_cvref_t<A>...>;
+    static constexpr size_t arity = sizeof...(A);
+    // every parameter is taken by value as an owning type
+    static constexpr bool owns_args = ((!std::is_reference_v<A> && !wl_borrowed_arg<std::remove_cv_t<A>>) && ...);
+};
+
+template <typename R, typename... A>
+struct fn_traits<R (*)(A...) noexcept> : fn_traits<R (*)(A...)> {};
+
+template <auto Fn>
+using fn_traits_of = fn_traits<decltype(Fn)>;
+
+template <auto Fn, size_t I>
+using arg_t = std::tuple_element_t<I, typename fn_traits_of<Fn>::args>;
+
+template <size_t>
+using wl_value_at = WL_VALUE;
+
+// Error path before any argument was decoded: the free-flagged arguments were
+// already handed over by the host, so release them here.
+inline void release_owned_args(const WL_VALUE* raw, size_t argc) noexcept {
+    for (size_t i = 0; i < argc; ++i) {
+        if (wl_has_free_flag(raw[i])) {
+            ::walink_free(raw[i]);
+        }
+    }
+}
+
+template <auto Fn, size_t... I>
+WL_VALUE invoke_checked(const ExportInfo& info, const WL_VALUE* raw, std::index_sequence<I...>) {
+    using R = typename fn_traits_of<Fn>::result;
+
+    if (!(arg_codec<arg_t<Fn, I>>::check(raw[I]) && ...)) {
+        release_owned_args(raw, sizeof...(I));
+        std::string msg(info.name);
+        msg += ": argument type mismatch";
+        return wl_make_error(msg);
+    }
+
+    std::tuple<decltype(arg_codec<arg_t<Fn, I>>::decode(raw[I]))...> holders{
+        arg_codec<arg_t<Fn, I>>::decode(raw[I])...};
+    (void)holders;
+    WL_TRACE(info.id, WL_TRACE_ARGS, 0, 0);
+
+    if constexpr (std::is_void_v<R>) {
+        Fn(std::get<I>(holders).get()...);
+        WL_TRACE(info.id, WL_TRACE_RETURN, 0, 0);
+        return wl_null();
+    } else {
+        decltype(auto) result = Fn(std::get<I>(holders).get()...);
+        WL_TRACE(info.id, WL_TRACE_RETURN, 0, 0);
+        return ret_codec<std::remove_cvref_t<R>>::encode(std::forward<decltype(result)>(result));
+    }
+}
+
+template <auto Fn, size_t... I>
+WL_VALUE invoke(const ExportInfo& info, const WL_VALUE* raw, std::index_sequence<I...> seq) {
+#if WALINK_TRACE
+    WL_TRACE(info.id, WL_TRACE_BEGIN, (0u + ... + wl_trace_bytes(raw[I])), 0);
+    const WL_VALUE result = invoke_checked<Fn>(info, raw, seq);
+    WL_TRACE(info.id, WL_TRACE_END, 0, wl_trace_bytes(result));
+    return result;
+#else
+    return invoke_checked<Fn>(info, raw, seq);
+#endif
+}
+
+template <auto Fn>
+struct export_signature {
+    using traits = fn_traits_of<Fn>;
+
+    // The argument holders die when the wrapper returns, before the first poll.
+    static_assert(!wl_deferred_result<std::remove_cvref_t<typename traits::result>> || traits::owns_args,
+                  "WL_EXPORT: a Task-returning function must take its arguments by value as owning types "
+                  "(std::string, scalars), not views (std::string_view, std::span) or references");
+
+    template <size_t... I>
+    static constexpr std::array<uint32_t, traits::arity> tags(std::index_sequence<I...>) {
+        return {arg_codec<arg_t<Fn, I>>::tag...};
+    }
+
+    static constexpr std::array<uint32_t, traits::arity> param_tags =
+        tags(std::make_index_sequence<traits::arity>{});
+
+    static constexpr uint32_t result_tag =
+        ret_codec<std::remove_cvref_t<typename traits::result>>::tag;
+};
+
+template <auto Fn>
+WL_VALUE invoke_packed(const ExportInfo& info, const WL_VALUE* args, uint32_t argc) {
+    constexpr size_t arity = fn_traits_of<Fn>::arity;
+    if (argc != arity) {
+        release_owned_args(args, argc);
+        std::string msg(info.name);
+        msg += ": wrong argument count";
+        return wl_make_error(msg);
+    }
+    return invoke<Fn>(info, args, std::make_index_sequence<arity>{});
+}
+
+} // namespace detail
+
+} // namespace walink
+
+#if defined(__wasm__)
+#define WL_EXPORT_ATTR_(name) __attribute__((used, export_name(name)))
+#else
+#define WL_EXPORT_ATTR_(name) __attribute__((used))
+#endif
+
+// Defines the wasm export `name` for the C++ function `fn` and records it in
+// the manifest. Use at namespace scope, once per export name.
+#define WL_EXPORT(name, fn)                                                                     \
+    static WL_VALUE WL_CONCAT_(wl_export_packed_, name)(const WL_VALUE* args, uint32_t argc);   \
+    static ::walink::ExportInfo WL_CONCAT_(wl_export_info_, name){                              \
+        #name,                                                                                  \
+        ::walink::detail::export_signature<&fn>::result_tag,                                    \
+        static_cast<uint32_t>(::walink::detail::export_signature<&fn>::param_tags.size()),      \
+        ::walink::detail::export_signature<&fn>::param_tags.data(),                             \
+        &WL_CONCAT_(wl_export_packed_, name),                                                   \
+        nullptr,                                                                                \
+        0};                                                                                     \
+    template <typename Seq>                                                                     \
+    struct WL_CONCAT_(wl_export_thunk_, name);                                                  \
+    template <size_t... I>                                                                      \
+    struct WL_CONCAT_(wl_export_thunk_, name)<::std::index_sequence<I...>> {                    \
+        WL_EXPORT_ATTR_(#name)                                                                  \
+        static WL_VALUE call(::walink::detail::wl_value_at<I>... args) {                        \
+            const WL_VALUE raw[sizeof...(I) + 1] = {args..., 0};                                \
+            return ::walink::detail::invoke<&fn>(                                               \
+                WL_CONCAT_(wl_export_info_, name), raw, ::std::index_sequence<I...>{});         \
+        }                                                                                       \
+    };                                                                                          \
+    template struct WL_CONCAT_(wl_export_thunk_, name)<                                         \
+        ::std::make_index_sequence<::walink::detail::fn_traits_of<&fn>::arity>>;                \
+    static WL_VALUE WL_CONCAT_(wl_export_packed_, name)(const WL_VALUE* args, uint32_t argc) {  \
+        return ::walink::detail::invoke_packed<&fn>(                                            \
+            WL_CONCAT_(wl_export_info_, name), args, argc);                                     \
+    }                                                                                           \
+    static const uint32_t WL_CONCAT_(wl_export_id_, name) =                                     \
+        ::walink::wl_export_register(&WL_CONCAT_(wl_export_info_, name))
+
+extern "C" {
+
+// Signature manifest of every WL_EXPORT in the module, as MSGPACK:
+//     [{ "name": str, "params": [tag, ...], "result": tag }, ...]
+// Tag 0 means "any WL_VALUE" (RawValue) for params, null for results.
+WL_VALUE walink_manifest() noexcept;
+
+} // extern "C"
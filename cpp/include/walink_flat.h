@@ -0,0 +1,360 @@
+#pragma once
+
+#include "walink.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <initializer_list>
+#include <span>
+#include <string_view>
+
+// Header-only support for WL_TAG_FLAT values: a schema-less, offset-indexed
+// object layout that the reader never parses as a whole.
+//
+// MSGPACK must be decoded front to back, so reading two fields of a large
+// record costs a full unpack. A FLAT container instead addresses every node
+// by offset, so a reader (Node's WlFlatView, or View below) only touches the
+// nodes on the path to the fields it asks for.
+//
+// Layout (little-endian, offsets relative to the container's data):
+//
+//   [0]  Slot root
+//   Slot        : u32 type, u32 payload (8 bytes)
+//     null/bool/int32/uint32/float32 : payload is the value itself
+//     float64/int64/uint64            : offset of the 8-byte value (8-aligned)
+//     string/bytes                    : offset of { u32 length; u8 data[length] }
+//     array                           : offset of { u32 count; Slot items[count] }
+//     map                             : offset of { u32 count; Entry entries[count] }
+//   Entry       : u32 key offset (a string node), Slot value (12 bytes)
+//
+// Map entries are sorted by key bytes, so lookups are binary searches. Nodes
+// are 4-aligned; children are written before their parents (Builder works
+// bottom-up), so a finished container is never patched again.
+
+namespace walink::flat {
+
+enum class Type : uint32_t {
+    null = 0,
+    boolean,
+    int32,
+    uint32,
+    float32,
+    float64,
+    int64,
+    uint64,
+    string,
+    bytes,
+    array,
+    map,
+};
+
+constexpr uint32_t kSlotSize = 8;
+constexpr uint32_t kEntrySize = 12;
+
+// A written value, to be placed into an array, a map or the root.
+struct Ref {
+    Type type = Type::null;
+    uint32_t payload = 0;
+};
+
+struct Field {
+    std::string_view key;
+    Ref value;
+};
+
+// ---- Builder ----------------------------------------------------------------
+
+class Builder {
+public:
+    explicit Builder(uint32_t initial_cap = 256, bool free_flag_for_receiver = true) noexcept
+        : out_(WL_TAG_FLAT, initial_cap, free_flag_for_receiver) {
+        out_.append(zeros_, kSlotSize); // root slot, set by finish()
+    }
+
+    Builder(const Builder&) = delete;
+    Builder& operator=(const Builder&) = delete;
+
+    // false once an allocation has failed; finish() then returns an ERROR.
+    bool ok() const noexcept { return out_.ok(); }
+
+    uint32_t size() const noexcept { return out_.size(); }
+
+    static constexpr Ref null() noexcept { return {Type::null, 0}; }
+    static constexpr Ref boolean(bool v) noexcept { return {Type::boolean, v ? 1u : 0u}; }
+    static constexpr Ref int32(int32_t v) noexcept { return {Type::int32, static_cast<uint32_t>(v)}; }
+    static constexpr Ref uint32(uint32_t v) noexcept { return {Type::uint32, v}; }
+
+    static Ref float32(float v) noexcept {
+        uint32_t bits;
+        memcpy(&bits, &v, sizeof(bits));
+        return {Type::float32, bits};
+    }
+
+    Ref float64(double v) noexcept { return wide(Type::float64, &v); }
+    Ref int64(int64_t v) noexcept { return wide(Type::int64, &v); }
+    Ref uint64(uint64_t v) noexcept { return wide(Type::uint64, &v); }
+
+    Ref string(std::string_view v) noexcept { return blob(Type::string, v.data(), v.size()); }
+    Ref bytes(std::span<const uint8_t> v) noexcept { return blob(Type::bytes, v.data(), v.size()); }
+
+    Ref array(std::span<const Ref> items) noexcept {
+        const uint32_t at = node(4 + static_cast<uint32_t>(items.size()) * kSlotSize);
+        if (!ok()) {
+            return {};
+        }
+        put_u32(at, static_cast<uint32_t>(items.size()));
+        for (size_t i = 0; i < items.size(); ++i) {
+            put_slot(at + 4 + static_cast<uint32_t>(i) * kSlotSize, items[i]);
+        }
+        return {Type::array, at};
+    }
+
+    Ref array(std::initializer_list<Ref> items) noexcept {
+        return array(std::span<const Ref>(items.begin(), items.size()));
+    }
+
+    // Keys must be unique within one map.
+    Ref map(std::span<const Field> fields) noexcept {
+        const uint32_t count = static_cast<uint32_t>(fields.size());
+        const uint32_t at = node(4 + count * kEntrySize);
+        if (!ok()) {
+            return {};
+        }
+        put_u32(at, count);
+        // Keys go after the entry block; entries then get sorted in place.
+        for (uint32_t i = 0; i < count; ++i) {
+            const Ref key = string(fields[i].key);
+            if (!ok()) {
+                return {};
+            }
+            const uint32_t e = at + 4 + i * kEntrySize;
+            put_u32(e, key.payload);
+            put_slot(e + 4, fields[i].value);
+        }
+        sort_entries(at + 4, count);
+        return {Type::map, at};
+    }
+
+    Ref map(std::initializer_list<Field> fields) noexcept {
+        return map(std::span<const Field>(fields.begin(), fields.size()));
+    }
+
+    // Hands the container over with `root` as the document.
+    WL_VALUE finish(Ref root) noexcept {
+        if (!ok()) {
+            return wl_make_error("walink::flat::Builder: out of memory");
+        }
+        put_slot(0, root);
+        return out_.finish();
+    }
+
+private:
+    struct Entry {
+        uint32_t key;
+        uint32_t type;
+        uint32_t payload;
+    };
+
+    static constexpr uint8_t zeros_[8] = {};
+
+    // Pads to `align` and reserves `n` bytes; returns their offset.
+    uint32_t node(uint32_t n, uint32_t align = 4) noexcept {
+        const uint32_t pad = (align - out_.size() % align) % align;
+        out_.append(zeros_, pad);
+        const uint32_t at = out_.size();
+        out_.reserve(n);
+        return at;
+    }
+
+    Ref wide(Type type, const void* v) noexcept {
+        const uint32_t at = node(8, 8);
+        if (!ok()) {
+            return {};
+        }
+        memcpy(out_.data().data() + at, v, 8);
+        return {type, at};
+    }
+
+    Ref blob(Type type, const void* data, size_t n) noexcept {
+        const uint32_t at = node(4 + static_cast<uint32_t>(n));
+        if (!ok()) {
+            return {};
+        }
+        put_u32(at, static_cast<uint32_t>(n));
+        if (n) {
+            memcpy(out_.data().data() + at + 4, data, n);
+        }
+        return {type, at};
+    }
+
+    void put_u32(uint32_t at, uint32_t v) noexcept {
+        memcpy(out_.data().data() + at, &v, 4);
+    }
+
+    void put_slot(uint32_t at, Ref r) noexcept {
+        put_u32(at, static_cast<uint32_t>(r.type));
+        put_u32(at + 4, r.payload);
+    }
+
+    std::string_view key_at(uint32_t offset) noexcept {
+        const uint8_t* base = out_.data().data();
+        uint32_t len;
+        memcpy(&len, base + offset, 4);
+        return std::string_view(reinterpret_cast<const char*>(base + offset + 4), len);
+    }
+
+    void sort_entries(uint32_t at, uint32_t count) noexcept {
+        auto* entries = reinterpret_cast<Entry*>(out_.data().data() + at);
+        std::sort(entries, entries + count, [this](const Entry& a, const Entry& b) {
+            return key_at(a.key) < key_at(b.key);
+        });
+    }
+
+    ContainerWriter out_;
+};
+
+// ---- View (wasm-side reader) ------------------------------------------------
+
+// Borrowed view of one node of a FLAT buffer. Accessors return a default
+// (0, empty, null View) on type mismatch or a malformed offset.
+class View {
+public:
+    View() noexcept = default;
+
+    // Root of a FLAT buffer (e.g. wl_view_base_container(v)->bytes()).
+    static View root(std::span<const uint8_t> buf) noexcept {
+        View v{buf, {}};
+        if (buf.size() < kSlotSize) {
+            return {};
+        }
+        v.slot_ = {static_cast<Type>(v.u32(0)), v.u32(4)};
+        return v;
+    }
+
+    Type type() const noexcept { return slot_.type; }
+    bool is_null() const noexcept { return slot_.type == Type::null; }
+
+    bool as_bool() const noexcept { return slot_.type == Type::boolean && slot_.payload != 0; }
+    int32_t as_int32() const noexcept { return slot_.type == Type::int32 ? static_cast<int32_t>(slot_.payload) : 0; }
+    uint32_t as_uint32() const noexcept { return slot_.type == Type::uint32 ? slot_.payload : 0; }
+
+    float as_float32() const noexcept {
+        float v = 0;
+        if (slot_.type == Type::float32) {
+            memcpy(&v, &slot_.payload, sizeof(v));
+        }
+        return v;
+    }
+
+    double as_float64() const noexcept { return wide<double>(Type::float64); }
+    int64_t as_int64() const noexcept { return wide<int64_t>(Type::int64); }
+    uint64_t as_uint64() const noexcept { return wide<uint64_t>(Type::uint64); }
+
+    std::string_view as_string() const noexcept {
+        const auto b = blob(Type::string);
+        return std::string_view(reinterpret_cast<const char*>(b.data()), b.size());
+    }
+
+    std::span<const uint8_t> as_bytes() const noexcept { return blob(Type::bytes); }
+
+    // Element / entry count of an array or map; 0 otherwise.
+    uint32_t size() const noexcept {
+        return (slot_.type == Type::array || slot_.type == Type::map) && in_range(slot_.payload, 4)
+                   ? u32(slot_.payload)
+                   : 0;
+    }
+
+    View operator[](uint32_t i) const noexcept {
+        if (slot_.type != Type::array || i >= size()) {
+            return {};
+        }
+        return slot_at(slot_.payload + 4 + i * kSlotSize);
+    }
+
+    // Map lookup (binary search over the sorted keys).
+    View operator[](std::string_view key) const noexcept {
+        if (slot_.type != Type::map) {
+            return {};
+        }
+        uint32_t lo = 0, hi = size();
+        while (lo < hi) {
+            const uint32_t mid = lo + (hi - lo) / 2;
+            const uint32_t e = slot_.payload + 4 + mid * kEntrySize;
+            const std::string_view k = key_at(e);
+            if (k == key) {
+                return slot_at(e + 4);
+            }
+            if (k < key) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return {};
+    }
+
+    // i-th map entry in key order.
+    std::string_view key(uint32_t i) const noexcept {
+        return slot_.type == Type::map && i < size() ? key_at(slot_.payload + 4 + i * kEntrySize) : std::string_view();
+    }
+
+    View value(uint32_t i) const noexcept {
+        return slot_.type == Type::map && i < size() ? slot_at(slot_.payload + 4 + i * kEntrySize + 4) : View();
+    }
+
+private:
+    View(std::span<const uint8_t> buf, Ref slot) noexcept : buf_(buf), slot_(slot) {}
+
+    bool in_range(uint32_t at, uint32_t n) const noexcept {
+        return at <= buf_.size() && n <= buf_.size() - at;
+    }
+
+    uint32_t u32(uint32_t at) const noexcept {
+        uint32_t v;
+        memcpy(&v, buf_.data() + at, 4);
+        return v;
+    }
+
+    View slot_at(uint32_t at) const noexcept {
+        if (!in_range(at, kSlotSize)) {
+            return {};
+        }
+        return View{buf_, {static_cast<Type>(u32(at)), u32(at + 4)}};
+    }
+
+    template <typename T>
+    T wide(Type type) const noexcept {
+        T v{};
+        if (slot_.type == type && in_range(slot_.payload, 8)) {
+            memcpy(&v, buf_.data() + slot_.payload, 8);
+        }
+        return v;
+    }
+
+    std::span<const uint8_t> blob_at(uint32_t at) const noexcept {
+        if (!in_range(at, 4)) {
+            return {};
+        }
+        const uint32_t n = u32(at);
+        return in_range(at + 4, n) ? buf_.subspan(at + 4, n) : std::span<const uint8_t>();
+    }
+
+    std::span<const uint8_t> blob(Type type) const noexcept {
+        return slot_.type == type ? blob_at(slot_.payload) : std::span<const uint8_t>();
+    }
+
+    std::string_view key_at(uint32_t entry) const noexcept {
+        if (!in_range(entry, 4)) {
+            return {};
+        }
+        const auto b = blob_at(u32(entry));
+        return std::string_view(reinterpret_cast<const char*>(b.data()), b.size());
+    }
+
+    std::span<const uint8_t> buf_;
+    Ref slot_;
+};
+
+} // namespace walink::flat
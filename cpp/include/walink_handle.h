@@ -0,0 +1,105 @@
+#pragma once
+
+#include "walink.h"
+
+#include <stdint.h>
+
+#include <new>
+#include <utility>
+
+// Generational handles to wasm-resident objects (WL_TAG_HANDLE).
+//
+// A handle lets the host keep a reference to a large C++ object (a parsed
+// document, an index, ...) inside wasm and pass it back on later calls,
+// instead of serializing it out and in every time.
+//
+// Handles are direct values: the payload packs a slot index (low 20 bits,
+// index + 1 so that 0 is never a valid handle) and the slot's generation
+// (high 12 bits). Releasing the last reference bumps the generation, so a
+// stale handle fails lookup with a single compare. A generation repeats only
+// after 4096 reuses of the same slot.
+//
+// Ownership: a handle returned to the host carries one reference, which the
+// host gives back with walink_handle_release. Handles passed into wasm as
+// arguments are borrowed; wasm code that keeps one must wl_handle_retain it.
+//
+// Every object is registered with its WlHandleType, which also makes lookups
+// typed: wl_handle_get<T> returns nullptr for a handle of another type.
+
+constexpr uint32_t WL_HANDLE_INDEX_BITS = 20;
+constexpr uint32_t WL_HANDLE_INDEX_MASK = (1u << WL_HANDLE_INDEX_BITS) - 1;
+constexpr uint32_t WL_HANDLE_MAX_OBJECTS = WL_HANDLE_INDEX_MASK;
+
+namespace walink {
+
+struct WlHandleType {
+    const char* name;
+    void (*destroy)(void* obj) noexcept;
+};
+
+// One WlHandleType per C++ type (deletes with `delete`).
+template <typename T>
+const WlHandleType* wl_handle_type_of() noexcept {
+    static const WlHandleType type{
+        "object",
+        [](void* obj) noexcept { delete static_cast<T*>(obj); },
+    };
+    return &type;
+}
+
+// Registers `obj` with one reference. Returns 0 when the table is full or out
+// of memory, in which case `obj` has been destroyed.
+extern WL_VALUE wl_handle_create(void* obj, const WlHandleType* type) noexcept;
+
+// Object behind a live handle of `type`; nullptr if the handle is stale,
+// malformed or of another type.
+extern void* wl_handle_lookup(WL_VALUE h, const WlHandleType* type) noexcept;
+
+// Reference counting. Both return false for a stale handle. The object is
+// destroyed when the count reaches zero.
+extern bool wl_handle_retain(WL_VALUE h) noexcept;
+extern bool wl_handle_release(WL_VALUE h) noexcept;
+
+// Number of live handles (all types).
+extern uint32_t wl_handle_count() noexcept;
+
+template <typename T>
+WL_VALUE wl_make_handle(T* obj) noexcept {
+    return wl_handle_create(obj, wl_handle_type_of<T>());
+}
+
+template <typename T, typename... Args>
+WL_VALUE wl_new_handle(Args&&... args) noexcept {
+    T* obj = new (std::nothrow) T(std::forward<Args>(args)...);
+    return obj ? wl_make_handle(obj) : 0;
+}
+
+template <typename T>
+T* wl_handle_get(WL_VALUE h) noexcept {
+    return static_cast<T*>(wl_handle_lookup(h, wl_handle_type_of<T>()));
+}
+
+template <typename T>
+Result<T*> wl_try_handle(WL_VALUE h) noexcept {
+    if (wl_is_address(h) || wl_get_tag(h) != WL_TAG_HANDLE) {
+        return Error{Errc::type_mismatch, "wl_handle_get: expected HANDLE tag"};
+    }
+    T* obj = wl_handle_get<T>(h);
+    if (!obj) {
+        return Error{Errc::stale_handle, "wl_handle_get: stale handle or wrong object type"};
+    }
+    return obj;
+}
+
+} // namespace walink
+
+extern "C" {
+
+// Add / drop one reference. Return a boolean: false for a stale handle.
+WL_VALUE walink_handle_retain(WL_VALUE handle) noexcept;
+WL_VALUE walink_handle_release(WL_VALUE handle) noexcept;
+
+// Boolean: true while the handle is live.
+WL_VALUE walink_handle_valid(WL_VALUE handle) noexcept;
+
+} // extern "C"
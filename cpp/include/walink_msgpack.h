@@ -0,0 +1,429 @@
+#pragma once
+
+#include "walink.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <span>
+#include <string_view>
+
+// Header-only MessagePack support for WL_TAG_MSGPACK values.
+//
+// - Writer serializes straight into a growing BaseContainer (ContainerWriter);
+//   finish() hands the container over as a MSGPACK WL_VALUE without an
+//   intermediate buffer.
+// - parse() is a SAX-style reader: it walks a borrowed buffer (e.g. a
+//   container in wasm memory) and reports events to a visitor; strings and
+//   binaries are passed as views into the input, nothing is copied.
+//
+// Neither side throws, so both are usable from -fno-exceptions builds.
+
+namespace walink::msgpack {
+
+// ---- Writer ---------------------------------------------------------------
+
+class Writer {
+public:
+    explicit Writer(uint32_t initial_cap = 256, bool free_flag_for_receiver = true) noexcept
+        : out_(WL_TAG_MSGPACK, initial_cap, free_flag_for_receiver) {}
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // false once an allocation has failed; every later write is a no-op.
+    bool ok() const noexcept { return out_.ok(); }
+
+    uint32_t size() const noexcept { return out_.size(); }
+
+    Writer& write_nil() noexcept {
+        return put_u8(0xc0);
+    }
+
+    Writer& write_bool(bool v) noexcept {
+        return put_u8(v ? 0xc3 : 0xc2);
+    }
+
+    Writer& write_uint(uint64_t v) noexcept {
+        if (v < 0x80) {
+            return put_u8(static_cast<uint8_t>(v));
+        }
+        if (v <= 0xff) {
+            return put_tagged(0xcc, v, 1);
+        }
+        if (v <= 0xffff) {
+            return put_tagged(0xcd, v, 2);
+        }
+        if (v <= 0xffffffffu) {
+            return put_tagged(0xce, v, 4);
+        }
+        return put_tagged(0xcf, v, 8);
+    }
+
+    Writer& write_int(int64_t v) noexcept {
+        if (v >= 0) {
+            return write_uint(static_cast<uint64_t>(v));
+        }
+        if (v >= -32) {
+            return put_u8(static_cast<uint8_t>(v));
+        }
+        if (v >= INT8_MIN) {
+            return put_tagged(0xd0, static_cast<uint64_t>(v), 1);
+        }
+        if (v >= INT16_MIN) {
+            return put_tagged(0xd1, static_cast<uint64_t>(v), 2);
+        }
+        if (v >= INT32_MIN) {
+            return put_tagged(0xd2, static_cast<uint64_t>(v), 4);
+        }
+        return put_tagged(0xd3, static_cast<uint64_t>(v), 8);
+    }
+
+    Writer& write_float(float v) noexcept {
+        uint32_t bits;
+        memcpy(&bits, &v, sizeof(bits));
+        return put_tagged(0xca, bits, 4);
+    }
+
+    Writer& write_double(double v) noexcept {
+        uint64_t bits;
+        memcpy(&bits, &v, sizeof(bits));
+        return put_tagged(0xcb, bits, 8);
+    }
+
+    Writer& write_str(std::string_view sv) noexcept {
+        const auto n = static_cast<uint32_t>(sv.size());
+        if (n < 32) {
+            put_u8(static_cast<uint8_t>(0xa0 | n));
+        } else if (n <= 0xff) {
+            put_tagged(0xd9, n, 1);
+        } else if (n <= 0xffff) {
+            put_tagged(0xda, n, 2);
+        } else {
+            put_tagged(0xdb, n, 4);
+        }
+        return put_raw(sv.data(), n);
+    }
+
+    Writer& write_bin(std::span<const uint8_t> data) noexcept {
+        const auto n = static_cast<uint32_t>(data.size());
+        if (n <= 0xff) {
+            put_tagged(0xc4, n, 1);
+        } else if (n <= 0xffff) {
+            put_tagged(0xc5, n, 2);
+        } else {
+            put_tagged(0xc6, n, 4);
+        }
+        return put_raw(data.data(), n);
+    }
+
+    // Followed by `n` values.
+    Writer& write_array_header(uint32_t n) noexcept {
+        if (n < 16) {
+            return put_u8(static_cast<uint8_t>(0x90 | n));
+        }
+        if (n <= 0xffff) {
+            return put_tagged(0xdc, n, 2);
+        }
+        return put_tagged(0xdd, n, 4);
+    }
+
+    // Followed by `n` key/value pairs.
+    Writer& write_map_header(uint32_t n) noexcept {
+        if (n < 16) {
+            return put_u8(static_cast<uint8_t>(0x80 | n));
+        }
+        if (n <= 0xffff) {
+            return put_tagged(0xde, n, 2);
+        }
+        return put_tagged(0xdf, n, 4);
+    }
+
+    Writer& write_ext(int8_t type, std::span<const uint8_t> data) noexcept {
+        const auto n = static_cast<uint32_t>(data.size());
+        switch (n) {
+            case 1: put_u8(0xd4); break;
+            case 2: put_u8(0xd5); break;
+            case 4: put_u8(0xd6); break;
+            case 8: put_u8(0xd7); break;
+            case 16: put_u8(0xd8); break;
+            default:
+                if (n <= 0xff) {
+                    put_tagged(0xc7, n, 1);
+                } else if (n <= 0xffff) {
+                    put_tagged(0xc8, n, 2);
+                } else {
+                    put_tagged(0xc9, n, 4);
+                }
+                break;
+        }
+        put_u8(static_cast<uint8_t>(type));
+        return put_raw(data.data(), n);
+    }
+
+    // Hands the container over as a MSGPACK value. Returns 0 if any write
+    // failed. The writer is empty afterwards.
+    WL_VALUE finish() noexcept {
+        return out_.finish();
+    }
+
+private:
+    uint8_t* reserve(uint32_t n) noexcept {
+        return out_.reserve(n);
+    }
+
+    Writer& put_u8(uint8_t b) noexcept {
+        if (uint8_t* p = reserve(1)) {
+            *p = b;
+        }
+        return *this;
+    }
+
+    // marker byte followed by `width` big-endian bytes of `v`
+    Writer& put_tagged(uint8_t marker, uint64_t v, uint32_t width) noexcept {
+        if (uint8_t* p = reserve(1 + width)) {
+            *p++ = marker;
+            for (uint32_t i = 0; i < width; ++i) {
+                p[i] = static_cast<uint8_t>(v >> (8 * (width - 1 - i)));
+            }
+        }
+        return *this;
+    }
+
+    Writer& put_raw(const void* data, uint32_t n) noexcept {
+        out_.append(data, n);
+        return *this;
+    }
+
+    ContainerWriter out_;
+};
+
+// ---- SAX reader ---------------------------------------------------------------
+
+enum class Status : uint32_t {
+    ok = 0,
+    truncated,      // input ended in the middle of a value
+    invalid,        // reserved marker (0xc1) or non-MSGPACK WL_VALUE
+    depth_exceeded, // nesting deeper than kMaxDepth
+    stopped,        // a visitor callback returned false
+};
+
+constexpr uint32_t kMaxDepth = 64;
+
+// Default no-op callbacks; derive and hide the ones you need. Returning false
+// from any callback stops parsing with Status::stopped.
+struct Visitor {
+    bool on_nil() noexcept { return true; }
+    bool on_bool(bool) noexcept { return true; }
+    bool on_int(int64_t) noexcept { return true; }
+    bool on_uint(uint64_t) noexcept { return true; }
+    bool on_double(double) noexcept { return true; }
+    bool on_str(std::string_view) noexcept { return true; }
+    bool on_bin(std::span<const uint8_t>) noexcept { return true; }
+    bool on_ext(int8_t, std::span<const uint8_t>) noexcept { return true; }
+    bool on_array_begin(uint32_t) noexcept { return true; }
+    bool on_array_end() noexcept { return true; }
+    bool on_map_begin(uint32_t) noexcept { return true; }
+    bool on_map_end() noexcept { return true; }
+};
+
+namespace detail {
+
+inline uint64_t load_be(const uint8_t* p, uint32_t width) noexcept {
+    uint64_t v = 0;
+    for (uint32_t i = 0; i < width; ++i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+inline int64_t sign_extend(uint64_t v, uint32_t width) noexcept {
+    const uint32_t shift = 64 - 8 * width;
+    return static_cast<int64_t>(v << shift) >> shift;
+}
+
+} // namespace detail
+
+// Parses exactly one top-level value from `data`. On success `*consumed` (if
+// given) receives the number of bytes used.
+template <typename V>
+Status parse(std::span<const uint8_t> data, V& visitor, size_t* consumed = nullptr) noexcept {
+    struct Frame {
+        uint32_t remaining; // items left (maps count keys and values)
+        bool is_map;
+    };
+    Frame stack[kMaxDepth];
+    uint32_t depth = 0;
+
+    const uint8_t* p = data.data();
+    const uint8_t* const end = p + data.size();
+
+    auto need = [&](size_t n) noexcept { return static_cast<size_t>(end - p) >= n; };
+
+    for (;;) {
+        if (!need(1)) {
+            return Status::truncated;
+        }
+        const uint8_t m = *p++;
+        bool ok = true;
+        uint32_t len = 0;
+        bool opened = false;
+
+        // Reads a big-endian length of `width` bytes into len.
+        auto read_len = [&](uint32_t width) noexcept {
+            if (!need(width)) {
+                return false;
+            }
+            len = static_cast<uint32_t>(detail::load_be(p, width));
+            p += width;
+            return true;
+        };
+
+        if (m <= 0x7f) {
+            ok = visitor.on_uint(m);
+        } else if (m >= 0xe0) {
+            ok = visitor.on_int(static_cast<int8_t>(m));
+        } else if ((m & 0xf0) == 0x80 || (m & 0xf0) == 0x90 || m == 0xdc || m == 0xdd || m == 0xde || m == 0xdf) {
+            const bool is_map = (m & 0xf0) == 0x80 || m == 0xde || m == 0xdf;
+            if ((m & 0xe0) == 0x80) {
+                len = m & 0x0f;
+            } else if (!read_len((m == 0xdc || m == 0xde) ? 2 : 4)) {
+                return Status::truncated;
+            }
+            if (is_map && len > UINT32_MAX / 2) {
+                return Status::invalid;
+            }
+            ok = is_map ? visitor.on_map_begin(len) : visitor.on_array_begin(len);
+            if (ok) {
+                if (depth == kMaxDepth) {
+                    return Status::depth_exceeded;
+                }
+                stack[depth++] = Frame{is_map ? len * 2 : len, is_map};
+                opened = true;
+            }
+        } else if ((m & 0xe0) == 0xa0 || m == 0xd9 || m == 0xda || m == 0xdb) {
+            if ((m & 0xe0) == 0xa0) {
+                len = m & 0x1f;
+            } else if (!read_len(m == 0xd9 ? 1 : (m == 0xda ? 2 : 4))) {
+                return Status::truncated;
+            }
+            if (!need(len)) {
+                return Status::truncated;
+            }
+            ok = visitor.on_str(std::string_view(reinterpret_cast<const char*>(p), len));
+            p += len;
+        } else {
+            switch (m) {
+                case 0xc0: ok = visitor.on_nil(); break;
+                case 0xc2: ok = visitor.on_bool(false); break;
+                case 0xc3: ok = visitor.on_bool(true); break;
+                case 0xc4: case 0xc5: case 0xc6:
+                    if (!read_len(1u << (m - 0xc4)) || !need(len)) {
+                        return Status::truncated;
+                    }
+                    ok = visitor.on_bin(std::span<const uint8_t>(p, len));
+                    p += len;
+                    break;
+                case 0xc7: case 0xc8: case 0xc9:
+                case 0xd4: case 0xd5: case 0xd6: case 0xd7: case 0xd8: {
+                    if (m >= 0xd4) {
+                        len = 1u << (m - 0xd4);
+                    } else if (!read_len(1u << (m - 0xc7))) {
+                        return Status::truncated;
+                    }
+                    if (!need(1 + static_cast<size_t>(len))) {
+                        return Status::truncated;
+                    }
+                    const auto type = static_cast<int8_t>(*p++);
+                    ok = visitor.on_ext(type, std::span<const uint8_t>(p, len));
+                    p += len;
+                    break;
+                }
+                case 0xca: {
+                    if (!need(4)) return Status::truncated;
+                    const auto bits = static_cast<uint32_t>(detail::load_be(p, 4));
+                    float f;
+                    memcpy(&f, &bits, sizeof(f));
+                    p += 4;
+                    ok = visitor.on_double(f);
+                    break;
+                }
+                case 0xcb: {
+                    if (!need(8)) return Status::truncated;
+                    const uint64_t bits = detail::load_be(p, 8);
+                    double d;
+                    memcpy(&d, &bits, sizeof(d));
+                    p += 8;
+                    ok = visitor.on_double(d);
+                    break;
+                }
+                case 0xcc: case 0xcd: case 0xce: case 0xcf: {
+                    const uint32_t width = 1u << (m - 0xcc);
+                    if (!need(width)) return Status::truncated;
+                    ok = visitor.on_uint(detail::load_be(p, width));
+                    p += width;
+                    break;
+                }
+                case 0xd0: case 0xd1: case 0xd2: case 0xd3: {
+                    const uint32_t width = 1u << (m - 0xd0);
+                    if (!need(width)) return Status::truncated;
+                    ok = visitor.on_int(detail::sign_extend(detail::load_be(p, width), width));
+                    p += width;
+                    break;
+                }
+                default:
+                    return Status::invalid;
+            }
+        }
+
+        if (!ok) {
+            return Status::stopped;
+        }
+
+        // A just-opened non-empty container waits for its items; otherwise
+        // the value is complete and closes any containers it finishes.
+        if (opened && stack[depth - 1].remaining > 0) {
+            continue;
+        }
+        bool complete = !opened;
+        if (opened) {
+            // empty container: close it immediately
+            const bool is_map = stack[--depth].is_map;
+            if (!(is_map ? visitor.on_map_end() : visitor.on_array_end())) {
+                return Status::stopped;
+            }
+            complete = true;
+        }
+        while (complete && depth > 0) {
+            Frame& top = stack[depth - 1];
+            if (--top.remaining > 0) {
+                break;
+            }
+            --depth;
+            if (!(top.is_map ? visitor.on_map_end() : visitor.on_array_end())) {
+                return Status::stopped;
+            }
+        }
+        if (depth == 0) {
+            if (consumed) {
+                *consumed = static_cast<size_t>(p - data.data());
+            }
+            return Status::ok;
+        }
+    }
+}
+
+// Parses a MSGPACK WL_VALUE in place (no copy, nothing freed).
+template <typename V>
+Status parse(WL_VALUE v, V& visitor) noexcept {
+    if (!wl_is_address(v) || wl_get_tag(v) != WL_TAG_MSGPACK) {
+        return Status::invalid;
+    }
+    const auto* c = reinterpret_cast<const BaseContainer*>(static_cast<uintptr_t>(wl_get_payload32(v)));
+    if (!c) {
+        return Status::invalid;
+    }
+    return parse(std::span<const uint8_t>(c->data, c->size), visitor);
+}
+
+} // namespace walink::msgpack
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "walink.h"
+
+#include <stdint.h>
+
+// Shared-memory request/response ring (threaded builds only).
+//
+// Built when WALINK_THREADS=1 (CMake option WALINK_THREADS). A channel lives in
+// linear memory and holds two single-producer/single-consumer rings:
+//
+//   requests : host thread -> wasm worker (walink_ring_run)
+//   responses: wasm worker -> host thread
+//
+// The worker dispatches each request through the batch registry
+// (WL_BATCH_REGISTER), so any batchable function can be called through a ring.
+// Indices are free-running uint32 counters accessed with atomics; the host
+// side uses Atomics on the same offsets, so the layout below is ABI.
+//
+// Channel layout (every block 64-byte aligned):
+//
+//   WlRingChannel                      (64 bytes)
+//   request ring : head(64) tail(64) WlRingRequest[capacity]
+//   response ring: head(64) tail(64) WlRingResponse[capacity]
+//
+// The worker only ever waits on `doorbell`, so whoever posts a request,
+// releases a response entry or stops the channel bumps and notifies it.
+//
+// 64-bit scalar arguments/results cannot stay in scratch slots while queued,
+// so they are copied into the entry (`scalars` / `scalar`) and the value's
+// payload is redirected there. An entry stays valid until its consumer
+// advances `head`.
+
+#if WALINK_THREADS
+
+constexpr uint32_t WL_RING_MAX_ARGS = 6;
+
+// Byte offsets inside one ring (relative to its header).
+constexpr uint32_t WL_RING_HEAD_OFFSET = 0;
+constexpr uint32_t WL_RING_TAIL_OFFSET = 64;
+constexpr uint32_t WL_RING_ENTRIES_OFFSET = 128;
+
+struct alignas(64) WlRingChannel {
+    uint32_t capacity;        // entries per ring, power of two
+    uint32_t request_offset;  // from channel start
+    uint32_t response_offset; // from channel start
+    uint32_t stop;            // non-zero: worker loop exits
+    uint32_t doorbell;        // bumped (and notified) on every post / response release / stop
+    uint32_t reserved[11];
+};
+
+struct WlRingRequest {
+    uint64_t id;
+    uint32_t fn_id;
+    uint32_t argc;
+    WL_VALUE args[WL_RING_MAX_ARGS];
+    uint64_t scalars[WL_RING_MAX_ARGS];
+    uint64_t reserved[2];
+};
+
+struct WlRingResponse {
+    uint64_t id;
+    WL_VALUE result;
+    uint64_t scalar;
+    uint64_t reserved;
+};
+
+static_assert(sizeof(WlRingChannel) == 64, "WlRingChannel layout is shared with the host");
+static_assert(sizeof(WlRingRequest) == 128, "WlRingRequest layout is shared with the host");
+static_assert(sizeof(WlRingResponse) == 32, "WlRingResponse layout is shared with the host");
+
+namespace walink {
+
+// Allocates a channel with `capacity` entries per ring (rounded up to a power
+// of two, >= 2). Returns nullptr on failure.
+extern WlRingChannel* wl_ring_create(uint32_t capacity) noexcept;
+
+// Releases free-flagged values still queued in either ring, then the channel.
+// The worker must have returned from wl_ring_run.
+extern void wl_ring_destroy(WlRingChannel* ch) noexcept;
+
+// Producer side of the request ring. Returns false if the ring is full.
+extern bool wl_ring_post(WlRingChannel* ch, uint64_t id, uint32_t fn_id,
+                         const WL_VALUE* args, uint32_t argc) noexcept;
+
+// Consumer side of the response ring. Copies the next response into `out`
+// and releases the entry; returns false if none is ready. A 64-bit scalar
+// result is left pointing at out->scalar.
+extern bool wl_ring_poll(WlRingChannel* ch, WlRingResponse* out) noexcept;
+
+// Worker loop: drains requests until wl_ring_stop. Blocks (atomic wait) while
+// the request ring is empty or the response ring is full; a stop ends either
+// wait. A result that no longer fits after a stop is released. Returns the
+// number of requests whose response was written.
+extern uint32_t wl_ring_run(WlRingChannel* ch) noexcept;
+
+extern void wl_ring_stop(WlRingChannel* ch) noexcept;
+
+} // namespace walink
+
+extern "C" {
+
+// Channel address (same return convention as walink_alloc) or ERROR.
+WL_VALUE walink_ring_create(uint32_t capacity) noexcept;
+
+// Runs the worker loop on the calling thread; returns the processed count as
+// uint32 once the channel is stopped.
+WL_VALUE walink_ring_run(WL_VALUE channel) noexcept;
+
+WL_VALUE walink_ring_stop(WL_VALUE channel) noexcept;
+
+WL_VALUE walink_ring_destroy(WL_VALUE channel) noexcept;
+
+} // extern "C"
+
+#endif // WALINK_THREADS
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "walink.h"
+
+#include <stdint.h>
+
+// Opt-in allocation instrumentation (CMake option WALINK_STATS).
+//
+// Every heap block from walink_alloc / wl_alloc_container / wl_make_f64 gets
+// a 16-byte prefix recording its size and kind, so walink_free can account
+// for it exactly and refuse a block that is not live: a foreign pointer, or a
+// double free as long as the block has not been allocated again. Once the
+// allocator reuses the block, a stale second free releases the new owner's
+// block and cannot be told apart from a valid one. Counters are relaxed
+// atomics: a handful of instructions per allocation. Arena allocations are
+// not counted (they go away in bulk with walink_arena_reset).
+//
+// Without WALINK_STATS nothing is recorded and walink_stats returns 0.
+
+constexpr uint32_t WL_STATS_VERSION = 1;
+
+// Live-block buckets (WlStats::live_by_kind).
+enum WlStatsKind : uint32_t {
+    WL_STATS_HOST = 0,   // walink_alloc: blocks the host fills (arguments)
+    WL_STATS_BYTES,
+    WL_STATS_STRING,     // STRING and STRING16
+    WL_STATS_MSGPACK,
+    WL_STATS_ARRAY,      // typed numeric arrays
+    WL_STATS_FLAT,
+    WL_STATS_IOVEC,
+    WL_STATS_ERROR,
+    WL_STATS_SCALAR,     // boxed float64 / sint64 / uint64
+    WL_STATS_RECYCLED,   // parked in the walink_recycle cache
+    WL_STATS_OTHER,
+    WL_STATS_KIND_COUNT,
+};
+
+// WlStats::size_histogram[i] counts allocations of at most (16 << i) bytes;
+// the last bucket takes everything larger.
+constexpr uint32_t WL_STATS_SIZE_BUCKETS = 16;
+
+// Host-visible snapshot (little-endian, 224 bytes). Mirrored by Node's
+// Walink.stats().
+struct WlStats {
+    uint32_t version;
+    uint32_t live_blocks;
+    uint32_t live_bytes;
+    uint32_t peak_bytes;
+    uint64_t alloc_count;
+    uint64_t free_count;
+    // walink_free / walink_recycle of a block that is not live: a double
+    // free (until the block is reused) or a pointer walink never allocated.
+    // The block is left alone.
+    uint64_t bad_free_count;
+    // walink_free of a value that is not address-based or points at a
+    // scratch slot
+    uint64_t invalid_free_count;
+    uint32_t live_by_kind[12];
+    uint64_t size_histogram[WL_STATS_SIZE_BUCKETS];
+};
+
+static_assert(WL_STATS_KIND_COUNT <= 12, "WlStats::live_by_kind is too small");
+static_assert(sizeof(WlStats) == 224, "WlStats layout is part of the host ABI");
+
+namespace walink {
+
+// Bucket of a WL_VALUE tag.
+extern uint32_t wl_stats_kind_of(uint32_t tag) noexcept;
+
+// Bookkeeping hooks, called by the allocator in walink.cc (WALINK_STATS only).
+extern void wl_stats_on_alloc(uint32_t size, uint32_t kind) noexcept;
+extern void wl_stats_on_free(uint32_t size, uint32_t kind) noexcept;
+extern void wl_stats_on_retag(uint32_t from, uint32_t to) noexcept;
+extern void wl_stats_on_bad_free() noexcept;
+extern void wl_stats_on_invalid_free() noexcept;
+
+// Current counters (all zero without WALINK_STATS).
+extern WlStats wl_stats() noexcept;
+
+} // namespace walink
+
+extern "C" {
+
+// Address of a per-thread WlStats snapshot taken by this call (meta 0, like
+// walink_scratch_slots), or 0 when built without WALINK_STATS.
+WL_VALUE walink_stats() noexcept;
+
+} // extern "C"
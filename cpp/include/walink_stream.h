@@ -0,0 +1,117 @@
+#pragma once
+
+#include "walink.h"
+
+#include <stdint.h>
+
+#include <new>
+#include <span>
+
+// Chunked streams (WL_TAG_STREAM).
+//
+// A stream moves a bytes/string/msgpack body across the boundary in pieces of
+// at most `chunk_size` bytes through one fixed working buffer, so neither side
+// ever holds the whole payload in wasm memory. The wasm side implements the
+// stream with callbacks and returns a STREAM value; the host then drives it:
+//
+//   source (wasm -> host): walink_stream_read fills the buffer with the next
+//                          chunk, until it returns 0
+//   sink   (host -> wasm): the host fills the buffer, walink_stream_write
+//                          hands those bytes to the sink
+//
+// walink_stream_close releases the stream and returns the close callback's
+// result (e.g. a summary computed by a sink). STREAM values never carry the
+// free or arena flag; walink_stream_close is the only way to release one.
+//
+// The working buffer is a BaseContainer (cap = chunk size) tagged with the
+// stream's content tag. It does not move for the lifetime of the stream.
+// Streams are always heap-allocated (never from the per-call arena).
+
+constexpr uint32_t WL_STREAM_DEFAULT_CHUNK_SIZE = 64u * 1024u;
+
+namespace walink {
+
+// Writes the next chunk into `buf`; returns the byte count, 0 at end of stream.
+using wl_stream_read_fn = Result<uint32_t> (*)(void* ctx, std::span<uint8_t> buf) noexcept;
+
+// Consumes one chunk. Return Error{Errc::ok, nullptr} on success.
+using wl_stream_write_fn = Error (*)(void* ctx, std::span<const uint8_t> chunk) noexcept;
+
+// Releases `ctx`; the returned value goes to whoever closed the stream.
+using wl_stream_close_fn = WL_VALUE (*)(void* ctx) noexcept;
+
+struct WlStreamOps {
+    wl_stream_read_fn read = nullptr;   // source streams
+    wl_stream_write_fn write = nullptr; // sink streams
+    wl_stream_close_fn close = nullptr; // optional
+};
+
+// Creates a stream over `ctx`. `content_tag` describes the concatenated
+// chunks (WL_TAG_BYTES, WL_TAG_STRING or WL_TAG_MSGPACK). Returns 0 on
+// allocation failure, in which case ops.close has already been called.
+extern WL_VALUE wl_make_stream(const WlStreamOps& ops, void* ctx,
+                               uint32_t content_tag, uint32_t chunk_size) noexcept;
+
+// Adapter for a heap object with any of
+//     Result<uint32_t> read(std::span<uint8_t> buf) noexcept;
+//     Error write(std::span<const uint8_t> chunk) noexcept;
+//     WL_VALUE finish() noexcept;   // result of walink_stream_close
+// The stream takes ownership of `obj` and deletes it on close.
+template <typename T>
+WL_VALUE wl_make_stream(T* obj, uint32_t content_tag,
+                        uint32_t chunk_size = WL_STREAM_DEFAULT_CHUNK_SIZE) noexcept {
+    WlStreamOps ops;
+    if constexpr (requires(T& t, std::span<uint8_t> buf) { t.read(buf); }) {
+        ops.read = [](void* ctx, std::span<uint8_t> buf) noexcept -> Result<uint32_t> {
+            return static_cast<T*>(ctx)->read(buf);
+        };
+    }
+    if constexpr (requires(T& t, std::span<const uint8_t> chunk) { t.write(chunk); }) {
+        ops.write = [](void* ctx, std::span<const uint8_t> chunk) noexcept -> Error {
+            return static_cast<T*>(ctx)->write(chunk);
+        };
+    }
+    ops.close = [](void* ctx) noexcept -> WL_VALUE {
+        auto* self = static_cast<T*>(ctx);
+        WL_VALUE result = 0;
+        if constexpr (requires(T& t) { t.finish(); }) {
+            result = self->finish();
+        }
+        delete self;
+        return result;
+    };
+    return wl_make_stream(ops, obj, content_tag, chunk_size);
+}
+
+// C++-side driving of a stream (same rules as the exports below).
+
+// Reads the next chunk into the working buffer and returns a view of it
+// (empty at end of stream). The view is valid until the next call.
+extern Result<std::span<const uint8_t>> wl_stream_read_chunk(WL_VALUE stream) noexcept;
+
+// Passes `chunk` straight to the sink (no copy through the working buffer).
+extern Error wl_stream_write_chunk(WL_VALUE stream, std::span<const uint8_t> chunk) noexcept;
+
+// Closes the stream and returns the close callback's result (null if none).
+extern WL_VALUE wl_stream_close(WL_VALUE stream) noexcept;
+
+} // namespace walink
+
+extern "C" {
+
+// Working buffer of the stream: BaseContainer address tagged with the stream's
+// content tag (no free flag), or ERROR.
+WL_VALUE walink_stream_buffer(WL_VALUE stream) noexcept;
+
+// Source: fills the working buffer with the next chunk (container size is
+// updated) and returns its length as uint32; 0 means end of stream.
+WL_VALUE walink_stream_read(WL_VALUE stream) noexcept;
+
+// Sink: the host has written `size` bytes (<= chunk size) at the start of the
+// working buffer's data; passes them to the sink. Returns null or ERROR.
+WL_VALUE walink_stream_write(WL_VALUE stream, uint32_t size) noexcept;
+
+// Releases the stream; returns the close callback's result or null.
+WL_VALUE walink_stream_close(WL_VALUE stream) noexcept;
+
+} // extern "C"
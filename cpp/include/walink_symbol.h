@@ -0,0 +1,63 @@
+#pragma once
+
+#include "walink.h"
+
+#include <stdint.h>
+
+#include <string_view>
+
+// Interned strings (WL_TAG_SYMBOL).
+//
+// Exports that keep returning the same small set of strings (enum names,
+// field keys, status codes) can return a symbol instead: a direct value whose
+// payload is the string's id in a process-wide intern table. Returning one
+// costs no allocation and no free; the host resolves each id once with
+// walink_symbol_lookup and caches the decoded string.
+//
+// Interned strings live until the module is torn down, so intern only a
+// bounded vocabulary, never user data. Ids are assigned in first-intern order
+// and are stable for the lifetime of the instance.
+
+namespace walink {
+
+// Symbol as a C++ value, so WL_EXPORT functions can return (or take) one.
+struct Symbol {
+    uint32_t id;
+};
+
+template <> struct codec<Symbol> : direct_codec<WL_TAG_SYMBOL> {
+    static constexpr WL_VALUE encode(Symbol s) noexcept { return make(s.id); }
+    static constexpr Symbol decode(WL_VALUE v) noexcept { return Symbol{wl_get_payload32(v)}; }
+};
+
+constexpr WL_VALUE wl_from_symbol(Symbol s) noexcept { return codec<Symbol>::encode(s); }
+constexpr Symbol wl_to_symbol(WL_VALUE v) noexcept { return codec<Symbol>::decode(v); }
+
+// Id of `str`, interning it on first use. Returns 0 (NULL) on allocation
+// failure. Takes a lock in threaded builds; hot paths should use WL_SYMBOL.
+extern WL_VALUE wl_intern(std::string_view str) noexcept;
+
+// Interned text of a symbol; empty for non-symbols and unknown ids.
+extern std::string_view wl_symbol_name(WL_VALUE sym) noexcept;
+
+extern Result<std::string_view> wl_try_symbol_name(WL_VALUE sym) noexcept;
+
+// Number of interned strings.
+extern uint32_t wl_symbol_count() noexcept;
+
+} // namespace walink
+
+// Interns `literal` once per call site; later evaluations are a static load.
+#define WL_SYMBOL(literal)                                                \
+    ([]() noexcept -> WL_VALUE {                                          \
+        static const WL_VALUE wl_symbol_ = ::walink::wl_intern(literal);  \
+        return wl_symbol_;                                                \
+    }())
+
+extern "C" {
+
+// Text of a symbol as a STRING container without the free flag (the intern
+// table owns it; the host must not free it), or ERROR for unknown ids.
+WL_VALUE walink_symbol_lookup(WL_VALUE sym) noexcept;
+
+} // extern "C"
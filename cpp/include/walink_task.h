@@ -0,0 +1,172 @@
+#pragma once
+
+#include "walink.h"
+#include "walink_export.h"
+
+#include <stdint.h>
+
+#include <coroutine>
+#include <utility>
+
+// Resumable wasm-side jobs (WL_TAG_PENDING).
+//
+// A long-running export returns a walink::Task coroutine instead of a value.
+// wl_spawn parks the coroutine in the completion table and hands the host a
+// PENDING value; the host then calls walink_poll(pending, budget) from its
+// event loop, and each poll runs the job until it has spent `budget` units of
+// work:
+//
+//     walink::Task checksum(std::string data) {
+//         uint32_t sum = 0;
+//         for (char c : data) {
+//             sum = sum * 31 + static_cast<uint8_t>(c);
+//             co_await walink::wl_step();   // one unit; suspends when the budget is spent
+//         }
+//         co_return walink::wl_from_uint32(sum);
+//     }
+//     WL_EXPORT(wl_checksum, checksum);    // returns PENDING (Node: a Promise)
+//
+// The task only suspends at its co_await points, so a step should be a
+// bounded amount of work. The body first runs at the first walink_poll, after
+// the export has returned and its argument containers are gone, so parameters
+// must be owning values copied into the coroutine frame (std::string,
+// scalars). WL_EXPORT rejects std::string_view, std::span and reference
+// parameters of a Task-returning function at compile time.
+//
+// PENDING values are direct: the payload is a slot of the handle table
+// (walink_handle.h), same index / generation layout as HANDLE, so a finished
+// or cancelled task fails lookup like a stale handle. Live tasks count in
+// wl_handle_count(). A task must be polled by one thread at a time.
+
+namespace walink {
+
+class Task {
+public:
+    struct promise_type;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    // co_await wl_step(cost)
+    struct Step {
+        uint32_t cost;
+    };
+
+    // co_await wl_yield()
+    struct Yield {};
+
+    struct StepAwaiter {
+        promise_type* promise;
+        uint32_t cost;
+
+        // Keep going while budget is left; suspending costs a frame save.
+        bool await_ready() const noexcept {
+            if (promise->budget > cost) {
+                promise->budget -= cost;
+                return true;
+            }
+            promise->budget = 0;
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<>) const noexcept {}
+        void await_resume() const noexcept {}
+    };
+
+    struct promise_type {
+        // result handed to the host once the coroutine finishes
+        WL_VALUE result = 0;
+        // work units left in the current walink_poll
+        uint32_t budget = 0;
+
+        Task get_return_object() noexcept { return Task(handle_type::from_promise(*this)); }
+        // Frames come from operator new(std::nothrow); a failed allocation
+        // yields an empty Task (wl_spawn turns it into an ERROR).
+        static Task get_return_object_on_allocation_failure() noexcept { return Task(); }
+
+        // Nothing runs before the first poll (or wl_spawn's first slice).
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        void return_value(WL_VALUE v) noexcept { result = v; }
+        // Turns an escaping exception into an ERROR result.
+        void unhandled_exception() noexcept;
+
+        StepAwaiter await_transform(Step s) noexcept { return {this, s.cost}; }
+        std::suspend_always await_transform(Yield) noexcept {
+            budget = 0;
+            return {};
+        }
+    };
+
+    Task() noexcept = default;
+    explicit Task(handle_type h) noexcept : handle_(h) {}
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    explicit operator bool() const noexcept { return static_cast<bool>(handle_); }
+
+    // Gives up ownership of the coroutine frame.
+    handle_type release() noexcept { return std::exchange(handle_, {}); }
+
+private:
+    handle_type handle_;
+};
+
+// Suspension point worth `cost` units of the poll budget. Execution continues
+// without suspending while budget is left.
+inline Task::Step wl_step(uint32_t cost = 1) noexcept {
+    return {cost};
+}
+
+// Unconditional suspension point: ends the current poll.
+inline Task::Yield wl_yield() noexcept {
+    return {};
+}
+
+// Registers `task` in the completion table and returns its PENDING value.
+// With a non-zero `budget` the first slice runs right away, and a task that
+// finishes within it returns its result directly (no PENDING round trip).
+// An empty task (frame allocation failed) or a full table gives an ERROR.
+extern WL_VALUE wl_spawn(Task task, uint32_t budget = 0) noexcept;
+
+// WL_EXPORT functions may return a Task: the wrapper spawns it (without running
+// it) and the host receives PENDING. `deferred` makes WL_EXPORT require owning
+// parameters (see export_signature).
+template <> struct ret_codec<Task> {
+    static constexpr uint32_t tag = WL_TAG_PENDING;
+    static constexpr bool deferred = true;
+    static WL_VALUE encode(Task task) noexcept { return wl_spawn(std::move(task)); }
+};
+
+} // namespace walink
+
+extern "C" {
+
+// Resume the task behind `pending` for up to `budget` work units (0 counts as
+// 1). Returns its result once it finishes (ownership passes to the caller and
+// the PENDING value becomes stale), `pending` itself while it is still
+// running, or an ERROR for a stale / non-PENDING value.
+WL_VALUE walink_poll(WL_VALUE pending, uint32_t budget) noexcept;
+
+// Destroy an unfinished task without running it further. Boolean: false for
+// a stale value (already finished or cancelled).
+WL_VALUE walink_cancel(WL_VALUE pending) noexcept;
+
+} // extern "C"
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "walink.h"
+
+#include <stdint.h>
+
+// Per-export call tracing (CMake option WALINK_TRACE).
+//
+// Every WL_EXPORT call appends four records to a fixed-size ring in linear
+// memory, one per phase boundary:
+//
+//   BEGIN   entered the wrapper (bytes_in: container bytes of the arguments)
+//   ARGS    arguments checked and decoded; the user function starts
+//   RETURN  the user function returned; result encoding starts
+//   END     result encoded (bytes_out: container bytes of the result)
+//
+// so ARGS - BEGIN is argument marshalling, RETURN - ARGS the function itself
+// and END - RETURN result marshalling. The host reads the ring in place
+// (Node: WalinkTrace) and turns it into latency histograms.
+//
+// Timestamps are milliseconds as a double: the wasm import env.walink_trace_now
+// (performance.now() on the host), or CLOCK_MONOTONIC natively.
+//
+// Without WALINK_TRACE the WL_TRACE macro expands to nothing, its arguments
+// are not evaluated, the ring is not allocated and the module has no
+// walink_trace_now import.
+
+// Ring size in records; a power of two.
+#ifndef WL_TRACE_CAPACITY
+#define WL_TRACE_CAPACITY 4096
+#endif
+
+static_assert((WL_TRACE_CAPACITY & (WL_TRACE_CAPACITY - 1)) == 0, "WL_TRACE_CAPACITY must be a power of two");
+
+enum WlTracePhase : uint32_t {
+    WL_TRACE_BEGIN = 0,
+    WL_TRACE_ARGS = 1,
+    WL_TRACE_RETURN = 2,
+    WL_TRACE_END = 3,
+};
+
+// 24 bytes, little-endian.
+struct WlTraceRecord {
+    uint32_t export_id; // manifest index (walink_manifest order)
+    uint32_t phase;     // WlTracePhase
+    double time;        // milliseconds
+    uint32_t bytes_in;
+    uint32_t bytes_out;
+};
+
+// Record i (counting from the first event) is records[i % capacity]. `count`
+// only grows (wrapping at 2^32); a reader that fell more than `capacity`
+// records behind has lost the oldest ones.
+struct alignas(8) WlTraceRing {
+    uint32_t capacity;
+    uint32_t count;
+    uint32_t record_size;
+    uint32_t reserved;
+    WlTraceRecord records[WL_TRACE_CAPACITY];
+};
+
+static_assert(sizeof(WlTraceRecord) == 24, "WlTraceRecord layout is part of the host ABI");
+
+#if WALINK_TRACE
+
+namespace walink {
+
+extern WlTraceRing g_wl_trace;
+
+extern double wl_trace_now() noexcept;
+
+// Container payload bytes of `v` (0 for direct values).
+inline uint32_t wl_trace_bytes(WL_VALUE v) noexcept {
+    if (!wl_is_address(v) || !wl_is_container_tag(wl_get_tag(v)) || wl_get_payload32(v) == 0) {
+        return 0;
+    }
+    return reinterpret_cast<const BaseContainer*>(static_cast<uintptr_t>(wl_get_payload32(v)))->size;
+}
+
+inline void wl_trace_event(uint32_t export_id, uint32_t phase, uint32_t bytes_in, uint32_t bytes_out) noexcept {
+#if WALINK_THREADS
+    const uint32_t i = __atomic_fetch_add(&g_wl_trace.count, 1u, __ATOMIC_RELAXED);
+#else
+    const uint32_t i = g_wl_trace.count++;
+#endif
+    g_wl_trace.records[i & (WL_TRACE_CAPACITY - 1)] = {export_id, phase, wl_trace_now(), bytes_in, bytes_out};
+}
+
+} // namespace walink
+
+#define WL_TRACE(export_id, phase, bytes_in, bytes_out) \
+    ::walink::wl_trace_event((export_id), (phase), (bytes_in), (bytes_out))
+
+#else
+
+#define WL_TRACE(export_id, phase, bytes_in, bytes_out) ((void)0)
+
+#endif
+
+extern "C" {
+
+// Address of the WlTraceRing (meta 0, like walink_scratch_slots), or 0 when
+// built without WALINK_TRACE. The ring never moves.
+WL_VALUE walink_trace_buffer() noexcept;
+
+} // extern "C"
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "walink.h"
+
+#include <stdint.h>
+
+#include <span>
+#include <string_view>
+
+// UTF-8 validation, UTF-8 <-> UTF-16 transcoding and WL_TAG_STRING16.
+//
+// STRING16 is a BaseContainer of UTF-16LE code units (size in bytes). The host
+// decodes it without transcoding (TextDecoder('utf-16le') is close to a copy),
+// which pays off for long non-ASCII text; ASCII is cheapest as plain UTF-8.
+// wl_make_text picks the cheaper of the two per result, and
+// wl_try_borrow_string accepts both tags, transcoding STRING16 arguments.
+//
+// With WALINK_SIMD on a wasm simd128 build, ASCII runs (the common case in
+// both directions) are scanned and widened/narrowed 16 bytes at a time;
+// otherwise 8 bytes at a time in a 64-bit word.
+
+// wl_make_text returns STRING16 only for non-ASCII text at least this long.
+constexpr uint32_t WL_STRING16_MIN_BYTES = 1024;
+
+namespace walink {
+
+// Length of the leading all-ASCII run.
+extern size_t wl_ascii_prefix(std::span<const uint8_t> utf8) noexcept;
+
+// Well-formed UTF-8 (no overlongs, surrogates or code points above U+10FFFF).
+extern bool wl_utf8_validate(std::span<const uint8_t> utf8) noexcept;
+
+// Validates and transcodes; `out` needs room for utf8.size() code units.
+// Returns the number of code units written.
+extern Result<uint32_t> wl_utf8_to_utf16(std::span<const uint8_t> utf8, char16_t* out) noexcept;
+
+// UTF-8 byte length of `utf16` (lone surrogates count as U+FFFD).
+extern size_t wl_utf8_length(std::u16string_view utf16) noexcept;
+
+// Transcodes; `out` needs wl_utf8_length(utf16) bytes. Lone surrogates become
+// U+FFFD, as with the host's TextEncoder. Returns the bytes written.
+extern uint32_t wl_utf16_to_utf8(std::u16string_view utf16, uint8_t* out) noexcept;
+
+extern WL_VALUE wl_make_string16(std::u16string_view utf16, bool free_flag_for_receiver) noexcept;
+
+// STRING16 from UTF-8 text; ERROR if `utf8` is not valid UTF-8.
+extern WL_VALUE wl_make_string16(std::string_view utf8, bool free_flag_for_receiver) noexcept;
+
+// STRING for ASCII or short text, STRING16 for non-ASCII text of at least
+// WL_STRING16_MIN_BYTES. Hosts decode both tags as strings.
+extern WL_VALUE wl_make_text(std::string_view utf8, bool free_flag_for_receiver) noexcept;
+
+} // namespace walink
+
+extern "C" {
+
+// Boolean: the STRING / BYTES container holds well-formed UTF-8. An owned
+// input is released.
+WL_VALUE walink_utf8_validate(WL_VALUE value) noexcept;
+
+// STRING -> STRING16 (free flag set); an owned input is released. ERROR on
+// invalid UTF-8.
+WL_VALUE walink_string_to_utf16(WL_VALUE value) noexcept;
+
+} // extern "C"
@@ -1,4 +1,6 @@
 #include "walink.h"
+#include "walink_stats.h"
+#include "walink_utf.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -6,305 +8,779 @@
 #include <string_view>
 #include <stdexcept>
 
-static void* walink_alloc_ptr(uint32_t size) {
-    return malloc(size);
-}
-
-namespace walink {
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/heap.h>
+#include <unistd.h>
+#endif
 
-// ---- Convenience factories for direct-value scalars (to/from) -----------
-
-WL_VALUE wl_from_bool(bool b) noexcept {
-    const uint32_t payload = b ? 1u : 0u;
-    const uint32_t meta = wl_build_meta(WL_TAG_BOOLEAN, /*is_address*/ false, /*free*/false, /*user*/false);
-    return wl_make(meta, payload);
-}
-
-bool wl_to_bool(WL_VALUE v) noexcept {
-    return wl_get_payload32(v) != 0;
-}
-
-WL_VALUE wl_from_sint8(int32_t v) noexcept {
-    const int32_t val = static_cast<int32_t>(static_cast<int8_t>(v));
-    const uint32_t payload = static_cast<uint32_t>(val);
-    const uint32_t meta = wl_build_meta(WL_TAG_SINT8, /*is_address*/ false, /*free*/false, /*user*/false);
-    return wl_make(meta, payload);
+static void* walink_raw_alloc(uint32_t size) {
+#if WALINK_POOL_ALLOCATOR || WALINK_THREADS
+    return walink::wl_pool_alloc(size);
+#else
+    return malloc(size);
+#endif
 }
 
-int32_t wl_to_sint8(WL_VALUE v) noexcept {
-    return static_cast<int32_t>(static_cast<int8_t>(wl_get_payload32(v)));
+static void walink_raw_free(void* ptr) {
+#if WALINK_POOL_ALLOCATOR || WALINK_THREADS
+    walink::wl_pool_free(ptr);
+#else
+    free(ptr);
+#endif
 }
 
-WL_VALUE wl_from_uint8(uint32_t v) noexcept {
-    const uint32_t payload = v & 0xffu;
-    const uint32_t meta = wl_build_meta(WL_TAG_UINT8, /*is_address*/ false, /*free*/false, /*user*/false);
-    return wl_make(meta, payload);
+#if WALINK_STATS
+// Prefix of every heap block in instrumented builds (see walink_stats.h).
+// 16 bytes, so the block keeps the allocator's alignment.
+struct WlStatsHeader {
+    uint32_t magic;
+    uint32_t size;
+    uint32_t kind;
+    uint32_t reserved;
+};
+
+constexpr uint32_t kStatsLiveMagic = 0x314b4c57; // "WLK1"
+constexpr uint32_t kStatsFreedMagic = 0x304b4c57; // "WLK0"
+
+static WlStatsHeader* walink_stats_header(void* ptr) noexcept {
+    return static_cast<WlStatsHeader*>(ptr) - 1;
 }
+#endif
 
-uint32_t wl_to_uint8(WL_VALUE v) noexcept {
-    return wl_get_payload32(v) & 0xffu;
+static void* walink_alloc_ptr(uint32_t size) {
+#if WALINK_STATS
+    if (size > UINT32_MAX - sizeof(WlStatsHeader)) {
+        return nullptr;
+    }
+    auto* h = static_cast<WlStatsHeader*>(walink_raw_alloc(size + static_cast<uint32_t>(sizeof(WlStatsHeader))));
+    if (!h) {
+        return nullptr;
+    }
+    *h = {kStatsLiveMagic, size, WL_STATS_HOST, 0};
+    walink::wl_stats_on_alloc(size, WL_STATS_HOST);
+    return h + 1;
+#else
+    return walink_raw_alloc(size);
+#endif
 }
 
-WL_VALUE wl_from_sint16(int32_t v) noexcept {
-    const int32_t val = static_cast<int32_t>(static_cast<int16_t>(v));
-    const uint32_t payload = static_cast<uint32_t>(val);
-    const uint32_t meta = wl_build_meta(WL_TAG_SINT16, /*is_address*/ false, /*free*/false, /*user*/false);
-    return wl_make(meta, payload);
+// false (and nothing freed) for a block that is not live; always true
+// without WALINK_STATS. A stale pointer is only caught until the allocator
+// hands the block out again; after that it frees the new owner's block.
+static bool walink_free_ptr(void* ptr) {
+#if WALINK_STATS
+    if (!ptr) {
+        return true;
+    }
+    WlStatsHeader* h = walink_stats_header(ptr);
+    if (h->magic != kStatsLiveMagic) {
+        walink::wl_stats_on_bad_free();
+        return false;
+    }
+    h->magic = kStatsFreedMagic;
+    walink::wl_stats_on_free(h->size, h->kind);
+    ptr = h;
+#endif
+    walink_raw_free(ptr);
+    return true;
 }
 
-int32_t wl_to_sint16(WL_VALUE v) noexcept {
-    return static_cast<int32_t>(static_cast<int16_t>(wl_get_payload32(v)));
+// Moves a live block to the WlStatsKind bucket `kind`; false if the block is
+// not live, or is parked in the recycle cache and handed back again. No-op
+// (true) without WALINK_STATS.
+static bool walink_stats_tag(void* ptr, uint32_t kind) noexcept {
+#if WALINK_STATS
+    WlStatsHeader* h = walink_stats_header(ptr);
+    if (h->magic != kStatsLiveMagic || (kind == WL_STATS_RECYCLED && h->kind == WL_STATS_RECYCLED)) {
+        walink::wl_stats_on_bad_free();
+        return false;
+    }
+    walink::wl_stats_on_retag(h->kind, kind);
+    h->kind = kind;
+#else
+    (void)ptr;
+    (void)kind;
+#endif
+    return true;
 }
 
-WL_VALUE wl_from_uint16(uint32_t v) noexcept {
-    const uint32_t payload = v & 0xffffu;
-    const uint32_t meta = wl_build_meta(WL_TAG_UINT16, /*is_address*/ false, /*free*/false, /*user*/false);
-    return wl_make(meta, payload);
-}
+namespace walink {
 
-uint32_t wl_to_uint16(WL_VALUE v) noexcept {
-    return wl_get_payload32(v) & 0xffffu;
+// ---- Recycle cache ---------------------------------------------------------
+//
+// Blocks handed back through wl_recycle, with their usable size. A block is
+// reused for a request of at least half its size, so a small value never
+// pins a large buffer.
+
+struct WlRecycledBlock {
+    void* ptr;
+    uint32_t size;
+};
+
+static WL_THREAD_LOCAL WlRecycledBlock g_recycled[WL_RECYCLE_SLOTS];
+static WL_THREAD_LOCAL uint32_t g_recycled_count = 0;
+
+static void* walink_recycle_take(uint32_t size, uint32_t* usable) noexcept {
+    uint32_t best = WL_RECYCLE_SLOTS;
+    for (uint32_t i = 0; i < g_recycled_count; ++i) {
+        const uint32_t block = g_recycled[i].size;
+        if (block >= size && block / 2 <= size &&
+            (best == WL_RECYCLE_SLOTS || block < g_recycled[best].size)) {
+            best = i;
+        }
+    }
+    if (best == WL_RECYCLE_SLOTS) {
+        return nullptr;
+    }
+    void* ptr = g_recycled[best].ptr;
+    *usable = g_recycled[best].size;
+    g_recycled[best] = g_recycled[--g_recycled_count];
+    return ptr;
 }
 
-WL_VALUE wl_from_uint32(uint32_t v) noexcept {
-    const uint32_t payload = v;
-    const uint32_t meta = wl_build_meta(WL_TAG_UINT32, /*is_address*/ false, /*free*/false, /*user*/false);
-    return wl_make(meta, payload);
+// When full, the smallest block (cheapest to allocate again) is dropped.
+static void walink_recycle_put(void* ptr, uint32_t size) noexcept {
+    if (size > WL_RECYCLE_MAX_BYTES) {
+        walink_free_ptr(ptr);
+        return;
+    }
+    if (g_recycled_count < WL_RECYCLE_SLOTS) {
+        g_recycled[g_recycled_count++] = {ptr, size};
+        return;
+    }
+    uint32_t smallest = 0;
+    for (uint32_t i = 1; i < WL_RECYCLE_SLOTS; ++i) {
+        if (g_recycled[i].size < g_recycled[smallest].size) {
+            smallest = i;
+        }
+    }
+    if (g_recycled[smallest].size >= size) {
+        walink_free_ptr(ptr);
+        return;
+    }
+    walink_free_ptr(g_recycled[smallest].ptr);
+    g_recycled[smallest] = {ptr, size};
 }
 
-uint32_t wl_to_uint32(WL_VALUE v) noexcept {
-    return wl_get_payload32(v);
-}
+// ---- Address-based factories (containers / float64) ---------------------
 
-WL_VALUE wl_from_float32(float f) noexcept {
-    uint32_t payload;
-    static_assert(sizeof(float) == sizeof(uint32_t), "float must be 32-bit");
-    memcpy(&payload, &f, sizeof(payload));
-    const uint32_t meta = wl_build_meta(WL_TAG_FLOAT32, /*is_address*/ false, /*free*/false, /*user*/false);
-    return wl_make(meta, payload);
-}
 
-float wl_to_float32(WL_VALUE v) noexcept {
-    uint32_t payload = wl_get_payload32(v);
-    float f;
-    memcpy(&f, &payload, sizeof(f));
-    return f;
+BaseContainer* wl_alloc_container(uint32_t meta, uint32_t size) noexcept {
+    // Allocate enough space for the header + payload
+    const uint32_t total = static_cast<uint32_t>(sizeof(BaseContainer) + size);
+    uint32_t usable = total;
+    void* raw = nullptr;
+    if (meta & WL_META_ARENA_FLAG) {
+        raw = wl_arena_alloc(total);
+    } else if (!(raw = walink_recycle_take(total, &usable))) {
+        raw = walink_alloc_ptr(total);
+    }
+    if (!raw) {
+        return nullptr;
+    }
+#if WALINK_STATS
+    if (!(meta & WL_META_ARENA_FLAG)) {
+        walink_stats_tag(raw, wl_stats_kind_of(meta & WL_META_TAG_MASK));
+    }
+#endif
+    auto* container = reinterpret_cast<BaseContainer*>(raw);
+    container->cap = usable - static_cast<uint32_t>(sizeof(BaseContainer));
+    container->size = 0;
+    return container;
 }
 
-WL_VALUE wl_from_sint32(int32_t v) noexcept {
-    const uint32_t payload = static_cast<uint32_t>(v);
-    const uint32_t meta = wl_build_meta(WL_TAG_SINT32, /*is_address*/ false, /*free*/false, /*user*/false);
-    return wl_make(meta, payload);
+void wl_recycle(WL_VALUE v) noexcept {
+    if (!wl_is_address(v) || wl_has_arena_flag(v) || wl_get_payload32(v) == 0) {
+        return;
+    }
+    if (!wl_is_container_tag(wl_get_tag(v))) {
+        ::walink_free(v);
+        return;
+    }
+    auto* c = reinterpret_cast<BaseContainer*>(static_cast<uintptr_t>(wl_get_payload32(v)));
+    if (!walink_stats_tag(c, WL_STATS_RECYCLED)) {
+        return; // not live: double free
+    }
+    const uint32_t cap = c->cap > UINT32_MAX - sizeof(BaseContainer) ? UINT32_MAX - sizeof(BaseContainer) : c->cap;
+    walink_recycle_put(c, static_cast<uint32_t>(sizeof(BaseContainer)) + cap);
 }
 
-int32_t wl_to_sint32(WL_VALUE v) noexcept {
-    return static_cast<int32_t>(wl_get_payload32(v));
+void wl_free_container(BaseContainer* c, uint32_t meta) noexcept {
+    if (!c || (meta & WL_META_ARENA_FLAG)) {
+        return;
+    }
+    walink_free_ptr(c);
 }
 
-// ---- Address-based factories (containers / float64) ---------------------
-
+BaseContainer* wl_grow_container(BaseContainer* c, uint32_t meta, uint32_t min_cap) noexcept {
+    const uint32_t cap = c ? c->cap : 0;
+    uint32_t new_cap = cap > UINT32_MAX / 2 ? UINT32_MAX - static_cast<uint32_t>(sizeof(BaseContainer)) : cap * 2;
+    if (new_cap < min_cap) {
+        new_cap = min_cap;
+    }
+    if (new_cap > UINT32_MAX - sizeof(BaseContainer)) {
+        return nullptr;
+    }
 
-BaseContainer* wl_alloc_container(uint32_t /*meta*/, uint32_t size) noexcept {
-    // Allocate enough space for the header + payload
-    void* raw = walink_alloc_ptr(static_cast<uint32_t>(sizeof(BaseContainer) + size));
-    if (!raw) {
+    BaseContainer* grown = wl_alloc_container(meta, new_cap);
+    if (!grown) {
         return nullptr;
     }
-    auto* container = reinterpret_cast<BaseContainer*>(raw);
-    container->cap = static_cast<uint32_t>(size);
-    container->size = 0;
-    return container;
+    if (c) {
+        grown->size = c->size;
+        memcpy(grown->data, c->data, c->size);
+        wl_free_container(c, meta);
+    }
+    return grown;
 }
 
-WL_VALUE wl_make_string(std::string_view sv, bool free_flag_for_receiver) noexcept {
-    uint32_t meta = wl_build_meta(WL_TAG_STRING, true, free_flag_for_receiver);
+static WL_VALUE wl_make_container(uint32_t meta, std::string_view sv) noexcept {
     BaseContainer* c = wl_alloc_container(meta, sv.size());
     if (!c) return 0;
     if (!sv.empty()) {
         c->size = static_cast<uint32_t>(sv.size());
         memcpy(c->data, sv.data(), sv.size());
     }
-    return wl_from_address(c, WL_TAG_STRING, free_flag_for_receiver);
+    return wl_make(meta, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(c)));
 }
 
-WL_VALUE wl_make_error(std::string_view msg) noexcept {
-    uint32_t meta = wl_build_meta(WL_TAG_ERROR, true, true);
-    BaseContainer* c = wl_alloc_container(meta, msg.size());
+// Sizes the container once for all segments, then copies each one.
+template <typename Segment>
+static WL_VALUE wl_make_gathered(uint32_t meta, std::span<const Segment> segments) noexcept {
+    size_t total = 0;
+    for (const auto& seg : segments) {
+        total += seg.size();
+    }
+    if (total > UINT32_MAX - sizeof(BaseContainer)) {
+        return 0;
+    }
+    BaseContainer* c = wl_alloc_container(meta, static_cast<uint32_t>(total));
     if (!c) return 0;
-    if (!msg.empty()) {
-        c->size = static_cast<uint32_t>(msg.size());
-        memcpy(c->data, msg.data(), msg.size());
+    uint8_t* out = c->data;
+    for (const auto& seg : segments) {
+        if (!seg.empty()) {
+            memcpy(out, seg.data(), seg.size());
+            out += seg.size();
+        }
     }
-    return wl_from_address(c, WL_TAG_ERROR, true);
+    c->size = static_cast<uint32_t>(total);
+    return wl_make(meta, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(c)));
+}
+
+WL_VALUE wl_make_string(std::string_view sv, bool free_flag_for_receiver) noexcept {
+    return wl_make_container(wl_owned_meta(WL_TAG_STRING, free_flag_for_receiver), sv);
+}
+
+WL_VALUE wl_make_string(std::span<const std::string_view> segments, bool free_flag_for_receiver) noexcept {
+    return wl_make_gathered(wl_owned_meta(WL_TAG_STRING, free_flag_for_receiver), segments);
+}
+
+WL_VALUE wl_make_error(std::string_view msg) noexcept {
+    return wl_make_container(wl_owned_meta(WL_TAG_ERROR, true), msg);
 }
 
 WL_VALUE wl_make_f64(double v, bool free_flag_for_receiver) noexcept {
-    void* raw = walink_alloc_ptr(static_cast<uint32_t>(sizeof(Float64Container)));
+    const uint32_t meta = wl_owned_meta(WL_TAG_FLOAT64, free_flag_for_receiver);
+    const uint32_t size = static_cast<uint32_t>(sizeof(Float64Container));
+    void* raw = (meta & WL_META_ARENA_FLAG) ? wl_arena_alloc(size) : walink_alloc_ptr(size);
     if (!raw) return 0;
+    if (!(meta & WL_META_ARENA_FLAG)) {
+        walink_stats_tag(raw, WL_STATS_SCALAR);
+    }
     auto* c = reinterpret_cast<Float64Container*>(raw);
     c->v = v;
-    return wl_from_address(c, WL_TAG_FLOAT64, free_flag_for_receiver);
+    return wl_make(meta, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(c)));
 }
  
 WL_VALUE wl_make_bytes(std::string_view sv, bool free_flag_for_receiver) noexcept {
-    const uint32_t meta = wl_build_meta(WL_TAG_BYTES, /*is_address*/ true, free_flag_for_receiver, /*user*/false);
-    BaseContainer* c = wl_alloc_container(meta, sv.size());
+    return wl_make_container(wl_owned_meta(WL_TAG_BYTES, free_flag_for_receiver), sv);
+}
+
+WL_VALUE wl_make_bytes(std::span<const std::string_view> segments, bool free_flag_for_receiver) noexcept {
+    return wl_make_gathered(wl_owned_meta(WL_TAG_BYTES, free_flag_for_receiver), segments);
+}
+
+WL_VALUE wl_make_bytes(std::span<const std::span<const uint8_t>> segments, bool free_flag_for_receiver) noexcept {
+    return wl_make_gathered(wl_owned_meta(WL_TAG_BYTES, free_flag_for_receiver), segments);
+}
+
+template <typename Segment>
+static WL_VALUE wl_make_iovec_of(bool free_flag_for_receiver, std::span<const Segment> segments) noexcept {
+    if (segments.size() > (UINT32_MAX - sizeof(BaseContainer) - 4) / 8) {
+        return 0;
+    }
+    const uint32_t count = static_cast<uint32_t>(segments.size());
+    const uint32_t meta = wl_owned_meta(WL_TAG_IOVEC, free_flag_for_receiver);
+    BaseContainer* c = wl_alloc_container(meta, 4 + count * 8);
     if (!c) return 0;
-    if (!sv.empty()) {
-        c->size = static_cast<uint32_t>(sv.size());
-        memcpy(c->data, sv.data(), sv.size());
+    uint32_t words[2] = {count, 0};
+    memcpy(c->data, words, 4);
+    for (uint32_t i = 0; i < count; ++i) {
+        words[0] = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(segments[i].data()));
+        words[1] = static_cast<uint32_t>(segments[i].size());
+        memcpy(c->data + 4 + i * 8, words, 8);
     }
-    return wl_from_address(c, WL_TAG_BYTES, free_flag_for_receiver);
+    c->size = 4 + count * 8;
+    return wl_make(meta, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(c)));
+}
+
+WL_VALUE wl_make_iovec(std::span<const std::span<const uint8_t>> segments, bool free_flag_for_receiver) noexcept {
+    return wl_make_iovec_of(free_flag_for_receiver, segments);
+}
+
+WL_VALUE wl_make_iovec(std::span<const std::string_view> segments, bool free_flag_for_receiver) noexcept {
+    return wl_make_iovec_of(free_flag_for_receiver, segments);
 }
  
 WL_VALUE wl_make_msgpack(std::string_view sv, bool free_flag_for_receiver) noexcept {
-    const uint32_t meta = wl_build_meta(WL_TAG_MSGPACK, /*is_address*/ true, free_flag_for_receiver, /*user*/false);
-    BaseContainer* c = wl_alloc_container(meta, sv.size());
+    return wl_make_container(wl_owned_meta(WL_TAG_MSGPACK, free_flag_for_receiver), sv);
+}
+  
+WL_VALUE wl_alloc_array(uint32_t tag,
+                        uint32_t elem_size,
+                        uint32_t count,
+                        bool free_flag_for_receiver,
+                        void** data) noexcept {
+    if (elem_size == 0 || count > (UINT32_MAX - sizeof(BaseContainer)) / elem_size) {
+        return 0;
+    }
+    const uint32_t meta = wl_owned_meta(tag, free_flag_for_receiver);
+    BaseContainer* c = wl_alloc_container(meta, count * elem_size);
     if (!c) return 0;
-    if (!sv.empty()) {
-        c->size = static_cast<uint32_t>(sv.size());
-        memcpy(c->data, sv.data(), sv.size());
+    c->size = count * elem_size;
+    *data = c->data;
+    return wl_make(meta, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(c)));
+}
+
+// ---- Allocation-free 64-bit scalars (scratch slots) ---------------------
+
+// [0]: wasm->host, [1]: host->wasm
+// Per thread in threaded builds, so a ring worker never races the host thread.
+alignas(8) static WL_THREAD_LOCAL uint64_t g_scratch_slots[2][WL_SCRATCH_SLOT_COUNT];
+static WL_THREAD_LOCAL uint32_t g_scratch_cursor = 0;
+
+uint64_t* wl_scratch_slot() noexcept {
+    uint64_t* slot = &g_scratch_slots[0][g_scratch_cursor];
+    g_scratch_cursor = (g_scratch_cursor + 1) % WL_SCRATCH_SLOT_COUNT;
+    return slot;
+}
+
+bool wl_is_scratch_slot(const void* p) noexcept {
+    const auto addr = reinterpret_cast<uintptr_t>(p);
+    const auto begin = reinterpret_cast<uintptr_t>(&g_scratch_slots[0][0]);
+    return addr >= begin && addr < begin + sizeof(g_scratch_slots);
+}
+
+WL_VALUE wl_detach_scalar64(WL_VALUE v) noexcept {
+    const uint32_t tag = wl_get_tag(v);
+    if (!wl_is_address(v) || (tag != WL_TAG_FLOAT64 && tag != WL_TAG_SINT64 && tag != WL_TAG_UINT64)) {
+        return v;
+    }
+    const void* slot = reinterpret_cast<const void*>(static_cast<uintptr_t>(wl_get_payload32(v)));
+    if (!wl_is_scratch_slot(slot)) {
+        return v;
+    }
+    const uint32_t meta = wl_owned_meta(tag, true);
+    void* raw = (meta & WL_META_ARENA_FLAG) ? wl_arena_alloc(sizeof(uint64_t)) : walink_alloc_ptr(sizeof(uint64_t));
+    if (!raw) return 0;
+    if (!(meta & WL_META_ARENA_FLAG)) {
+        walink_stats_tag(raw, WL_STATS_SCALAR);
     }
-    return wl_from_address(c, WL_TAG_MSGPACK, free_flag_for_receiver);
+    memcpy(raw, slot, sizeof(uint64_t));
+    return wl_make(meta, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(raw)));
 }
-  
+
 // Null value factory (tag = 0)
 WL_VALUE wl_null() noexcept {
     return wl_make(0u, 0u);
 }
  
-// ---- Converters ----------------------------------------------------------
-//
-// These helpers extract payloads from WL_VALUE. If `allow_free` is true and
-// the meta free-flag is set on the value, the underlying allocation is freed
-// by calling walink_free(v) before returning.
- 
-std::string wl_to_string(WL_VALUE v, bool allow_free) {
-    // Strict: only accept a value whose tag is exactly WL_TAG_STRING and is address-based.
-    const uint32_t tag = wl_get_tag(v);
-    if (!wl_is_address(v) || tag != WL_TAG_STRING) {
-        throw std::runtime_error("wl_to_string: expected address-based STRING tag");
+// ---- Non-throwing converters ----------------------------------------------
+
+static bool wl_should_free(WL_VALUE v, bool allow_free) noexcept {
+    return allow_free && wl_has_free_flag(v);
+}
+
+static bool wl_is_tagged_address(WL_VALUE v, uint32_t tag) noexcept {
+    return wl_is_address(v) && wl_get_tag(v) == tag;
+}
+
+Result<std::span<const uint8_t>> wl_try_view_base_container(WL_VALUE v) noexcept {
+    if (!wl_is_address(v)) {
+        return Error{Errc::type_mismatch, "wl_view_base_container: expected address-based tag"};
     }
 
     const uint32_t payload = wl_get_payload32(v);
-    auto* c = reinterpret_cast<BaseContainer*>(static_cast<uintptr_t>(payload));
+    auto* c = reinterpret_cast<const BaseContainer*>(static_cast<uintptr_t>(payload));
     if (!c) {
-        throw std::runtime_error("wl_to_string: null container");
+        return Error{Errc::null_address, "wl_view_base_container: null container"};
     }
+    return std::span<const uint8_t>(c->data, c->size);
+}
 
-    std::string out;
-    if (c->size) {
-        out.assign(reinterpret_cast<const char*>(c->data), c->size);
+Result<std::string_view> wl_try_view_string(WL_VALUE v) noexcept {
+    // Strict: only accept a value whose tag is exactly WL_TAG_STRING and is address-based.
+    if (!wl_is_tagged_address(v, WL_TAG_STRING)) {
+        return Error{Errc::type_mismatch, "wl_view_string: expected address-based STRING tag"};
     }
+    auto data = wl_try_view_base_container(v);
+    if (!data) {
+        return data.error();
+    }
+    return std::string_view(reinterpret_cast<const char*>(data->data()), data->size());
+}
 
-    if (allow_free) {
-        const uint32_t meta = wl_get_meta(v);
-        if (meta & WL_META_FREE_FLAG) {
-            ::walink_free(v);
-        }
+Result<std::span<const uint8_t>> wl_try_view_bytes(WL_VALUE v) noexcept {
+    if (!wl_is_tagged_address(v, WL_TAG_BYTES)) {
+        return Error{Errc::type_mismatch, "wl_view_bytes: expected address-based BYTES tag"};
     }
-    return out;
+    return wl_try_view_base_container(v);
 }
 
-std::string wl_read_base_container(WL_VALUE v, bool allow_free) {
-    const uint32_t tag = wl_get_tag(v);
-    if (!wl_is_address(v)) {
-        throw std::runtime_error("wl_to_bytes: expected address-based tag");
+Result<std::span<const uint8_t>> wl_try_view_msgpack(WL_VALUE v) noexcept {
+    if (!wl_is_tagged_address(v, WL_TAG_MSGPACK)) {
+        return Error{Errc::type_mismatch, "wl_view_msgpack: expected address-based MSGPACK tag"};
     }
+    return wl_try_view_base_container(v);
+}
 
-    const uint32_t payload = wl_get_payload32(v);
-    auto* c = reinterpret_cast<BaseContainer*>(static_cast<uintptr_t>(payload));
-    if (!c) {
-        throw std::runtime_error("wl_to_bytes: null container");
+Result<std::span<const uint8_t>> wl_try_view_array_bytes(WL_VALUE v, uint32_t tag) noexcept {
+    if (!wl_is_tagged_address(v, tag)) {
+        return Error{Errc::type_mismatch, "wl_view_array: array tag mismatch"};
     }
+    return wl_try_view_base_container(v);
+}
 
-    std::string out;
-    if (c->size) {
-        out.assign(reinterpret_cast<const char*>(c->data), c->size);
+static Result<ContainerRef> wl_try_borrow(Result<std::span<const uint8_t>> data, WL_VALUE v, bool allow_free) noexcept {
+    if (!data) {
+        return data.error();
     }
+    return ContainerRef(v, *data, wl_should_free(v, allow_free));
+}
 
-    if (allow_free) {
-        const uint32_t meta = wl_get_meta(v);
-        if (meta & WL_META_FREE_FLAG) {
-            ::walink_free(v);
-        }
+// STRING16 argument -> owned UTF-8 STRING container.
+static Result<ContainerRef> wl_try_borrow_string16(WL_VALUE v, bool allow_free) noexcept {
+    const auto units = wl_try_view_base_container(v);
+    if (!units) {
+        return units.error();
+    }
+    const std::u16string_view utf16(reinterpret_cast<const char16_t*>(units->data()), units->size() / 2);
+    const uint32_t meta = wl_owned_meta(WL_TAG_STRING, /*free_flag_for_receiver*/ true);
+    BaseContainer* c = wl_alloc_container(meta, static_cast<uint32_t>(wl_utf8_length(utf16)));
+    if (c) {
+        c->size = wl_utf16_to_utf8(utf16, c->data);
+    }
+    if (wl_should_free(v, allow_free)) {
+        ::walink_free(v);
+    }
+    if (!c) {
+        return Error{Errc::out_of_memory, "wl_borrow_string: out of memory transcoding STRING16"};
     }
-    return out;
+    const WL_VALUE owned = wl_make(meta, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(c)));
+    return ContainerRef(owned, {c->data, c->size}, true);
 }
 
-std::string wl_to_bytes(WL_VALUE v, bool allow_free) {
-    // Strict: only accept a value whose tag is exactly WL_TAG_BYTES and is address-based.
-    const uint32_t tag = wl_get_tag(v);
-    if (!wl_is_address(v) || tag != WL_TAG_BYTES) {
-        throw std::runtime_error("wl_to_bytes: expected address-based BYTES tag");
+Result<ContainerRef> wl_try_borrow_string(WL_VALUE v, bool allow_free) noexcept {
+    if (wl_is_tagged_address(v, WL_TAG_STRING16)) {
+        return wl_try_borrow_string16(v, allow_free);
+    }
+    auto sv = wl_try_view_string(v);
+    if (!sv) {
+        return sv.error();
     }
-    return wl_read_base_container(v, allow_free);
+    return ContainerRef(v, {reinterpret_cast<const uint8_t*>(sv->data()), sv->size()}, wl_should_free(v, allow_free));
 }
- 
-std::string wl_to_msgpack(WL_VALUE v, bool allow_free) {
-    // Strict: only accept MSGPACK tag.
-    const uint32_t tag = wl_get_tag(v);
-    if (!wl_is_address(v) || tag != WL_TAG_MSGPACK) {
-        throw std::runtime_error("wl_to_msgpack: expected address-based MSGPACK tag");
+
+Result<ContainerRef> wl_try_borrow_bytes(WL_VALUE v, bool allow_free) noexcept {
+    return wl_try_borrow(wl_try_view_bytes(v), v, allow_free);
+}
+
+Result<ContainerRef> wl_try_borrow_msgpack(WL_VALUE v, bool allow_free) noexcept {
+    return wl_try_borrow(wl_try_view_msgpack(v), v, allow_free);
+}
+
+Result<ContainerRef> wl_try_borrow_base_container(WL_VALUE v, bool allow_free) noexcept {
+    return wl_try_borrow(wl_try_view_base_container(v), v, allow_free);
+}
+
+static Result<std::string> wl_try_copy(Result<ContainerRef> ref) {
+    if (!ref) {
+        return ref.error();
     }
-    return wl_read_base_container(v, allow_free);
+    return std::string(ref->str());
 }
- 
-double wl_to_f64(WL_VALUE v, bool allow_free) {
-    // Strict: only accept a value whose tag is exactly WL_TAG_FLOAT64 and is address-based.
-    const uint32_t tag = wl_get_tag(v);
-    if (!wl_is_address(v) || tag != WL_TAG_FLOAT64) {
-        throw std::runtime_error("wl_to_f64: expected address-based FLOAT64 tag");
+
+Result<std::string> wl_try_to_string(WL_VALUE v, bool allow_free) {
+    if (!wl_is_tagged_address(v, WL_TAG_STRING) && !wl_is_tagged_address(v, WL_TAG_STRING16)) {
+        return Error{Errc::type_mismatch, "wl_to_string: expected address-based STRING tag"};
     }
+    return wl_try_copy(wl_try_borrow_string(v, allow_free));
+}
 
-    const uint32_t payload = wl_get_payload32(v);
-    auto* f = reinterpret_cast<Float64Container*>(static_cast<uintptr_t>(payload));
-    if (!f) {
-        throw std::runtime_error("wl_to_f64: null Float64Container");
+Result<std::string> wl_try_to_bytes(WL_VALUE v, bool allow_free) {
+    if (!wl_is_tagged_address(v, WL_TAG_BYTES)) {
+        return Error{Errc::type_mismatch, "wl_to_bytes: expected address-based BYTES tag"};
     }
-    double result = f->v;
+    return wl_try_copy(wl_try_borrow_base_container(v, allow_free));
+}
 
-    if (allow_free) {
-        const uint32_t meta = wl_get_meta(v);
-        if (meta & WL_META_FREE_FLAG) {
-            ::walink_free(v);
-        }
+Result<std::string> wl_try_to_msgpack(WL_VALUE v, bool allow_free) {
+    if (!wl_is_tagged_address(v, WL_TAG_MSGPACK)) {
+        return Error{Errc::type_mismatch, "wl_to_msgpack: expected address-based MSGPACK tag"};
     }
+    return wl_try_copy(wl_try_borrow_base_container(v, allow_free));
+}
 
+// Reads a 64-bit scalar (scratch slot or Float64Container) and releases it
+// if the receiver owns it.
+template <typename T>
+static Result<T> wl_try_read_scalar64(WL_VALUE v, bool allow_free, const char* mismatch, const char* null) noexcept {
+    if (!wl_is_tagged_address(v, codec<T>::tag)) {
+        return Error{Errc::type_mismatch, mismatch};
+    }
+    if (wl_get_payload32(v) == 0) {
+        return Error{Errc::null_address, null};
+    }
+    const T result = codec<T>::decode(v);
+    if (wl_should_free(v, allow_free)) {
+        ::walink_free(v);
+    }
     return result;
 }
- 
+
+Result<double> wl_try_to_f64(WL_VALUE v, bool allow_free) noexcept {
+    return wl_try_read_scalar64<double>(v, allow_free,
+                                        "wl_to_f64: expected address-based FLOAT64 tag",
+                                        "wl_to_f64: null Float64Container");
+}
+
+Result<int64_t> wl_try_to_sint64(WL_VALUE v, bool allow_free) noexcept {
+    return wl_try_read_scalar64<int64_t>(v, allow_free,
+                                         "wl_to_sint64: expected address-based SINT64 tag",
+                                         "wl_to_sint64: null int64 slot");
+}
+
+Result<uint64_t> wl_try_to_uint64(WL_VALUE v, bool allow_free) noexcept {
+    return wl_try_read_scalar64<uint64_t>(v, allow_free,
+                                          "wl_to_uint64: expected address-based UINT64 tag",
+                                          "wl_to_uint64: null uint64 slot");
+}
+
+WL_VALUE wl_make_error(const Error& err) noexcept {
+    return wl_make_error(std::string_view(err.message ? err.message : "walink: unknown error"));
+}
+
+// ---- Throwing converters ---------------------------------------------------
+//
+// Thin wrappers over the wl_try_* functions above; the error message becomes
+// the std::runtime_error text.
+
+template <typename T>
+static T wl_unwrap(Result<T>&& r) {
+    if (!r) {
+        throw std::runtime_error(r.error().message);
+    }
+    return std::move(*r);
+}
+
+std::span<const uint8_t> wl_view_base_container(WL_VALUE v) {
+    return wl_unwrap(wl_try_view_base_container(v));
+}
+
+std::string_view wl_view_string(WL_VALUE v) {
+    return wl_unwrap(wl_try_view_string(v));
+}
+
+std::span<const uint8_t> wl_view_bytes(WL_VALUE v) {
+    return wl_unwrap(wl_try_view_bytes(v));
+}
+
+std::span<const uint8_t> wl_view_msgpack(WL_VALUE v) {
+    return wl_unwrap(wl_try_view_msgpack(v));
+}
+
+std::span<const uint8_t> wl_view_array_bytes(WL_VALUE v, uint32_t tag) {
+    return wl_unwrap(wl_try_view_array_bytes(v, tag));
+}
+
+void ContainerRef::reset() noexcept {
+    if (owns_) {
+        owns_ = false;
+        wl_recycle(value_);
+    }
+    value_ = 0;
+    data_ = {};
+}
+
+ContainerRef wl_borrow_string(WL_VALUE v, bool allow_free) {
+    return wl_unwrap(wl_try_borrow_string(v, allow_free));
+}
+
+ContainerRef wl_borrow_bytes(WL_VALUE v, bool allow_free) {
+    return wl_unwrap(wl_try_borrow_bytes(v, allow_free));
+}
+
+ContainerRef wl_borrow_msgpack(WL_VALUE v, bool allow_free) {
+    return wl_unwrap(wl_try_borrow_msgpack(v, allow_free));
+}
+
+ContainerRef wl_borrow_base_container(WL_VALUE v, bool allow_free) {
+    return wl_unwrap(wl_try_borrow_base_container(v, allow_free));
+}
+
+// These helpers extract payloads from WL_VALUE. If `allow_free` is true and
+// the meta free-flag is set on the value, the underlying allocation is freed
+// by calling walink_free(v) before returning.
+
+std::string wl_to_string(WL_VALUE v, bool allow_free) {
+    return wl_unwrap(wl_try_to_string(v, allow_free));
+}
+
+std::string wl_read_base_container(WL_VALUE v, bool allow_free) {
+    return std::string(wl_borrow_base_container(v, allow_free).str());
+}
+
+std::string wl_to_bytes(WL_VALUE v, bool allow_free) {
+    return wl_unwrap(wl_try_to_bytes(v, allow_free));
+}
+
+std::string wl_to_msgpack(WL_VALUE v, bool allow_free) {
+    return wl_unwrap(wl_try_to_msgpack(v, allow_free));
+}
+
+double wl_to_f64(WL_VALUE v, bool allow_free) {
+    return wl_unwrap(wl_try_to_f64(v, allow_free));
+}
+
+int64_t wl_to_sint64(WL_VALUE v, bool allow_free) {
+    return wl_unwrap(wl_try_to_sint64(v, allow_free));
+}
+
+uint64_t wl_to_uint64(WL_VALUE v, bool allow_free) {
+    return wl_unwrap(wl_try_to_uint64(v, allow_free));
+}
+
 } // namespace walink
 
 extern "C" {
 
 WL_VALUE walink_alloc(uint32_t size) noexcept {
-    // Allocate exactly `size` bytes and return a WL_VALUE whose payload is the
-    // data pointer (caller-visible start of the allocation).
-    char* raw = reinterpret_cast<char*>(walink_alloc_ptr(size));
+    // Allocate at least `size` bytes (a recycled block may be larger) and
+    // return a WL_VALUE whose payload is the data pointer (caller-visible
+    // start of the allocation).
+    uint32_t usable = size;
+    void* block = walink::walink_recycle_take(size, &usable);
+    char* raw = reinterpret_cast<char*>(block ? block : walink_alloc_ptr(size));
     if (!raw) {
         return 0;
     }
+    if (block) {
+        walink_stats_tag(block, WL_STATS_HOST);
+    }
 
     const uint32_t payload = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(raw));
     return walink::wl_make(0, payload);
 }
 
+WL_VALUE walink_scratch_slots() noexcept {
+    const uint32_t payload =
+        static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&walink::g_scratch_slots[1][0]));
+    return walink::wl_make(0, payload);
+}
+
+WL_VALUE walink_memory_generation() noexcept {
+#if defined(__wasm__)
+    return walink::wl_from_uint32(static_cast<uint32_t>(__builtin_wasm_memory_size(0)));
+#else
+    return walink::wl_from_uint32(0);
+#endif
+}
+
+WL_VALUE walink_reserve(uint32_t bytes) noexcept {
+#if defined(__EMSCRIPTEN__)
+    // malloc grows memory only when sbrk moves the break past its end, so
+    // memory reaching `bytes` beyond the break absorbs that much heap growth.
+    const uint64_t want = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(sbrk(0))) + bytes;
+    if (want > UINT32_MAX) {
+        return 0;
+    }
+    if (want > emscripten_get_heap_size() && !emscripten_resize_heap(static_cast<size_t>(want))) {
+        return 0;
+    }
+#else
+    (void)bytes;
+#endif
+    return walink_memory_generation();
+}
+
 // Deallocate containers referenced by address-based WL_VALUEs.
 WL_VALUE walink_free(WL_VALUE value) {
     const uint32_t tag = walink::wl_get_tag(value);
  
     // Only address-based tags are valid here; ignore otherwise.
     if (!walink::wl_is_address(value)) {
+#if WALINK_STATS
+        walink::wl_stats_on_invalid_free();
+#endif
+        return walink::wl_from_bool(false);
+    }
+
+    // Arena-owned values are released in bulk by walink_arena_reset.
+    if (walink::wl_has_arena_flag(value)) {
         return walink::wl_from_bool(false);
     }
  
     // walink_alloc returns the data pointer as the payload; free that pointer.
     const uint32_t payload = walink::wl_get_payload32(value);
     void* ptr = reinterpret_cast<void*>(static_cast<uintptr_t>(payload));
-    free(ptr);
- 
+    // FLOAT64/SINT64/UINT64 scratch-slot values point into static storage.
+    // wl_recycle and walink_free_many end up here too.
+    if (walink::wl_is_scratch_slot(ptr)) {
+#if WALINK_STATS
+        walink::wl_stats_on_invalid_free();
+#endif
+        return walink::wl_from_bool(false);
+    }
+#if WALINK_STATS
+    // a block parked by walink_recycle belongs to the cache now
+    if (ptr && walink_stats_header(ptr)->magic == kStatsLiveMagic &&
+        walink_stats_header(ptr)->kind == WL_STATS_RECYCLED) {
+        walink::wl_stats_on_bad_free();
+        return walink::wl_from_bool(false);
+    }
+#endif
+    return walink::wl_from_bool(walink_free_ptr(ptr));
+}
+
+WL_VALUE walink_recycle(WL_VALUE value) noexcept {
+    if (!walink::wl_is_address(value) || walink::wl_has_arena_flag(value)) {
+        return walink::wl_from_bool(false);
+    }
+    walink::wl_recycle(value);
     return walink::wl_from_bool(true);
 }
 
-} // extern "C"
\ No newline at end of file
+WL_VALUE walink_free_many(WL_VALUE values, uint32_t recycle) noexcept {
+    if (!walink::wl_is_address(values) || walink::wl_get_tag(values) != WL_TAG_ARRAY_UINT64) {
+        return walink::wl_make_error("walink_free_many: expected an ARRAY_UINT64 container");
+    }
+    auto* list = reinterpret_cast<BaseContainer*>(static_cast<uintptr_t>(walink::wl_get_payload32(values)));
+    if (!list) {
+        return walink::wl_make_error("walink_free_many: null container");
+    }
+    const uint32_t count = list->size / static_cast<uint32_t>(sizeof(WL_VALUE));
+    for (uint32_t i = 0; i < count; ++i) {
+        WL_VALUE v;
+        memcpy(&v, list->data + i * sizeof(WL_VALUE), sizeof(v));
+        if (recycle) {
+            walink_recycle(v);
+        } else {
+            walink_free(v);
+        }
+    }
+    // emptied in place, so the host can keep refilling the same list
+    list->size = 0;
+    return walink::wl_from_uint32(count);
+}
+
+} // extern "C"
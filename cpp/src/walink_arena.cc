@@ -0,0 +1,145 @@
+#include "walink.h"
+
+#include <stdlib.h>
+
+// Per-call bump allocator.
+//
+// Memory is carved from a list of fixed-size chunks that are kept across
+// resets, so a steady-state request loop stops touching malloc entirely.
+// Requests larger than a quarter chunk get a dedicated block which is
+// returned to the heap on reset.
+
+namespace {
+
+constexpr uint32_t kArenaChunkSize = 64u * 1024u;
+constexpr uint32_t kArenaLargeThreshold = kArenaChunkSize / 4u;
+
+struct alignas(8) ArenaChunk {
+    ArenaChunk* next;
+    uint32_t cap;
+    uint32_t used;
+
+    uint8_t* data() noexcept {
+        return reinterpret_cast<uint8_t*>(this + 1);
+    }
+};
+
+// One arena per thread in threaded builds; arena mode is per thread too.
+WL_THREAD_LOCAL ArenaChunk* g_arena_head = nullptr;
+WL_THREAD_LOCAL ArenaChunk* g_arena_current = nullptr;
+WL_THREAD_LOCAL ArenaChunk* g_arena_large = nullptr;
+WL_THREAD_LOCAL bool g_arena_enabled = false;
+
+ArenaChunk* arena_new_chunk(uint32_t cap) noexcept {
+    void* raw = malloc(sizeof(ArenaChunk) + cap);
+    if (!raw) {
+        return nullptr;
+    }
+    auto* chunk = static_cast<ArenaChunk*>(raw);
+    chunk->next = nullptr;
+    chunk->cap = cap;
+    chunk->used = 0;
+    return chunk;
+}
+
+} // namespace
+
+namespace walink {
+
+void* wl_arena_alloc(uint32_t size) noexcept {
+    const uint32_t aligned = (size + 7u) & ~7u;
+    if (aligned < size) {
+        return nullptr;
+    }
+
+    if (aligned > kArenaLargeThreshold) {
+        ArenaChunk* block = arena_new_chunk(aligned);
+        if (!block) {
+            return nullptr;
+        }
+        block->used = aligned;
+        block->next = g_arena_large;
+        g_arena_large = block;
+        return block->data();
+    }
+
+    ArenaChunk* chunk = g_arena_current;
+    while (chunk && chunk->cap - chunk->used < aligned) {
+        // Chunks after the current one were emptied by the last reset.
+        chunk = chunk->next;
+    }
+    if (!chunk) {
+        chunk = arena_new_chunk(kArenaChunkSize);
+        if (!chunk) {
+            return nullptr;
+        }
+        if (g_arena_current) {
+            chunk->next = g_arena_current->next;
+            g_arena_current->next = chunk;
+        } else {
+            g_arena_head = chunk;
+        }
+    }
+    g_arena_current = chunk;
+
+    uint8_t* ptr = chunk->data() + chunk->used;
+    chunk->used += aligned;
+    return ptr;
+}
+
+void wl_arena_reset() noexcept {
+    for (ArenaChunk* chunk = g_arena_head; chunk; chunk = chunk->next) {
+        if (chunk->used == 0) {
+            break;
+        }
+        chunk->used = 0;
+    }
+    g_arena_current = g_arena_head;
+
+    ArenaChunk* large = g_arena_large;
+    while (large) {
+        ArenaChunk* next = large->next;
+        free(large);
+        large = next;
+    }
+    g_arena_large = nullptr;
+}
+
+bool wl_arena_enabled() noexcept {
+    return g_arena_enabled;
+}
+
+bool wl_arena_set_enabled(bool enabled) noexcept {
+    const bool prev = g_arena_enabled;
+    g_arena_enabled = enabled;
+    return prev;
+}
+
+uint32_t wl_owned_meta(uint32_t tag, bool free_flag_for_receiver) noexcept {
+    const bool arena = free_flag_for_receiver && g_arena_enabled;
+    return wl_build_meta(tag, /*is_address*/ true, free_flag_for_receiver && !arena, /*user*/false, arena);
+}
+
+} // namespace walink
+
+extern "C" {
+
+WL_VALUE walink_arena_alloc(uint32_t size) noexcept {
+    void* raw = walink::wl_arena_alloc(size);
+    if (!raw) {
+        return 0;
+    }
+    const uint32_t payload = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(raw));
+    return walink::wl_make(0, payload);
+}
+
+WL_VALUE walink_arena_reset() noexcept {
+    walink::wl_arena_reset();
+    return walink::wl_null();
+}
+
+WL_VALUE walink_arena_enable(uint32_t enabled) noexcept {
+    return walink::wl_from_bool(walink::wl_arena_set_enabled(enabled != 0));
+}
+
+} // extern "C"
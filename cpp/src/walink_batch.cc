@@ -0,0 +1,86 @@
+#include "walink.h"
+
+namespace {
+
+walink::wl_batch_fn g_batch_functions[walink::WL_BATCH_MAX_FUNCTIONS];
+
+struct BatchRecordHeader {
+    uint32_t fn_id;
+    uint32_t argc;
+};
+
+BaseContainer* batch_container(WL_VALUE v) noexcept {
+    if (!walink::wl_is_address(v)) {
+        return nullptr;
+    }
+    return reinterpret_cast<BaseContainer*>(static_cast<uintptr_t>(walink::wl_get_payload32(v)));
+}
+
+} // namespace
+
+namespace walink {
+
+bool wl_batch_register(uint32_t fn_id, wl_batch_fn fn) noexcept {
+    if (fn_id >= WL_BATCH_MAX_FUNCTIONS || !fn || g_batch_functions[fn_id]) {
+        return false;
+    }
+    g_batch_functions[fn_id] = fn;
+    return true;
+}
+
+wl_batch_fn wl_batch_lookup(uint32_t fn_id) noexcept {
+    if (fn_id >= WL_BATCH_MAX_FUNCTIONS) {
+        return nullptr;
+    }
+    return g_batch_functions[fn_id];
+}
+
+} // namespace walink
+
+extern "C" {
+
+WL_VALUE walink_call_batch(WL_VALUE calls, WL_VALUE results) {
+    const BaseContainer* in = batch_container(calls);
+    BaseContainer* out = batch_container(results);
+    if (!in || !out) {
+        return walink::wl_make_error("walink_call_batch: expected address-based containers");
+    }
+
+    const uint8_t* cursor = in->data;
+    const uint8_t* const end = in->data + in->size;
+    auto* out_values = reinterpret_cast<WL_VALUE*>(out->data);
+    const uint32_t out_max = out->cap / sizeof(WL_VALUE);
+    uint32_t count = 0;
+    out->size = 0;
+
+    while (cursor < end) {
+        if (static_cast<size_t>(end - cursor) < sizeof(BatchRecordHeader)) {
+            return walink::wl_make_error("walink_call_batch: truncated record header");
+        }
+        BatchRecordHeader hdr;
+        memcpy(&hdr, cursor, sizeof(hdr));
+        cursor += sizeof(hdr);
+
+        if (static_cast<size_t>(end - cursor) / sizeof(WL_VALUE) < hdr.argc) {
+            return walink::wl_make_error("walink_call_batch: truncated record arguments");
+        }
+        if (count >= out_max) {
+            return walink::wl_make_error("walink_call_batch: results container too small");
+        }
+
+        const auto* args = reinterpret_cast<const WL_VALUE*>(cursor);
+        cursor += static_cast<size_t>(hdr.argc) * sizeof(WL_VALUE);
+
+        const walink::wl_batch_fn fn = walink::wl_batch_lookup(hdr.fn_id);
+        // scratch slots only hold the last WL_SCRATCH_SLOT_COUNT scalars,
+        // while the host reads the results after the whole batch
+        out_values[count++] = fn
+            ? walink::wl_detach_scalar64(fn(args, hdr.argc))
+            : walink::wl_make_error("walink_call_batch: unknown function id");
+        out->size = count * static_cast<uint32_t>(sizeof(WL_VALUE));
+    }
+
+    return walink::wl_from_uint32(count);
+}
+
+} // extern "C"
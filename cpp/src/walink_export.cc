@@ -0,0 +1,64 @@
+#include "walink_export.h"
+#include "walink_msgpack.h"
+
+// Registry behind WL_EXPORT. Entries are appended by static initializers, so
+// the host must run _initialize before calling walink_manifest.
+
+namespace {
+
+walink::ExportInfo* g_export_head = nullptr;
+walink::ExportInfo* g_export_tail = nullptr;
+uint32_t g_export_count = 0;
+
+} // namespace
+
+namespace walink {
+
+uint32_t wl_export_register(ExportInfo* info) noexcept {
+    info->next = nullptr;
+    info->id = g_export_count;
+    if (g_export_tail) {
+        g_export_tail->next = info;
+    } else {
+        g_export_head = info;
+    }
+    g_export_tail = info;
+    return g_export_count++;
+}
+
+const ExportInfo* wl_export_first() noexcept {
+    return g_export_head;
+}
+
+const ExportInfo* wl_export_find(std::string_view name) noexcept {
+    for (const ExportInfo* info = g_export_head; info; info = info->next) {
+        if (name == info->name) {
+            return info;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace walink
+
+extern "C" {
+
+WL_VALUE walink_manifest() noexcept {
+    walink::msgpack::Writer w;
+    w.write_array_header(g_export_count);
+    for (const walink::ExportInfo* info = g_export_head; info; info = info->next) {
+        w.write_map_header(3);
+        w.write_str("name").write_str(info->name);
+        w.write_str("params").write_array_header(info->argc);
+        for (uint32_t i = 0; i < info->argc; ++i) {
+            w.write_uint(info->param_tags[i]);
+        }
+        w.write_str("result").write_uint(info->result_tag);
+    }
+    if (!w.ok()) {
+        return walink::wl_make_error("walink_manifest: out of memory");
+    }
+    return w.finish();
+}
+
+} // extern "C"
@@ -0,0 +1,178 @@
+#include "walink_handle.h"
+
+#include <stdlib.h>
+
+#if WALINK_THREADS
+#include <mutex>
+#endif
+
+// Slot table behind WL_TAG_HANDLE.
+//
+// Slots live in fixed pages that never move, and free slots are chained
+// through `next_free`, so create/release are O(1). The table is shared by all
+// threads (a handle may be released by another worker), so threaded builds
+// serialize access with one mutex.
+
+namespace {
+
+constexpr uint32_t kHandlePageBits = 10;
+constexpr uint32_t kHandlePageSize = 1u << kHandlePageBits;
+constexpr uint32_t kHandleMaxPages = (WL_HANDLE_MAX_OBJECTS + kHandlePageSize - 1) / kHandlePageSize;
+constexpr uint32_t kHandleGenMask = (1u << (32 - WL_HANDLE_INDEX_BITS)) - 1;
+constexpr uint32_t kHandleNoSlot = UINT32_MAX;
+
+struct HandleSlot {
+    void* obj;
+    const walink::WlHandleType* type; // nullptr: free
+    uint32_t refs;
+    uint32_t gen;
+    uint32_t next_free;
+};
+
+HandleSlot* g_handle_pages[kHandleMaxPages];
+uint32_t g_handle_slot_count = 0; // slots ever handed out
+uint32_t g_handle_free = kHandleNoSlot;
+uint32_t g_handle_live = 0;
+
+#if WALINK_THREADS
+std::mutex g_handle_mutex;
+#define WL_HANDLE_LOCK() std::lock_guard<std::mutex> wl_handle_lock_(g_handle_mutex)
+#else
+#define WL_HANDLE_LOCK() (void)0
+#endif
+
+inline HandleSlot& slot_at(uint32_t index) noexcept {
+    return g_handle_pages[index >> kHandlePageBits][index & (kHandlePageSize - 1)];
+}
+
+inline WL_VALUE make_handle(uint32_t index, uint32_t gen) noexcept {
+    const uint32_t payload = (gen << WL_HANDLE_INDEX_BITS) | (index + 1);
+    return walink::wl_make(walink::wl_build_meta(WL_TAG_HANDLE, /*is_address*/ false), payload);
+}
+
+// Live slot for `h`, or nullptr. Caller holds the lock.
+HandleSlot* find_slot(WL_VALUE h) noexcept {
+    if (walink::wl_is_address(h) || walink::wl_get_tag(h) != WL_TAG_HANDLE) {
+        return nullptr;
+    }
+    const uint32_t payload = walink::wl_get_payload32(h);
+    const uint32_t index1 = payload & WL_HANDLE_INDEX_MASK;
+    if (index1 == 0 || index1 > g_handle_slot_count) {
+        return nullptr;
+    }
+    HandleSlot& slot = slot_at(index1 - 1);
+    if (!slot.type || slot.gen != (payload >> WL_HANDLE_INDEX_BITS)) {
+        return nullptr;
+    }
+    return &slot;
+}
+
+uint32_t alloc_slot() noexcept {
+    if (g_handle_free != kHandleNoSlot) {
+        const uint32_t index = g_handle_free;
+        g_handle_free = slot_at(index).next_free;
+        return index;
+    }
+    if (g_handle_slot_count == WL_HANDLE_MAX_OBJECTS) {
+        return kHandleNoSlot;
+    }
+    const uint32_t page = g_handle_slot_count >> kHandlePageBits;
+    if (!g_handle_pages[page]) {
+        g_handle_pages[page] = static_cast<HandleSlot*>(calloc(kHandlePageSize, sizeof(HandleSlot)));
+        if (!g_handle_pages[page]) {
+            return kHandleNoSlot;
+        }
+    }
+    return g_handle_slot_count++;
+}
+
+} // namespace
+
+namespace walink {
+
+WL_VALUE wl_handle_create(void* obj, const WlHandleType* type) noexcept {
+    if (!obj || !type) {
+        return 0;
+    }
+    {
+        WL_HANDLE_LOCK();
+        const uint32_t index = alloc_slot();
+        if (index != kHandleNoSlot) {
+            HandleSlot& slot = slot_at(index);
+            slot.obj = obj;
+            slot.type = type;
+            slot.refs = 1;
+            ++g_handle_live;
+            return make_handle(index, slot.gen);
+        }
+    }
+    type->destroy(obj);
+    return 0;
+}
+
+void* wl_handle_lookup(WL_VALUE h, const WlHandleType* type) noexcept {
+    WL_HANDLE_LOCK();
+    HandleSlot* slot = find_slot(h);
+    return slot && slot->type == type ? slot->obj : nullptr;
+}
+
+bool wl_handle_retain(WL_VALUE h) noexcept {
+    WL_HANDLE_LOCK();
+    HandleSlot* slot = find_slot(h);
+    if (!slot) {
+        return false;
+    }
+    ++slot->refs;
+    return true;
+}
+
+bool wl_handle_release(WL_VALUE h) noexcept {
+    void* obj;
+    const WlHandleType* type;
+    {
+        WL_HANDLE_LOCK();
+        HandleSlot* slot = find_slot(h);
+        if (!slot) {
+            return false;
+        }
+        if (--slot->refs != 0) {
+            return true;
+        }
+        obj = slot->obj;
+        type = slot->type;
+        slot->obj = nullptr;
+        slot->type = nullptr;
+        slot->gen = (slot->gen + 1) & kHandleGenMask;
+        const uint32_t index = (wl_get_payload32(h) & WL_HANDLE_INDEX_MASK) - 1;
+        slot->next_free = g_handle_free;
+        g_handle_free = index;
+        --g_handle_live;
+    }
+    // Outside the lock: a destructor may release other handles.
+    type->destroy(obj);
+    return true;
+}
+
+uint32_t wl_handle_count() noexcept {
+    WL_HANDLE_LOCK();
+    return g_handle_live;
+}
+
+} // namespace walink
+
+extern "C" {
+
+WL_VALUE walink_handle_retain(WL_VALUE handle) noexcept {
+    return walink::wl_from_bool(walink::wl_handle_retain(handle));
+}
+
+WL_VALUE walink_handle_release(WL_VALUE handle) noexcept {
+    return walink::wl_from_bool(walink::wl_handle_release(handle));
+}
+
+WL_VALUE walink_handle_valid(WL_VALUE handle) noexcept {
+    WL_HANDLE_LOCK();
+    return walink::wl_from_bool(find_slot(handle) != nullptr);
+}
+
+} // extern "C"
@@ -0,0 +1,255 @@
+#include "walink.h"
+
+#include <stdlib.h>
+
+#if WALINK_THREADS
+#include <atomic>
+#include <mutex>
+#include <new>
+#endif
+
+// Segregated free-list allocator for small blocks.
+//
+// Every block is preceded by an 8-byte PoolHeader that records its size class,
+// so wl_pool_free only needs the data pointer (walink_free gets nothing else).
+// Small classes are carved out of 16 KiB slabs and recycled through per-class
+// intrusive free lists; slabs are never returned to the heap. Anything larger
+// than the biggest class falls back to malloc with the same header.
+//
+// Threaded builds (WALINK_THREADS=1) give every thread its own PoolHeap, so
+// the hot path takes no lock. The header also records the owning heap: a
+// block freed by another thread is pushed onto the owner's lock-free remote
+// list (Treiber stack) and moved back to the owner's class lists the next time
+// the owner runs out of a class. Heaps outlive their thread and are handed to
+// the next thread that starts allocating.
+
+namespace {
+
+constexpr uint32_t kPoolClassSizes[] = {8, 16, 24, 32, 48, 64, 96, 128, 192, 256};
+constexpr uint32_t kPoolClassCount = sizeof(kPoolClassSizes) / sizeof(kPoolClassSizes[0]);
+constexpr uint32_t kPoolMaxSmall = kPoolClassSizes[kPoolClassCount - 1];
+constexpr uint16_t kPoolLargeClass = 0xffffu;
+constexpr uint32_t kPoolSlabSize = 16u * 1024u;
+
+struct alignas(8) PoolHeader {
+    uint16_t cls;
+    uint16_t owner; // PoolHeap id (always 0 without WALINK_THREADS)
+    uint32_t size;
+};
+
+struct PoolFreeBlock {
+    PoolFreeBlock* next;
+};
+
+struct PoolClass {
+    PoolFreeBlock* free_list;
+    uint8_t* bump;
+    uint8_t* bump_end;
+};
+
+struct PoolHeap {
+    PoolClass classes[kPoolClassCount];
+#if WALINK_THREADS
+    std::atomic<PoolFreeBlock*> remote_free{nullptr};
+    PoolHeap* next_idle = nullptr;
+#endif
+    uint16_t id = 0;
+};
+
+// (size + 7) / 8 -> class index, for size in [0, kPoolMaxSmall]
+constexpr auto kPoolClassLookup = [] {
+    struct Table { uint8_t v[kPoolMaxSmall / 8 + 1]; } t{};
+    uint32_t cls = 0;
+    for (uint32_t i = 0; i <= kPoolMaxSmall / 8; ++i) {
+        while (kPoolClassSizes[cls] < i * 8) {
+            ++cls;
+        }
+        t.v[i] = static_cast<uint8_t>(cls);
+    }
+    return t;
+}();
+
+inline PoolHeader* pool_header_of(void* ptr) noexcept {
+    return reinterpret_cast<PoolHeader*>(ptr) - 1;
+}
+
+bool pool_refill(PoolClass& pc, uint32_t block_size) noexcept {
+    auto* slab = static_cast<uint8_t*>(malloc(kPoolSlabSize));
+    if (!slab) {
+        return false;
+    }
+    pc.bump = slab;
+    pc.bump_end = slab + (kPoolSlabSize / block_size) * block_size;
+    return true;
+}
+
+inline void pool_push_local(PoolHeap& heap, PoolHeader* hdr) noexcept {
+    PoolClass& pc = heap.classes[hdr->cls];
+    auto* block = reinterpret_cast<PoolFreeBlock*>(hdr + 1);
+    block->next = pc.free_list;
+    pc.free_list = block;
+}
+
+#if WALINK_THREADS
+
+constexpr uint32_t kPoolMaxHeaps = 0x10000u;
+
+PoolHeap* g_pool_heaps[kPoolMaxHeaps];
+uint32_t g_pool_heap_count = 0;
+PoolHeap* g_pool_idle_heaps = nullptr;
+std::mutex g_pool_heaps_mutex;
+
+// Returns the thread's heap to the idle list when the thread exits.
+struct PoolHeapLease {
+    PoolHeap* heap = nullptr;
+
+    ~PoolHeapLease() {
+        if (heap) {
+            std::lock_guard<std::mutex> lock(g_pool_heaps_mutex);
+            heap->next_idle = g_pool_idle_heaps;
+            g_pool_idle_heaps = heap;
+        }
+    }
+};
+
+// Hot path reads the plain pointer; the lease (non-trivial destructor, so
+// every access goes through a TLS init wrapper) is only touched on acquire.
+thread_local PoolHeap* t_pool_heap = nullptr;
+thread_local PoolHeapLease t_pool_lease;
+
+PoolHeap* pool_acquire_heap() noexcept {
+    std::lock_guard<std::mutex> lock(g_pool_heaps_mutex);
+    if (PoolHeap* heap = g_pool_idle_heaps) {
+        g_pool_idle_heaps = heap->next_idle;
+        heap->next_idle = nullptr;
+        return heap;
+    }
+    if (g_pool_heap_count == kPoolMaxHeaps) {
+        return nullptr;
+    }
+    auto* heap = new (std::nothrow) PoolHeap();
+    if (!heap) {
+        return nullptr;
+    }
+    heap->id = static_cast<uint16_t>(g_pool_heap_count);
+    g_pool_heaps[g_pool_heap_count++] = heap;
+    return heap;
+}
+
+inline PoolHeap* pool_current_heap() noexcept {
+    PoolHeap* heap = t_pool_heap;
+    if (!heap) {
+        heap = t_pool_heap = t_pool_lease.heap = pool_acquire_heap();
+    }
+    return heap;
+}
+
+// Moves every block other threads have freed back into the local lists.
+bool pool_collect_remote(PoolHeap& heap) noexcept {
+    PoolFreeBlock* block = heap.remote_free.exchange(nullptr, std::memory_order_acquire);
+    if (!block) {
+        return false;
+    }
+    while (block) {
+        PoolFreeBlock* next = block->next;
+        pool_push_local(heap, pool_header_of(block));
+        block = next;
+    }
+    return true;
+}
+
+void pool_push_remote(PoolHeap& owner, PoolHeader* hdr) noexcept {
+    auto* block = reinterpret_cast<PoolFreeBlock*>(hdr + 1);
+    PoolFreeBlock* head = owner.remote_free.load(std::memory_order_relaxed);
+    do {
+        block->next = head;
+    } while (!owner.remote_free.compare_exchange_weak(head, block,
+                                                      std::memory_order_release,
+                                                      std::memory_order_relaxed));
+}
+
+#else
+
+PoolHeap g_pool_heap;
+
+inline PoolHeap* pool_current_heap() noexcept {
+    return &g_pool_heap;
+}
+
+inline bool pool_collect_remote(PoolHeap&) noexcept {
+    return false;
+}
+
+#endif
+
+} // namespace
+
+namespace walink {
+
+void* wl_pool_alloc(uint32_t size) noexcept {
+    if (size > kPoolMaxSmall) {
+        if (size > UINT32_MAX - sizeof(PoolHeader)) {
+            return nullptr;
+        }
+        auto* hdr = static_cast<PoolHeader*>(malloc(sizeof(PoolHeader) + size));
+        if (!hdr) {
+            return nullptr;
+        }
+        hdr->cls = kPoolLargeClass;
+        hdr->owner = 0;
+        hdr->size = size;
+        return hdr + 1;
+    }
+
+    PoolHeap* heap = pool_current_heap();
+    if (!heap) {
+        return nullptr;
+    }
+    const uint32_t cls = kPoolClassLookup.v[(size + 7u) >> 3];
+    PoolClass& pc = heap->classes[cls];
+
+    if (!pc.free_list && pc.bump == pc.bump_end) {
+        pool_collect_remote(*heap);
+    }
+
+    PoolHeader* hdr;
+    if (pc.free_list) {
+        PoolFreeBlock* block = pc.free_list;
+        pc.free_list = block->next;
+        hdr = pool_header_of(block);
+    } else {
+        const uint32_t block_size = static_cast<uint32_t>(sizeof(PoolHeader)) + kPoolClassSizes[cls];
+        if (pc.bump == pc.bump_end && !pool_refill(pc, block_size)) {
+            return nullptr;
+        }
+        hdr = reinterpret_cast<PoolHeader*>(pc.bump);
+        pc.bump += block_size;
+        hdr->cls = static_cast<uint16_t>(cls);
+        hdr->owner = heap->id;
+    }
+    hdr->size = size;
+    return hdr + 1;
+}
+
+void wl_pool_free(void* ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    PoolHeader* hdr = pool_header_of(ptr);
+    if (hdr->cls == kPoolLargeClass) {
+        free(hdr);
+        return;
+    }
+#if WALINK_THREADS
+    PoolHeap* heap = t_pool_heap;
+    if (!heap || heap->id != hdr->owner) {
+        pool_push_remote(*g_pool_heaps[hdr->owner], hdr);
+        return;
+    }
+    pool_push_local(*heap, hdr);
+#else
+    pool_push_local(g_pool_heap, hdr);
+#endif
+}
+
+} // namespace walink
@@ -0,0 +1,284 @@
+#include "walink_ring.h"
+
+#if WALINK_THREADS
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+
+// SPSC rings over plain uint32 indices. std::atomic_ref (rather than
+// std::atomic members) keeps the layout a flat, host-visible C struct; on wasm
+// the waits map to memory.atomic.wait32/notify so JS Atomics.wait/notify on the
+// same words interoperate.
+
+namespace {
+
+inline uint32_t ring_load(uint32_t& word, std::memory_order order) noexcept {
+    return std::atomic_ref<uint32_t>(word).load(order);
+}
+
+inline void ring_store(uint32_t& word, uint32_t v, std::memory_order order) noexcept {
+    std::atomic_ref<uint32_t>(word).store(v, order);
+}
+
+// Blocks while `word` still equals `expected` (may wake spuriously).
+inline void ring_wait(uint32_t& word, uint32_t expected) noexcept {
+#if defined(__wasm__)
+    __builtin_wasm_memory_atomic_wait32(reinterpret_cast<int32_t*>(&word), static_cast<int32_t>(expected), -1);
+#else
+    std::atomic_ref<uint32_t>(word).wait(expected, std::memory_order_acquire);
+#endif
+}
+
+inline void ring_notify(uint32_t& word) noexcept {
+#if defined(__wasm__)
+    __builtin_wasm_memory_atomic_notify(reinterpret_cast<int32_t*>(&word), UINT32_MAX);
+#else
+    std::atomic_ref<uint32_t>(word).notify_all();
+#endif
+}
+
+// Wakes the worker: it only ever waits on the doorbell, so every event it can
+// be waiting for (post, response released, stop) bumps it.
+inline void ring_doorbell(WlRingChannel* ch) noexcept {
+    std::atomic_ref<uint32_t>(ch->doorbell).fetch_add(1, std::memory_order_release);
+    ring_notify(ch->doorbell);
+}
+
+struct Ring {
+    uint8_t* base;
+    uint32_t mask;
+
+    uint32_t& head() const noexcept { return *reinterpret_cast<uint32_t*>(base + WL_RING_HEAD_OFFSET); }
+    uint32_t& tail() const noexcept { return *reinterpret_cast<uint32_t*>(base + WL_RING_TAIL_OFFSET); }
+
+    template <typename Entry>
+    Entry& at(uint32_t index) const noexcept {
+        return reinterpret_cast<Entry*>(base + WL_RING_ENTRIES_OFFSET)[index & mask];
+    }
+};
+
+inline Ring request_ring(WlRingChannel* ch) noexcept {
+    return {reinterpret_cast<uint8_t*>(ch) + ch->request_offset, ch->capacity - 1};
+}
+
+inline Ring response_ring(WlRingChannel* ch) noexcept {
+    return {reinterpret_cast<uint8_t*>(ch) + ch->response_offset, ch->capacity - 1};
+}
+
+inline bool is_slot64_tag(uint32_t tag) noexcept {
+    return tag == WL_TAG_FLOAT64 || tag == WL_TAG_SINT64 || tag == WL_TAG_UINT64;
+}
+
+// A scratch-slot scalar (no ownership bits) is copied into `dst` and the value
+// re-pointed at it; anything else is passed through unchanged.
+WL_VALUE pin_scalar(WL_VALUE v, uint64_t* dst) noexcept {
+    if (!walink::wl_is_address(v) || !is_slot64_tag(walink::wl_get_tag(v)) ||
+        walink::wl_has_free_flag(v) || walink::wl_has_arena_flag(v) || walink::wl_get_payload32(v) == 0) {
+        return v;
+    }
+    memcpy(dst, reinterpret_cast<const void*>(static_cast<uintptr_t>(walink::wl_get_payload32(v))), sizeof(*dst));
+    return walink::wl_make(walink::wl_get_meta(v), static_cast<uint32_t>(reinterpret_cast<uintptr_t>(dst)));
+}
+
+uint32_t ring_bytes(uint32_t capacity, uint32_t entry_size) noexcept {
+    return WL_RING_ENTRIES_OFFSET + capacity * entry_size;
+}
+
+// A value nobody will receive any more (undelivered result, unprocessed
+// argument): release it if it was handed over with the free flag.
+void release_owned(WL_VALUE v) noexcept {
+    if (walink::wl_has_free_flag(v)) {
+        ::walink_free(v);
+    }
+}
+
+WlRingChannel* channel_of(WL_VALUE v) noexcept {
+    return reinterpret_cast<WlRingChannel*>(static_cast<uintptr_t>(walink::wl_get_payload32(v)));
+}
+
+} // namespace
+
+namespace walink {
+
+WlRingChannel* wl_ring_create(uint32_t capacity) noexcept {
+    uint32_t cap = 2;
+    while (cap < capacity) {
+        if (cap > (1u << 20)) {
+            return nullptr;
+        }
+        cap <<= 1;
+    }
+
+    const uint32_t request_offset = sizeof(WlRingChannel);
+    const uint32_t response_offset = request_offset + ring_bytes(cap, sizeof(WlRingRequest));
+    const uint32_t total = response_offset + ring_bytes(cap, sizeof(WlRingResponse));
+
+    void* raw = aligned_alloc(64, (total + 63u) & ~63u);
+    if (!raw) {
+        return nullptr;
+    }
+    memset(raw, 0, total);
+
+    auto* ch = static_cast<WlRingChannel*>(raw);
+    ch->capacity = cap;
+    ch->request_offset = request_offset;
+    ch->response_offset = response_offset;
+    return ch;
+}
+
+void wl_ring_destroy(WlRingChannel* ch) noexcept {
+    if (!ch) {
+        return;
+    }
+    // Entries left behind by a stop still own their containers.
+    const Ring requests = request_ring(ch);
+    for (uint32_t i = requests.head(); i != requests.tail(); ++i) {
+        const auto& rq = requests.at<WlRingRequest>(i);
+        for (uint32_t a = 0; a < rq.argc; ++a) {
+            release_owned(rq.args[a]);
+        }
+    }
+    const Ring responses = response_ring(ch);
+    for (uint32_t i = responses.head(); i != responses.tail(); ++i) {
+        release_owned(responses.at<WlRingResponse>(i).result);
+    }
+    free(ch);
+}
+
+bool wl_ring_post(WlRingChannel* ch, uint64_t id, uint32_t fn_id,
+                  const WL_VALUE* args, uint32_t argc) noexcept {
+    if (argc > WL_RING_MAX_ARGS) {
+        return false;
+    }
+    const Ring ring = request_ring(ch);
+    const uint32_t tail = ring_load(ring.tail(), std::memory_order_relaxed);
+    if (tail - ring_load(ring.head(), std::memory_order_acquire) > ring.mask) {
+        return false;
+    }
+
+    auto& rq = ring.at<WlRingRequest>(tail);
+    rq.id = id;
+    rq.fn_id = fn_id;
+    rq.argc = argc;
+    for (uint32_t i = 0; i < argc; ++i) {
+        rq.args[i] = pin_scalar(args[i], &rq.scalars[i]);
+    }
+    ring_store(ring.tail(), tail + 1, std::memory_order_release);
+    ring_doorbell(ch);
+    return true;
+}
+
+bool wl_ring_poll(WlRingChannel* ch, WlRingResponse* out) noexcept {
+    const Ring ring = response_ring(ch);
+    const uint32_t head = ring_load(ring.head(), std::memory_order_relaxed);
+    if (head == ring_load(ring.tail(), std::memory_order_acquire)) {
+        return false;
+    }
+
+    *out = ring.at<WlRingResponse>(head);
+    out->result = pin_scalar(out->result, &out->scalar);
+    ring_store(ring.head(), head + 1, std::memory_order_release);
+    ring_doorbell(ch);
+    return true;
+}
+
+uint32_t wl_ring_run(WlRingChannel* ch) noexcept {
+    const Ring requests = request_ring(ch);
+    const Ring responses = response_ring(ch);
+    uint32_t processed = 0;
+
+    for (;;) {
+        // Read the doorbell before checking for work, so a post or stop that
+        // lands in between makes the wait below return immediately.
+        const uint32_t bell = ring_load(ch->doorbell, std::memory_order_acquire);
+        if (ring_load(ch->stop, std::memory_order_acquire)) {
+            break;
+        }
+
+        const uint32_t head = ring_load(requests.head(), std::memory_order_relaxed);
+        if (head == ring_load(requests.tail(), std::memory_order_acquire)) {
+            ring_wait(ch->doorbell, bell);
+            continue;
+        }
+
+        const auto& rq = requests.at<WlRingRequest>(head);
+        const wl_batch_fn fn = wl_batch_lookup(rq.fn_id);
+        const WL_VALUE result = fn
+            ? fn(rq.args, rq.argc)
+            : wl_make_error("walink_ring_run: unknown function id");
+        const uint64_t id = rq.id;
+        // The request entry (and its pinned scalars) is no longer needed.
+        ring_store(requests.head(), head + 1, std::memory_order_release);
+
+        // Response ring full: wait for the host to release an entry, unless
+        // the channel is stopped meanwhile (the host no longer drains then).
+        const uint32_t tail = ring_load(responses.tail(), std::memory_order_relaxed);
+        bool stopped = false;
+        for (;;) {
+            const uint32_t full_bell = ring_load(ch->doorbell, std::memory_order_acquire);
+            if (tail - ring_load(responses.head(), std::memory_order_acquire) <= responses.mask) {
+                break;
+            }
+            if (ring_load(ch->stop, std::memory_order_acquire)) {
+                stopped = true;
+                break;
+            }
+            ring_wait(ch->doorbell, full_bell);
+        }
+        if (stopped) {
+            release_owned(result);
+            break;
+        }
+
+        auto& rs = responses.at<WlRingResponse>(tail);
+        rs.id = id;
+        rs.result = pin_scalar(result, &rs.scalar);
+        ring_store(responses.tail(), tail + 1, std::memory_order_release);
+        ring_notify(responses.tail());
+        ++processed;
+    }
+    return processed;
+}
+
+void wl_ring_stop(WlRingChannel* ch) noexcept {
+    ring_store(ch->stop, 1, std::memory_order_release);
+    ring_doorbell(ch);
+}
+
+} // namespace walink
+
+extern "C" {
+
+WL_VALUE walink_ring_create(uint32_t capacity) noexcept {
+    WlRingChannel* ch = walink::wl_ring_create(capacity);
+    if (!ch) {
+        return walink::wl_make_error("walink_ring_create: allocation failed");
+    }
+    return walink::wl_make(0, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(ch)));
+}
+
+WL_VALUE walink_ring_run(WL_VALUE channel) noexcept {
+    WlRingChannel* ch = channel_of(channel);
+    if (!ch) {
+        return walink::wl_make_error("walink_ring_run: null channel");
+    }
+    return walink::wl_from_uint32(walink::wl_ring_run(ch));
+}
+
+WL_VALUE walink_ring_stop(WL_VALUE channel) noexcept {
+    if (WlRingChannel* ch = channel_of(channel)) {
+        walink::wl_ring_stop(ch);
+    }
+    return walink::wl_null();
+}
+
+WL_VALUE walink_ring_destroy(WL_VALUE channel) noexcept {
+    walink::wl_ring_destroy(channel_of(channel));
+    return walink::wl_null();
+}
+
+} // extern "C"
+
+#endif // WALINK_THREADS
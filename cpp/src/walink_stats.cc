@@ -0,0 +1,131 @@
+#include "walink_stats.h"
+
+#include <atomic>
+#include <bit>
+
+namespace {
+
+// Shared by all threads; relaxed ordering, since readers only want a
+// consistent-enough snapshot (without -pthread these are plain loads/stores).
+struct StatsCounters {
+    std::atomic<uint32_t> live_blocks{0};
+    std::atomic<uint32_t> live_bytes{0};
+    std::atomic<uint32_t> peak_bytes{0};
+    std::atomic<uint64_t> alloc_count{0};
+    std::atomic<uint64_t> free_count{0};
+    std::atomic<uint64_t> bad_free_count{0};
+    std::atomic<uint64_t> invalid_free_count{0};
+    std::atomic<uint32_t> live_by_kind[WL_STATS_KIND_COUNT]{};
+    std::atomic<uint64_t> size_histogram[WL_STATS_SIZE_BUCKETS]{};
+};
+
+StatsCounters g_stats;
+
+#if WALINK_STATS
+WL_THREAD_LOCAL WlStats g_snapshot;
+#endif
+
+inline uint32_t size_bucket(uint32_t size) noexcept {
+    if (size <= 16) {
+        return 0;
+    }
+    const uint32_t bucket = static_cast<uint32_t>(std::bit_width(size - 1)) - 4;
+    return bucket < WL_STATS_SIZE_BUCKETS ? bucket : WL_STATS_SIZE_BUCKETS - 1;
+}
+
+} // namespace
+
+namespace walink {
+
+uint32_t wl_stats_kind_of(uint32_t tag) noexcept {
+    switch (tag) {
+    case WL_TAG_NULL:
+        return WL_STATS_HOST;
+    case WL_TAG_BYTES:
+        return WL_STATS_BYTES;
+    case WL_TAG_STRING:
+    case WL_TAG_STRING16:
+        return WL_STATS_STRING;
+    case WL_TAG_MSGPACK:
+        return WL_STATS_MSGPACK;
+    case WL_TAG_FLAT:
+        return WL_STATS_FLAT;
+    case WL_TAG_IOVEC:
+        return WL_STATS_IOVEC;
+    case WL_TAG_ERROR:
+        return WL_STATS_ERROR;
+    case WL_TAG_FLOAT64:
+    case WL_TAG_SINT64:
+    case WL_TAG_UINT64:
+        return WL_STATS_SCALAR;
+    default:
+        return (tag & ~0xffu) == WL_TAG_ARRAY_BASE ? WL_STATS_ARRAY : WL_STATS_OTHER;
+    }
+}
+
+void wl_stats_on_alloc(uint32_t size, uint32_t kind) noexcept {
+    g_stats.alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_stats.live_blocks.fetch_add(1, std::memory_order_relaxed);
+    g_stats.live_by_kind[kind].fetch_add(1, std::memory_order_relaxed);
+    g_stats.size_histogram[size_bucket(size)].fetch_add(1, std::memory_order_relaxed);
+    const uint32_t live = g_stats.live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    uint32_t peak = g_stats.peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !g_stats.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void wl_stats_on_free(uint32_t size, uint32_t kind) noexcept {
+    g_stats.free_count.fetch_add(1, std::memory_order_relaxed);
+    g_stats.live_blocks.fetch_sub(1, std::memory_order_relaxed);
+    g_stats.live_by_kind[kind].fetch_sub(1, std::memory_order_relaxed);
+    g_stats.live_bytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+void wl_stats_on_retag(uint32_t from, uint32_t to) noexcept {
+    if (from != to) {
+        g_stats.live_by_kind[from].fetch_sub(1, std::memory_order_relaxed);
+        g_stats.live_by_kind[to].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void wl_stats_on_bad_free() noexcept {
+    g_stats.bad_free_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void wl_stats_on_invalid_free() noexcept {
+    g_stats.invalid_free_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+WlStats wl_stats() noexcept {
+    WlStats s{};
+    s.version = WL_STATS_VERSION;
+    s.live_blocks = g_stats.live_blocks.load(std::memory_order_relaxed);
+    s.live_bytes = g_stats.live_bytes.load(std::memory_order_relaxed);
+    s.peak_bytes = g_stats.peak_bytes.load(std::memory_order_relaxed);
+    s.alloc_count = g_stats.alloc_count.load(std::memory_order_relaxed);
+    s.free_count = g_stats.free_count.load(std::memory_order_relaxed);
+    s.bad_free_count = g_stats.bad_free_count.load(std::memory_order_relaxed);
+    s.invalid_free_count = g_stats.invalid_free_count.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < WL_STATS_KIND_COUNT; ++i) {
+        s.live_by_kind[i] = g_stats.live_by_kind[i].load(std::memory_order_relaxed);
+    }
+    for (uint32_t i = 0; i < WL_STATS_SIZE_BUCKETS; ++i) {
+        s.size_histogram[i] = g_stats.size_histogram[i].load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+} // namespace walink
+
+extern "C" {
+
+WL_VALUE walink_stats() noexcept {
+#if WALINK_STATS
+    g_snapshot = walink::wl_stats();
+    return walink::wl_make(0, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&g_snapshot)));
+#else
+    return 0;
+#endif
+}
+
+} // extern "C"
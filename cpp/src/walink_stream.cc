@@ -0,0 +1,142 @@
+#include "walink_stream.h"
+
+#include <new>
+
+namespace {
+
+struct WlStream {
+    walink::WlStreamOps ops;
+    void* ctx;
+    BaseContainer* buffer; // cap = chunk size
+    uint32_t buffer_meta;  // content tag, no ownership bits
+    bool finished;         // source returned 0 (or failed)
+};
+
+WlStream* stream_of(WL_VALUE v) noexcept {
+    if (!walink::wl_is_address(v) || walink::wl_get_tag(v) != WL_TAG_STREAM) {
+        return nullptr;
+    }
+    return reinterpret_cast<WlStream*>(static_cast<uintptr_t>(walink::wl_get_payload32(v)));
+}
+
+} // namespace
+
+namespace walink {
+
+WL_VALUE wl_make_stream(const WlStreamOps& ops, void* ctx,
+                        uint32_t content_tag, uint32_t chunk_size) noexcept {
+    if (chunk_size == 0) {
+        chunk_size = WL_STREAM_DEFAULT_CHUNK_SIZE;
+    }
+    // Heap, not arena: a stream outlives the call that created it.
+    const uint32_t buffer_meta = wl_build_meta(content_tag, /*is_address*/ true);
+    BaseContainer* buffer = wl_alloc_container(buffer_meta, chunk_size);
+    if (buffer) {
+        // A recycled block may be larger; the host sizes its writes by cap.
+        buffer->cap = chunk_size;
+    }
+    auto* s = buffer ? new (std::nothrow) WlStream{ops, ctx, buffer, buffer_meta, false} : nullptr;
+    if (!s) {
+        wl_free_container(buffer, buffer_meta);
+        const WL_VALUE result = ops.close ? ops.close(ctx) : 0;
+        if (wl_has_free_flag(result)) {
+            ::walink_free(result);
+        }
+        return 0;
+    }
+    return wl_from_address(s, WL_TAG_STREAM, /*free_flag_for_receiver*/ false);
+}
+
+Result<std::span<const uint8_t>> wl_stream_read_chunk(WL_VALUE stream) noexcept {
+    WlStream* s = stream_of(stream);
+    if (!s) {
+        return Error{Errc::type_mismatch, "walink_stream_read: expected STREAM value"};
+    }
+    if (!s->ops.read) {
+        return Error{Errc::type_mismatch, "walink_stream_read: stream is not readable"};
+    }
+    s->buffer->size = 0;
+    if (s->finished) {
+        return std::span<const uint8_t>();
+    }
+
+    const auto n = s->ops.read(s->ctx, std::span<uint8_t>(s->buffer->data, s->buffer->cap));
+    if (!n) {
+        s->finished = true;
+        return n.error();
+    }
+    if (*n > s->buffer->cap) {
+        s->finished = true;
+        return Error{Errc::out_of_memory, "walink_stream_read: chunk larger than the working buffer"};
+    }
+    s->finished = *n == 0;
+    s->buffer->size = *n;
+    return std::span<const uint8_t>(s->buffer->data, *n);
+}
+
+Error wl_stream_write_chunk(WL_VALUE stream, std::span<const uint8_t> chunk) noexcept {
+    WlStream* s = stream_of(stream);
+    if (!s) {
+        return Error{Errc::type_mismatch, "walink_stream_write: expected STREAM value"};
+    }
+    if (!s->ops.write) {
+        return Error{Errc::type_mismatch, "walink_stream_write: stream is not writable"};
+    }
+    if (chunk.empty()) {
+        return Error{Errc::ok, nullptr};
+    }
+    return s->ops.write(s->ctx, chunk);
+}
+
+WL_VALUE wl_stream_close(WL_VALUE stream) noexcept {
+    WlStream* s = stream_of(stream);
+    if (!s) {
+        return wl_make_error("walink_stream_close: expected STREAM value");
+    }
+    const WL_VALUE result = s->ops.close ? s->ops.close(s->ctx) : 0;
+    wl_free_container(s->buffer, s->buffer_meta);
+    delete s;
+    return result ? result : wl_null();
+}
+
+} // namespace walink
+
+extern "C" {
+
+WL_VALUE walink_stream_buffer(WL_VALUE stream) noexcept {
+    WlStream* s = stream_of(stream);
+    if (!s) {
+        return walink::wl_make_error("walink_stream_buffer: expected STREAM value");
+    }
+    return walink::wl_make(s->buffer_meta, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(s->buffer)));
+}
+
+WL_VALUE walink_stream_read(WL_VALUE stream) noexcept {
+    const auto chunk = walink::wl_stream_read_chunk(stream);
+    if (!chunk) {
+        return walink::wl_make_error(chunk.error());
+    }
+    return walink::wl_from_uint32(static_cast<uint32_t>(chunk->size()));
+}
+
+WL_VALUE walink_stream_write(WL_VALUE stream, uint32_t size) noexcept {
+    WlStream* s = stream_of(stream);
+    if (!s) {
+        return walink::wl_make_error("walink_stream_write: expected STREAM value");
+    }
+    if (size > s->buffer->cap) {
+        return walink::wl_make_error("walink_stream_write: size exceeds the working buffer");
+    }
+    s->buffer->size = size;
+    const walink::Error err = walink::wl_stream_write_chunk(stream, std::span<const uint8_t>(s->buffer->data, size));
+    if (err.code != walink::Errc::ok) {
+        return walink::wl_make_error(err);
+    }
+    return walink::wl_null();
+}
+
+WL_VALUE walink_stream_close(WL_VALUE stream) noexcept {
+    return walink::wl_stream_close(stream);
+}
+
+} // extern "C"
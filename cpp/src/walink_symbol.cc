@@ -0,0 +1,172 @@
+#include "walink_symbol.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if WALINK_THREADS
+#include <mutex>
+#endif
+
+// Intern table behind WL_TAG_SYMBOL.
+//
+// Each string is stored once as an immutable BaseContainer (so
+// walink_symbol_lookup can hand it to the host without copying) and indexed
+// by an open-addressing hash table of ids. Entries are never removed.
+
+namespace {
+
+struct SymbolTable {
+    BaseContainer** names = nullptr; // by id
+    uint32_t count = 0;
+    uint32_t names_cap = 0;
+    uint32_t* slots = nullptr; // id + 1, 0: empty
+    uint32_t slots_mask = 0;   // slot count - 1 (power of two)
+};
+
+SymbolTable g_symbols;
+
+#if WALINK_THREADS
+std::mutex g_symbol_mutex;
+#define WL_SYMBOL_LOCK() std::lock_guard<std::mutex> wl_symbol_lock_(g_symbol_mutex)
+#else
+#define WL_SYMBOL_LOCK() (void)0
+#endif
+
+// FNV-1a
+inline uint32_t symbol_hash(std::string_view s) noexcept {
+    uint32_t h = 2166136261u;
+    for (const char c : s) {
+        h = (h ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return h;
+}
+
+inline std::string_view name_of(const BaseContainer* c) noexcept {
+    return std::string_view(reinterpret_cast<const char*>(c->data), c->size);
+}
+
+// Rebuilds the index with `slot_count` slots. Caller holds the lock.
+bool symbol_rehash(uint32_t slot_count) noexcept {
+    auto* slots = static_cast<uint32_t*>(calloc(slot_count, sizeof(uint32_t)));
+    if (!slots) {
+        return false;
+    }
+    const uint32_t mask = slot_count - 1;
+    for (uint32_t id = 0; id < g_symbols.count; ++id) {
+        uint32_t i = symbol_hash(name_of(g_symbols.names[id])) & mask;
+        while (slots[i]) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = id + 1;
+    }
+    free(g_symbols.slots);
+    g_symbols.slots = slots;
+    g_symbols.slots_mask = mask;
+    return true;
+}
+
+inline WL_VALUE make_symbol(uint32_t id) noexcept {
+    return walink::wl_from_symbol(walink::Symbol{id});
+}
+
+// Container of a symbol value, or nullptr. Caller holds the lock.
+const BaseContainer* symbol_container(WL_VALUE sym) noexcept {
+    if (!walink::codec<walink::Symbol>::check(sym)) {
+        return nullptr;
+    }
+    const uint32_t id = walink::wl_get_payload32(sym);
+    return id < g_symbols.count ? g_symbols.names[id] : nullptr;
+}
+
+} // namespace
+
+namespace walink {
+
+WL_VALUE wl_intern(std::string_view str) noexcept {
+    const uint32_t hash = symbol_hash(str);
+    WL_SYMBOL_LOCK();
+
+    if (g_symbols.slots) {
+        for (uint32_t i = hash & g_symbols.slots_mask; g_symbols.slots[i]; i = (i + 1) & g_symbols.slots_mask) {
+            const uint32_t id = g_symbols.slots[i] - 1;
+            if (name_of(g_symbols.names[id]) == str) {
+                return make_symbol(id);
+            }
+        }
+    }
+
+    // Keep the load factor at or below 1/2.
+    if ((g_symbols.count + 1) * 2 > g_symbols.slots_mask + 1 &&
+        !symbol_rehash(g_symbols.slots ? (g_symbols.slots_mask + 1) * 2 : 64)) {
+        return 0;
+    }
+    if (g_symbols.count == g_symbols.names_cap) {
+        const uint32_t cap = g_symbols.names_cap ? g_symbols.names_cap * 2 : 32;
+        auto* names = static_cast<BaseContainer**>(realloc(g_symbols.names, cap * sizeof(BaseContainer*)));
+        if (!names) {
+            return 0;
+        }
+        g_symbols.names = names;
+        g_symbols.names_cap = cap;
+    }
+    auto* c = static_cast<BaseContainer*>(malloc(sizeof(BaseContainer) + str.size()));
+    if (!c) {
+        return 0;
+    }
+    c->cap = static_cast<uint32_t>(str.size());
+    c->size = static_cast<uint32_t>(str.size());
+    if (!str.empty()) {
+        memcpy(c->data, str.data(), str.size());
+    }
+
+    const uint32_t id = g_symbols.count++;
+    g_symbols.names[id] = c;
+    uint32_t i = hash & g_symbols.slots_mask;
+    while (g_symbols.slots[i]) {
+        i = (i + 1) & g_symbols.slots_mask;
+    }
+    g_symbols.slots[i] = id + 1;
+    return make_symbol(id);
+}
+
+std::string_view wl_symbol_name(WL_VALUE sym) noexcept {
+    WL_SYMBOL_LOCK();
+    const BaseContainer* c = symbol_container(sym);
+    return c ? name_of(c) : std::string_view();
+}
+
+Result<std::string_view> wl_try_symbol_name(WL_VALUE sym) noexcept {
+    if (!codec<Symbol>::check(sym)) {
+        return Error{Errc::type_mismatch, "wl_symbol_name: expected SYMBOL tag"};
+    }
+    WL_SYMBOL_LOCK();
+    const BaseContainer* c = symbol_container(sym);
+    if (!c) {
+        return Error{Errc::type_mismatch, "wl_symbol_name: unknown symbol id"};
+    }
+    return name_of(c);
+}
+
+uint32_t wl_symbol_count() noexcept {
+    WL_SYMBOL_LOCK();
+    return g_symbols.count;
+}
+
+} // namespace walink
+
+extern "C" {
+
+WL_VALUE walink_symbol_lookup(WL_VALUE sym) noexcept {
+    const BaseContainer* c;
+    {
+        WL_SYMBOL_LOCK();
+        c = symbol_container(sym);
+    }
+    if (!c) {
+        return walink::wl_make_error("walink_symbol_lookup: unknown symbol");
+    }
+    return walink::wl_make(walink::wl_build_meta(WL_TAG_STRING, /*is_address*/ true),
+                           static_cast<uint32_t>(reinterpret_cast<uintptr_t>(c)));
+}
+
+} // extern "C"
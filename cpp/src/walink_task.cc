@@ -0,0 +1,88 @@
+#include "walink_task.h"
+#include "walink_handle.h"
+
+#include <exception>
+
+// Completion table behind WL_TAG_PENDING: tasks are parked in the handle
+// table (one reference, owned by the PENDING value) under their own
+// WlHandleType, which destroys the coroutine frame.
+
+namespace {
+
+const walink::WlHandleType kTaskType{
+    "task",
+    [](void* frame) noexcept { walink::Task::handle_type::from_address(frame).destroy(); },
+};
+
+// PENDING and HANDLE share the payload layout; only the tag differs.
+inline WL_VALUE slot_of(WL_VALUE pending) noexcept {
+    return walink::wl_make(walink::wl_build_meta(WL_TAG_HANDLE, /*is_address*/ false),
+                           walink::wl_get_payload32(pending));
+}
+
+inline bool is_pending(WL_VALUE v) noexcept {
+    return !walink::wl_is_address(v) && walink::wl_get_tag(v) == WL_TAG_PENDING;
+}
+
+} // namespace
+
+namespace walink {
+
+void Task::promise_type::unhandled_exception() noexcept {
+#if defined(__cpp_exceptions)
+    try {
+        throw;
+    } catch (const std::exception& e) {
+        result = wl_make_error(e.what());
+    } catch (...) {
+        result = wl_make_error("walink task: unknown exception");
+    }
+#else
+    result = wl_make_error("walink task: unhandled exception");
+#endif
+}
+
+WL_VALUE wl_spawn(Task task, uint32_t budget) noexcept {
+    if (!task) {
+        return wl_make_error(Error{Errc::out_of_memory, "wl_spawn: task frame allocation failed"});
+    }
+    const WL_VALUE slot = wl_handle_create(task.release().address(), &kTaskType);
+    if (slot == 0) {
+        return wl_make_error(Error{Errc::out_of_memory, "wl_spawn: completion table is full"});
+    }
+    const WL_VALUE pending = wl_make(wl_build_meta(WL_TAG_PENDING, /*is_address*/ false), wl_get_payload32(slot));
+    return budget != 0 ? walink_poll(pending, budget) : pending;
+}
+
+} // namespace walink
+
+extern "C" {
+
+WL_VALUE walink_poll(WL_VALUE pending, uint32_t budget) noexcept {
+    if (!is_pending(pending)) {
+        return walink::wl_make_error(walink::Error{walink::Errc::type_mismatch, "walink_poll: expected PENDING tag"});
+    }
+    const WL_VALUE slot = slot_of(pending);
+    void* frame = walink::wl_handle_lookup(slot, &kTaskType);
+    if (!frame) {
+        return walink::wl_make_error(
+            walink::Error{walink::Errc::stale_handle, "walink_poll: task already finished or cancelled"});
+    }
+
+    auto task = walink::Task::handle_type::from_address(frame);
+    task.promise().budget = budget != 0 ? budget : 1;
+    task.resume();
+    if (!task.done()) {
+        return pending;
+    }
+    const WL_VALUE result = task.promise().result;
+    walink::wl_handle_release(slot); // destroys the frame
+    return result;
+}
+
+WL_VALUE walink_cancel(WL_VALUE pending) noexcept {
+    return walink::wl_from_bool(is_pending(pending) && walink::wl_handle_lookup(slot_of(pending), &kTaskType) &&
+                                walink::wl_handle_release(slot_of(pending)));
+}
+
+} // extern "C"
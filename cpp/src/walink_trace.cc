@@ -0,0 +1,40 @@
+#include "walink_trace.h"
+
+#if WALINK_TRACE
+
+#if defined(__wasm__)
+// Host clock (performance.now()); see WalinkTrace.imports() on the Node side.
+extern "C" __attribute__((import_module("env"), import_name("walink_trace_now"))) double walink_trace_now();
+#else
+#include <time.h>
+#endif
+
+namespace walink {
+
+WlTraceRing g_wl_trace{WL_TRACE_CAPACITY, 0, static_cast<uint32_t>(sizeof(WlTraceRecord)), 0, {}};
+
+double wl_trace_now() noexcept {
+#if defined(__wasm__)
+    return walink_trace_now();
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e3 + static_cast<double>(ts.tv_nsec) / 1e6;
+#endif
+}
+
+} // namespace walink
+
+#endif
+
+extern "C" {
+
+WL_VALUE walink_trace_buffer() noexcept {
+#if WALINK_TRACE
+    return walink::wl_make(0, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&walink::g_wl_trace)));
+#else
+    return 0;
+#endif
+}
+
+} // extern "C"
@@ -0,0 +1,308 @@
+#include "walink_utf.h"
+
+#if WALINK_SIMD && defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define WL_UTF_SIMD 1
+#else
+#define WL_UTF_SIMD 0
+#endif
+
+namespace {
+
+constexpr char16_t kReplacement = 0xfffd;
+
+inline uint64_t load64(const uint8_t* p) noexcept {
+    uint64_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+// Widens an ASCII run of `n` bytes (n <= remaining input) into code units.
+inline void widen_ascii(const uint8_t* in, char16_t* out, size_t n) noexcept {
+    size_t i = 0;
+#if WL_UTF_SIMD
+    for (; i + 16 <= n; i += 16) {
+        const v128_t v = wasm_v128_load(in + i);
+        wasm_v128_store(out + i, wasm_u16x8_extend_low_u8x16(v));
+        wasm_v128_store(out + i + 8, wasm_u16x8_extend_high_u8x16(v));
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = in[i];
+    }
+}
+
+// Length of the leading run of code units below 0x80.
+inline size_t ascii_prefix16(const char16_t* in, size_t n) noexcept {
+    size_t i = 0;
+#if WL_UTF_SIMD
+    const v128_t high = wasm_i16x8_splat(static_cast<int16_t>(0xff80));
+    for (; i + 16 <= n; i += 16) {
+        const v128_t a = wasm_v128_load(in + i);
+        const v128_t b = wasm_v128_load(in + i + 8);
+        if (wasm_v128_any_true(wasm_v128_and(wasm_v128_or(a, b), high))) {
+            break;
+        }
+    }
+#else
+    for (; i + 4 <= n; i += 4) {
+        uint64_t w;
+        memcpy(&w, in + i, sizeof(w));
+        if (w & 0xff80ff80ff80ff80ull) {
+            break;
+        }
+    }
+#endif
+    while (i < n && in[i] < 0x80) {
+        ++i;
+    }
+    return i;
+}
+
+// Narrows an ASCII run of `n` code units into bytes.
+inline void narrow_ascii(const char16_t* in, uint8_t* out, size_t n) noexcept {
+    size_t i = 0;
+#if WL_UTF_SIMD
+    for (; i + 16 <= n; i += 16) {
+        const v128_t a = wasm_v128_load(in + i);
+        const v128_t b = wasm_v128_load(in + i + 8);
+        wasm_v128_store(out + i, wasm_u8x16_narrow_i16x8(a, b));
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = static_cast<uint8_t>(in[i]);
+    }
+}
+
+// Decodes one multi-byte sequence at `p` (lead byte >= 0x80). Returns its
+// length and sets `cp`, or 0 if malformed.
+inline size_t decode_sequence(const uint8_t* p, size_t n, uint32_t& cp) noexcept {
+    const uint8_t b0 = p[0];
+    if (b0 >= 0xc2 && b0 <= 0xdf) {
+        if (n < 2 || (p[1] & 0xc0) != 0x80) {
+            return 0;
+        }
+        cp = ((b0 & 0x1fu) << 6) | (p[1] & 0x3fu);
+        return 2;
+    }
+    if (b0 >= 0xe0 && b0 <= 0xef) {
+        if (n < 3 || (p[1] & 0xc0) != 0x80 || (p[2] & 0xc0) != 0x80) {
+            return 0;
+        }
+        cp = ((b0 & 0x0fu) << 12) | ((p[1] & 0x3fu) << 6) | (p[2] & 0x3fu);
+        // overlong, or a surrogate
+        return cp < 0x800 || (cp >= 0xd800 && cp <= 0xdfff) ? 0 : 3;
+    }
+    if (b0 >= 0xf0 && b0 <= 0xf4) {
+        if (n < 4 || (p[1] & 0xc0) != 0x80 || (p[2] & 0xc0) != 0x80 || (p[3] & 0xc0) != 0x80) {
+            return 0;
+        }
+        cp = ((b0 & 0x07u) << 18) | ((p[1] & 0x3fu) << 12) | ((p[2] & 0x3fu) << 6) | (p[3] & 0x3fu);
+        return cp < 0x10000 || cp > 0x10ffff ? 0 : 4;
+    }
+    return 0;
+}
+
+// Next code point of `in` at `i` (lone surrogates -> U+FFFD); advances `i`.
+inline uint32_t next_code_point(std::u16string_view in, size_t& i) noexcept {
+    const char16_t u = in[i++];
+    if (u < 0xd800 || u > 0xdfff) {
+        return u;
+    }
+    if (u <= 0xdbff && i < in.size() && in[i] >= 0xdc00 && in[i] <= 0xdfff) {
+        return 0x10000 + ((static_cast<uint32_t>(u) - 0xd800) << 10) + (in[i++] - 0xdc00);
+    }
+    return kReplacement;
+}
+
+} // namespace
+
+namespace walink {
+
+size_t wl_ascii_prefix(std::span<const uint8_t> utf8) noexcept {
+    const uint8_t* p = utf8.data();
+    const size_t n = utf8.size();
+    size_t i = 0;
+#if WL_UTF_SIMD
+    for (; i + 16 <= n; i += 16) {
+        if (wasm_i8x16_bitmask(wasm_v128_load(p + i))) {
+            break;
+        }
+    }
+#else
+    for (; i + 8 <= n; i += 8) {
+        if (load64(p + i) & 0x8080808080808080ull) {
+            break;
+        }
+    }
+#endif
+    while (i < n && p[i] < 0x80) {
+        ++i;
+    }
+    return i;
+}
+
+bool wl_utf8_validate(std::span<const uint8_t> utf8) noexcept {
+    size_t i = 0;
+    while (i < utf8.size()) {
+        i += wl_ascii_prefix(utf8.subspan(i));
+        if (i == utf8.size()) {
+            break;
+        }
+        uint32_t cp;
+        const size_t len = decode_sequence(utf8.data() + i, utf8.size() - i, cp);
+        if (len == 0) {
+            return false;
+        }
+        i += len;
+    }
+    return true;
+}
+
+Result<uint32_t> wl_utf8_to_utf16(std::span<const uint8_t> utf8, char16_t* out) noexcept {
+    size_t i = 0;
+    uint32_t o = 0;
+    while (i < utf8.size()) {
+        const size_t run = wl_ascii_prefix(utf8.subspan(i));
+        widen_ascii(utf8.data() + i, out + o, run);
+        i += run;
+        o += static_cast<uint32_t>(run);
+        if (i == utf8.size()) {
+            break;
+        }
+        uint32_t cp;
+        const size_t len = decode_sequence(utf8.data() + i, utf8.size() - i, cp);
+        if (len == 0) {
+            return Error{Errc::type_mismatch, "wl_utf8_to_utf16: invalid UTF-8"};
+        }
+        i += len;
+        if (cp < 0x10000) {
+            out[o++] = static_cast<char16_t>(cp);
+        } else {
+            cp -= 0x10000;
+            out[o++] = static_cast<char16_t>(0xd800 + (cp >> 10));
+            out[o++] = static_cast<char16_t>(0xdc00 + (cp & 0x3ff));
+        }
+    }
+    return o;
+}
+
+size_t wl_utf8_length(std::u16string_view utf16) noexcept {
+    size_t bytes = 0;
+    size_t i = 0;
+    while (i < utf16.size()) {
+        const size_t run = ascii_prefix16(utf16.data() + i, utf16.size() - i);
+        bytes += run;
+        i += run;
+        if (i == utf16.size()) {
+            break;
+        }
+        const uint32_t cp = next_code_point(utf16, i);
+        bytes += cp < 0x800 ? 2 : (cp < 0x10000 ? 3 : 4);
+    }
+    return bytes;
+}
+
+uint32_t wl_utf16_to_utf8(std::u16string_view utf16, uint8_t* out) noexcept {
+    uint32_t o = 0;
+    size_t i = 0;
+    while (i < utf16.size()) {
+        const size_t run = ascii_prefix16(utf16.data() + i, utf16.size() - i);
+        narrow_ascii(utf16.data() + i, out + o, run);
+        i += run;
+        o += static_cast<uint32_t>(run);
+        if (i == utf16.size()) {
+            break;
+        }
+        const uint32_t cp = next_code_point(utf16, i);
+        if (cp < 0x800) {
+            out[o++] = static_cast<uint8_t>(0xc0 | (cp >> 6));
+        } else if (cp < 0x10000) {
+            out[o++] = static_cast<uint8_t>(0xe0 | (cp >> 12));
+            out[o++] = static_cast<uint8_t>(0x80 | ((cp >> 6) & 0x3f));
+        } else {
+            out[o++] = static_cast<uint8_t>(0xf0 | (cp >> 18));
+            out[o++] = static_cast<uint8_t>(0x80 | ((cp >> 12) & 0x3f));
+            out[o++] = static_cast<uint8_t>(0x80 | ((cp >> 6) & 0x3f));
+        }
+        out[o++] = static_cast<uint8_t>(0x80 | (cp & 0x3f));
+    }
+    return o;
+}
+
+WL_VALUE wl_make_string16(std::u16string_view utf16, bool free_flag_for_receiver) noexcept {
+    if (utf16.size() > (UINT32_MAX - sizeof(BaseContainer)) / 2) {
+        return 0;
+    }
+    const uint32_t meta = wl_owned_meta(WL_TAG_STRING16, free_flag_for_receiver);
+    const uint32_t size = static_cast<uint32_t>(utf16.size() * 2);
+    BaseContainer* c = wl_alloc_container(meta, size);
+    if (!c) return 0;
+    if (size) {
+        memcpy(c->data, utf16.data(), size);
+    }
+    c->size = size;
+    return wl_make(meta, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(c)));
+}
+
+WL_VALUE wl_make_string16(std::string_view utf8, bool free_flag_for_receiver) noexcept {
+    // UTF-16 never needs more code units than UTF-8 has bytes.
+    if (utf8.size() > (UINT32_MAX - sizeof(BaseContainer)) / 2) {
+        return 0;
+    }
+    const uint32_t meta = wl_owned_meta(WL_TAG_STRING16, free_flag_for_receiver);
+    BaseContainer* c = wl_alloc_container(meta, static_cast<uint32_t>(utf8.size() * 2));
+    if (!c) return 0;
+    // Container data is 8-aligned, so it can be written as char16_t.
+    const auto units = wl_utf8_to_utf16(
+        std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(utf8.data()), utf8.size()),
+        reinterpret_cast<char16_t*>(c->data));
+    if (!units) {
+        wl_free_container(c, meta);
+        return wl_make_error(units.error());
+    }
+    c->size = *units * 2;
+    return wl_make(meta, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(c)));
+}
+
+WL_VALUE wl_make_text(std::string_view utf8, bool free_flag_for_receiver) noexcept {
+    const std::span<const uint8_t> bytes(reinterpret_cast<const uint8_t*>(utf8.data()), utf8.size());
+    if (utf8.size() < WL_STRING16_MIN_BYTES || wl_ascii_prefix(bytes) == utf8.size()) {
+        return wl_make_string(utf8, free_flag_for_receiver);
+    }
+    const WL_VALUE v = wl_make_string16(utf8, free_flag_for_receiver);
+    if (v && wl_get_tag(v) == WL_TAG_ERROR) {
+        // Not valid UTF-8: pass the bytes through unchanged.
+        walink_free(v);
+        return wl_make_string(utf8, free_flag_for_receiver);
+    }
+    return v;
+}
+
+} // namespace walink
+
+extern "C" {
+
+WL_VALUE walink_utf8_validate(WL_VALUE value) noexcept {
+    const uint32_t tag = walink::wl_get_tag(value);
+    if (tag != WL_TAG_STRING && tag != WL_TAG_BYTES) {
+        return walink::wl_make_error("walink_utf8_validate: expected STRING or BYTES");
+    }
+    // an owned input is released when `bytes` goes out of scope
+    const auto bytes = walink::wl_try_borrow_base_container(value, /*allow_free*/ true);
+    if (!bytes) {
+        return walink::wl_make_error(bytes.error());
+    }
+    return walink::wl_from_bool(walink::wl_utf8_validate(bytes->bytes()));
+}
+
+WL_VALUE walink_string_to_utf16(WL_VALUE value) noexcept {
+    const auto str = walink::wl_try_borrow_string(value, /*allow_free*/ true);
+    if (!str) {
+        return walink::wl_make_error(str.error());
+    }
+    const WL_VALUE out = walink::wl_make_string16(str->str(), true);
+    return out ? out : walink::wl_make_error("walink_string_to_utf16: allocation failed");
+}
+
+} // extern "C"
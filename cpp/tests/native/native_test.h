@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// Minimal harness shared by the native ctest suites (tests/native/).
+//
+//     int main() {
+//         walink_test::init();
+//         walink_test::run("case name", [] { WL_CHECK(1 + 1 == 2); });
+//         return walink_test::finish("suite");
+//     }
+//
+// WL_CHECK records a failure and keeps going; finish() prints a summary and
+// returns the process exit code.
+
+namespace walink_test {
+
+struct State {
+    int failures = 0;
+    int cases = 0;
+    const char* current = "";
+};
+
+inline State& state() noexcept {
+    static State s;
+    return s;
+}
+
+inline void init() noexcept {
+#if defined(__GLIBC__)
+    // WL_VALUE payloads are 32-bit addresses: keep every block in the brk heap
+    // (below 4GiB with -no-pie), i.e. no mmap'd chunks and no per-thread arenas.
+    mallopt(M_MMAP_MAX, 0);
+    mallopt(M_ARENA_MAX, 1);
+#endif
+}
+
+inline void fail(const char* file, int line, const char* expr) noexcept {
+    ++state().failures;
+    fprintf(stderr, "FAIL [%s] %s:%d: %s\n", state().current, file, line, expr);
+}
+
+template <typename Fn>
+inline void run(const char* name, Fn&& fn) {
+    State& s = state();
+    const int before = s.failures;
+    s.current = name;
+    ++s.cases;
+    fn();
+    printf("%-60s %s\n", name, s.failures == before ? "ok" : "FAILED");
+    fflush(stdout);
+}
+
+inline int finish(const char* suite) noexcept {
+    const State& s = state();
+    printf("%s: %d cases, %d failed checks\n", suite, s.cases, s.failures);
+    return s.failures == 0 ? 0 : 1;
+}
+
+} // namespace walink_test
+
+#define WL_CHECK(cond)                                          \
+    do {                                                        \
+        if (!(cond)) {                                          \
+            ::walink_test::fail(__FILE__, __LINE__, #cond);     \
+        }                                                       \
+    } while (0)
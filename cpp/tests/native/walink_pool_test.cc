@@ -0,0 +1,146 @@
+#include "walink.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "native_test.h"
+
+// Size-class pool behind walink_alloc / walink_free in a WALINK_POOL_ALLOCATOR
+// build (single heap, no threads). The wasm test module is built without the
+// option, so the pool itself is checked here.
+
+namespace {
+
+constexpr uint32_t kClassSizes[] = {8, 16, 24, 32, 48, 64, 96, 128, 192, 256};
+constexpr uint32_t kLargeSize = 257;
+
+WL_VALUE host_block(WL_VALUE allocated) {
+    // walink_alloc hands out a bare pointer; the host tags it before freeing
+    return walink::wl_make(WL_META_IS_ADDRESS | WL_TAG_BYTES, walink::wl_get_payload32(allocated));
+}
+
+uintptr_t address_of(WL_VALUE v) {
+    return static_cast<uintptr_t>(walink::wl_get_payload32(v));
+}
+
+void test_reuse_within_class() {
+    for (const uint32_t size : kClassSizes) {
+        void* p = walink::wl_pool_alloc(size);
+        WL_CHECK(p != nullptr);
+        WL_CHECK(reinterpret_cast<uintptr_t>(p) % 8 == 0);
+        memset(p, 0xab, size);
+        walink::wl_pool_free(p);
+
+        // the class free list hands the block straight back, also for the
+        // smallest size that maps to the same class
+        WL_CHECK(walink::wl_pool_alloc(size) == p);
+        walink::wl_pool_free(p);
+        WL_CHECK(walink::wl_pool_alloc(size - 7) == p);
+        walink::wl_pool_free(p);
+    }
+}
+
+void test_classes_do_not_share_blocks() {
+    void* small = walink::wl_pool_alloc(16);
+    walink::wl_pool_free(small);
+    // a free 16-byte block is not handed out for a bigger class
+    void* bigger = walink::wl_pool_alloc(17);
+    WL_CHECK(bigger != small);
+    walink::wl_pool_free(bigger);
+}
+
+void test_live_blocks_do_not_overlap() {
+    constexpr uint32_t kSize = 48;
+    std::vector<uint8_t*> blocks;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        auto* p = static_cast<uint8_t*>(walink::wl_pool_alloc(kSize));
+        WL_CHECK(p != nullptr);
+        memset(p, static_cast<int>(i & 0xff), kSize);
+        blocks.push_back(p);
+    }
+    for (uint32_t i = 0; i < blocks.size(); ++i) {
+        for (uint32_t j = 0; j < kSize; ++j) {
+            if (blocks[i][j] != static_cast<uint8_t>(i & 0xff)) {
+                WL_CHECK(!"block overwritten by a neighbour");
+                break;
+            }
+        }
+    }
+    for (uint8_t* p : blocks) {
+        walink::wl_pool_free(p);
+    }
+}
+
+void test_large_fallback() {
+    auto* large = static_cast<uint8_t*>(walink::wl_pool_alloc(kLargeSize));
+    WL_CHECK(large != nullptr);
+    WL_CHECK(reinterpret_cast<uintptr_t>(large) % 8 == 0);
+    memset(large, 0xcd, kLargeSize);
+    walink::wl_pool_free(large);
+
+    // back to malloc, not onto the 256-byte class list
+    void* biggest_class = walink::wl_pool_alloc(256);
+    WL_CHECK(biggest_class != large);
+    walink::wl_pool_free(biggest_class);
+#if defined(__GLIBC__)
+    // glibc hands the just-freed chunk (8-byte pool header + payload) back
+    void* raw = malloc(8 + kLargeSize);
+    WL_CHECK(raw == large - 8);
+    free(raw);
+#endif
+
+    WL_CHECK(walink::wl_pool_alloc(0xffffffffu) == nullptr);
+}
+
+void test_walink_alloc_uses_pool() {
+    const WL_VALUE first = host_block(walink_alloc(40));
+    WL_CHECK(address_of(first) != 0);
+    WL_CHECK(walink_free(first) == walink::wl_from_bool(true));
+    const WL_VALUE second = host_block(walink_alloc(40));
+    WL_CHECK(address_of(second) == address_of(first));
+    walink_free(second);
+
+    const WL_VALUE large = host_block(walink_alloc(4096));
+    WL_CHECK(address_of(large) != 0);
+    WL_CHECK(walink_free(large) == walink::wl_from_bool(true));
+}
+
+void test_scratch_slot_free_rejected() {
+    const WL_VALUE scalar = walink::wl_from_f64(1.5);
+    WL_CHECK(walink::wl_is_scratch_slot(reinterpret_cast<const void*>(address_of(scalar))));
+    WL_CHECK(walink_free(scalar) == walink::wl_from_bool(false));
+    WL_CHECK(walink::wl_to_f64(scalar, false) == 1.5);
+
+    // nothing from the slot table ended up on a class free list
+    const uintptr_t slot = address_of(scalar);
+    const uintptr_t table = address_of(walink_scratch_slots());
+    std::vector<void*> blocks;
+    for (const uint32_t size : kClassSizes) {
+        for (uint32_t i = 0; i < 4; ++i) {
+            void* p = walink::wl_pool_alloc(size);
+            const auto addr = reinterpret_cast<uintptr_t>(p);
+            WL_CHECK(addr + size <= slot - 512 || addr >= slot + 512);
+            WL_CHECK(addr + size <= table - 512 || addr >= table + 512);
+            blocks.push_back(p);
+        }
+    }
+    for (void* p : blocks) {
+        walink::wl_pool_free(p);
+    }
+}
+
+} // namespace
+
+int main() {
+    walink_test::init();
+    walink_test::run("reuse within each size class", test_reuse_within_class);
+    walink_test::run("classes do not share blocks", test_classes_do_not_share_blocks);
+    walink_test::run("live blocks do not overlap", test_live_blocks_do_not_overlap);
+    walink_test::run("large blocks fall back to malloc", test_large_fallback);
+    walink_test::run("walink_alloc / walink_free use the pool", test_walink_alloc_uses_pool);
+    walink_test::run("scratch-slot free rejected", test_scratch_slot_free_rejected);
+    return walink_test::finish("walink_pool_test");
+}
@@ -0,0 +1,259 @@
+#include "walink.h"
+#include "walink_ring.h"
+#include "walink_stats.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "native_test.h"
+
+// Request/response ring (walink_ring.h) with the worker loop on a second
+// thread, the same split as the Node host and its wasm worker. Built with
+// WALINK_THREADS=1 and WALINK_STATS=1 (owned values left in a stopped channel
+// must still be released).
+
+namespace {
+
+constexpr uint32_t kAddSint32 = 1;
+constexpr uint32_t kEchoString = 2;
+
+WL_VALUE ring_add_sint32(const WL_VALUE* args, uint32_t argc) {
+    if (argc != 2) {
+        return walink::wl_make_error("ring_add_sint32: expected 2 arguments");
+    }
+    return walink::wl_from_sint32(walink::wl_to_sint32(args[0]) + walink::wl_to_sint32(args[1]));
+}
+
+// Owned STRING in, owned STRING out.
+WL_VALUE ring_echo_string(const WL_VALUE* args, uint32_t argc) {
+    if (argc != 1) {
+        return walink::wl_make_error("ring_echo_string: expected 1 argument");
+    }
+    auto s = walink::wl_try_to_string(args[0], true);
+    if (!s) {
+        return walink::wl_make_error(s.error());
+    }
+    return walink::wl_make_string(*s, true);
+}
+
+WL_BATCH_REGISTER(kAddSint32, ring_add_sint32);
+WL_BATCH_REGISTER(kEchoString, ring_echo_string);
+
+constexpr auto kTimeout = std::chrono::seconds(5);
+
+uint32_t load_index(WlRingChannel* ch, uint32_t ring_offset, uint32_t field) {
+    auto* word = reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(ch) + ring_offset + field);
+    return std::atomic_ref<uint32_t>(*word).load(std::memory_order_acquire);
+}
+
+uint32_t requests_consumed(WlRingChannel* ch) {
+    return load_index(ch, ch->request_offset, WL_RING_HEAD_OFFSET);
+}
+
+uint32_t responses_written(WlRingChannel* ch) {
+    return load_index(ch, ch->response_offset, WL_RING_TAIL_OFFSET);
+}
+
+template <typename Pred>
+bool wait_until(Pred&& pred) {
+    const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        sched_yield();
+    }
+    return true;
+}
+
+// Runs wl_ring_run on a thread whose stack (and so its TLS, scratch slots
+// included) comes from the heap, below 4GiB like everything else a WL_VALUE
+// points at.
+class Worker {
+public:
+    explicit Worker(WlRingChannel* ch) : ch_(ch) {
+        stack_ = aligned_alloc(4096, kStackSize);
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setstack(&attr, stack_, kStackSize);
+        pthread_create(&thread_, &attr, &Worker::main, this);
+        pthread_attr_destroy(&attr);
+    }
+
+    Worker(const Worker&) = delete;
+    Worker& operator=(const Worker&) = delete;
+
+    // A worker that does not return cannot be joined: report and bail out
+    // instead of hanging the whole suite.
+    uint32_t join() {
+        if (!wait_until([this] { return done_.load(std::memory_order_acquire); })) {
+            fprintf(stderr, "FAIL [%s] wl_ring_run did not return after stop\n", walink_test::state().current);
+            fflush(stderr);
+            _exit(1);
+        }
+        pthread_join(thread_, nullptr);
+        free(stack_);
+        return processed_;
+    }
+
+private:
+    static constexpr size_t kStackSize = 1u << 20;
+
+    static void* main(void* self) {
+        auto* w = static_cast<Worker*>(self);
+        w->processed_ = walink::wl_ring_run(w->ch_);
+        w->done_.store(true, std::memory_order_release);
+        return nullptr;
+    }
+
+    WlRingChannel* ch_;
+    void* stack_ = nullptr;
+    pthread_t thread_{};
+    uint32_t processed_ = 0;
+    std::atomic<bool> done_{false};
+};
+
+bool post_add(WlRingChannel* ch, uint64_t id, int32_t a, int32_t b) {
+    const WL_VALUE args[2] = {walink::wl_from_sint32(a), walink::wl_from_sint32(b)};
+    return walink::wl_ring_post(ch, id, kAddSint32, args, 2);
+}
+
+bool post_echo(WlRingChannel* ch, uint64_t id, const std::string& s) {
+    const WL_VALUE arg = walink::wl_make_string(s, true);
+    if (walink::wl_ring_post(ch, id, kEchoString, &arg, 1)) {
+        return true;
+    }
+    walink_free(arg);
+    return false;
+}
+
+// Next response, waiting for the worker to produce it.
+bool collect(WlRingChannel* ch, WlRingResponse* out) {
+    return wait_until([&] { return walink::wl_ring_poll(ch, out); });
+}
+
+void test_post_then_collect() {
+    WlRingChannel* ch = walink::wl_ring_create(8);
+    WL_CHECK(ch != nullptr && ch->capacity == 8);
+    Worker worker(ch);
+
+    constexpr uint32_t kCalls = 1000;
+    uint32_t posted = 0;
+    uint32_t received = 0;
+    while (received < kCalls) {
+        while (posted < kCalls && post_add(ch, posted, static_cast<int32_t>(posted), 7)) {
+            ++posted;
+        }
+        WlRingResponse rs;
+        if (!collect(ch, &rs)) {
+            WL_CHECK(!"response timed out");
+            break;
+        }
+        WL_CHECK(rs.id == received);
+        WL_CHECK(walink::wl_to_sint32(rs.result) == static_cast<int32_t>(received) + 7);
+        ++received;
+    }
+
+    walink::wl_ring_stop(ch);
+    WL_CHECK(worker.join() == kCalls);
+    walink::wl_ring_destroy(ch);
+}
+
+void test_request_ring_backpressure() {
+    WlRingChannel* ch = walink::wl_ring_create(4);
+    for (uint32_t i = 0; i < 4; ++i) {
+        WL_CHECK(post_add(ch, i, 1, 1));
+    }
+    // full until the worker consumes something
+    WL_CHECK(!post_add(ch, 4, 1, 1));
+
+    Worker worker(ch);
+    WL_CHECK(wait_until([&] { return requests_consumed(ch) == 4; }));
+    WL_CHECK(post_add(ch, 4, 2, 2));
+
+    for (uint32_t i = 0; i < 5; ++i) {
+        WlRingResponse rs;
+        WL_CHECK(collect(ch, &rs));
+        WL_CHECK(rs.id == i);
+        WL_CHECK(walink::wl_to_sint32(rs.result) == (i < 4 ? 2 : 4));
+    }
+
+    walink::wl_ring_stop(ch);
+    WL_CHECK(worker.join() == 5);
+    walink::wl_ring_destroy(ch);
+}
+
+void test_response_ring_backpressure() {
+    WlRingChannel* ch = walink::wl_ring_create(2);
+    Worker worker(ch);
+    for (uint32_t i = 0; i < 4; ++i) {
+        WL_CHECK(wait_until([&] { return post_add(ch, i, static_cast<int32_t>(i), 0); }));
+    }
+
+    // two responses fill the ring; the worker takes the third request and
+    // blocks until an entry is released
+    WL_CHECK(wait_until([&] { return requests_consumed(ch) == 3; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    WL_CHECK(responses_written(ch) == 2);
+    WL_CHECK(requests_consumed(ch) == 3);
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        WlRingResponse rs;
+        WL_CHECK(collect(ch, &rs));
+        WL_CHECK(rs.id == i && walink::wl_to_sint32(rs.result) == static_cast<int32_t>(i));
+    }
+
+    walink::wl_ring_stop(ch);
+    WL_CHECK(worker.join() == 4);
+    walink::wl_ring_destroy(ch);
+}
+
+void test_stop_while_waiting_for_requests() {
+    WlRingChannel* ch = walink::wl_ring_create(4);
+    Worker worker(ch);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    walink::wl_ring_stop(ch);
+    WL_CHECK(worker.join() == 0);
+    walink::wl_ring_destroy(ch);
+}
+
+void test_stop_while_blocked_on_full_response_ring() {
+    const uint32_t live_before = walink::wl_stats().live_blocks;
+
+    WlRingChannel* ch = walink::wl_ring_create(2);
+    Worker worker(ch);
+    for (uint32_t i = 0; i < 4; ++i) {
+        WL_CHECK(wait_until([&] { return post_echo(ch, i, "payload " + std::to_string(i)); }));
+    }
+    WL_CHECK(wait_until([&] { return requests_consumed(ch) == 3; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    WL_CHECK(responses_written(ch) == 2);
+
+    // nobody drains any more: stop alone has to end the wait
+    walink::wl_ring_stop(ch);
+    WL_CHECK(worker.join() == 2);
+
+    // the undelivered third result was released by the worker; the two
+    // unread responses and the fourth request's argument go with the channel
+    walink::wl_ring_destroy(ch);
+    WL_CHECK(walink::wl_stats().live_blocks == live_before);
+}
+
+} // namespace
+
+int main() {
+    walink_test::init();
+    walink_test::run("post then collect", test_post_then_collect);
+    walink_test::run("request ring backpressure", test_request_ring_backpressure);
+    walink_test::run("response ring backpressure", test_response_ring_backpressure);
+    walink_test::run("stop while waiting for requests", test_stop_while_waiting_for_requests);
+    walink_test::run("stop while blocked on a full response ring", test_stop_while_blocked_on_full_response_ring);
+    return walink_test::finish("walink_ring_test");
+}
@@ -0,0 +1,145 @@
+#include "walink.h"
+#include "walink_stats.h"
+
+#include <string>
+
+#include "native_test.h"
+
+// Allocation counters of a WALINK_STATS build (walink_stats.h). The Node
+// integration tests run against the default wasm build, where walink_stats()
+// is 0, so the instrumentation itself is checked here.
+
+namespace {
+
+WL_VALUE host_block(WL_VALUE allocated) {
+    // walink_alloc hands out a bare pointer; the host tags it before freeing
+    return walink::wl_make(WL_META_IS_ADDRESS | WL_TAG_BYTES, walink::wl_get_payload32(allocated));
+}
+
+void test_live_blocks_by_kind() {
+    const WlStats before = walink::wl_stats();
+    WL_CHECK(before.version == WL_STATS_VERSION);
+
+    const WL_VALUE value = walink::wl_make_string("hello from wasm", true);
+    const WlStats during = walink::wl_stats();
+    WL_CHECK(during.live_blocks == before.live_blocks + 1);
+    WL_CHECK(during.live_by_kind[WL_STATS_STRING] == before.live_by_kind[WL_STATS_STRING] + 1);
+    WL_CHECK(during.alloc_count == before.alloc_count + 1);
+    WL_CHECK(during.live_bytes > before.live_bytes);
+
+    // released the way the host does (ContainerRef would park it in the
+    // recycle cache, where it stays live)
+    WL_CHECK(walink::wl_read_base_container(value, false) == "hello from wasm");
+    WL_CHECK(walink_free(value) == walink::wl_from_bool(true));
+    const WlStats after = walink::wl_stats();
+    WL_CHECK(after.live_blocks == before.live_blocks);
+    WL_CHECK(after.live_by_kind[WL_STATS_STRING] == before.live_by_kind[WL_STATS_STRING]);
+    WL_CHECK(after.live_bytes == before.live_bytes);
+    WL_CHECK(after.free_count == before.free_count + 1);
+    WL_CHECK(after.peak_bytes >= during.live_bytes);
+}
+
+void test_kinds_follow_tags() {
+    const WlStats before = walink::wl_stats();
+    const WL_VALUE host = host_block(walink_alloc(32));
+    const WL_VALUE boxed = walink::wl_make_f64(2.5, true);
+    const WL_VALUE error = walink::wl_make_error("failed");
+
+    const WlStats during = walink::wl_stats();
+    WL_CHECK(during.live_by_kind[WL_STATS_HOST] == before.live_by_kind[WL_STATS_HOST] + 1);
+    WL_CHECK(during.live_by_kind[WL_STATS_SCALAR] == before.live_by_kind[WL_STATS_SCALAR] + 1);
+    WL_CHECK(during.live_by_kind[WL_STATS_ERROR] == before.live_by_kind[WL_STATS_ERROR] + 1);
+
+    walink_free(host);
+    walink_free(boxed);
+    walink_free(error);
+    WL_CHECK(walink::wl_stats().live_blocks == before.live_blocks);
+}
+
+void test_size_histogram() {
+    const WlStats before = walink::wl_stats();
+    const WL_VALUE small = host_block(walink_alloc(16));
+    const WL_VALUE medium = host_block(walink_alloc(100));
+    const WlStats during = walink::wl_stats();
+    // bucket i: at most 16 << i bytes
+    WL_CHECK(during.size_histogram[0] == before.size_histogram[0] + 1);
+    WL_CHECK(during.size_histogram[3] == before.size_histogram[3] + 1);
+    walink_free(small);
+    walink_free(medium);
+}
+
+void test_double_free_before_reuse() {
+    const WlStats before = walink::wl_stats();
+    const WL_VALUE value = walink::wl_make_string("freed twice", true);
+    WL_CHECK(walink_free(value) == walink::wl_from_bool(true));
+    // refused only because the block has not been handed out again yet
+    WL_CHECK(walink_free(value) == walink::wl_from_bool(false));
+
+    const WlStats after = walink::wl_stats();
+    WL_CHECK(after.bad_free_count == before.bad_free_count + 1);
+    WL_CHECK(after.free_count == before.free_count + 1);
+    WL_CHECK(after.live_blocks == before.live_blocks);
+}
+
+void test_recycled_block_is_not_freed_again() {
+    const WlStats before = walink::wl_stats();
+    const WL_VALUE value = walink::wl_make_string("parked", true);
+    WL_CHECK(walink_recycle(value) == walink::wl_from_bool(true));
+    WL_CHECK(walink::wl_stats().live_by_kind[WL_STATS_RECYCLED] == before.live_by_kind[WL_STATS_RECYCLED] + 1);
+    // the cache owns it now
+    WL_CHECK(walink_free(value) == walink::wl_from_bool(false));
+    WL_CHECK(walink::wl_stats().bad_free_count == before.bad_free_count + 1);
+
+    // handed back out by the next allocation of a similar size
+    const WL_VALUE next = walink::wl_make_string("reused", true);
+    WL_CHECK(walink::wl_get_payload32(next) == walink::wl_get_payload32(value));
+    WL_CHECK(walink::wl_stats().live_by_kind[WL_STATS_RECYCLED] == before.live_by_kind[WL_STATS_RECYCLED]);
+    walink_free(next);
+}
+
+void test_invalid_frees() {
+    const WlStats before = walink::wl_stats();
+    WL_CHECK(walink_free(walink::wl_from_sint32(7)) == walink::wl_from_bool(false));
+    WL_CHECK(walink_free(walink::wl_from_f64(1.5)) == walink::wl_from_bool(false));
+    const WlStats after = walink::wl_stats();
+    WL_CHECK(after.invalid_free_count == before.invalid_free_count + 2);
+    WL_CHECK(after.bad_free_count == before.bad_free_count);
+    WL_CHECK(after.free_count == before.free_count);
+}
+
+void test_arena_allocations_are_not_counted() {
+    const WlStats before = walink::wl_stats();
+    walink_arena_enable(1);
+    const WL_VALUE value = walink::wl_make_string(std::string(200, 'a'), true);
+    WL_CHECK(walink::wl_has_arena_flag(value));
+    WL_CHECK(walink::wl_stats().live_blocks == before.live_blocks);
+    walink_arena_reset();
+    walink_arena_enable(0);
+    WL_CHECK(walink::wl_stats().alloc_count == before.alloc_count);
+}
+
+void test_snapshot_export() {
+    const WL_VALUE value = walink::wl_make_bytes("abc", true);
+    const WL_VALUE snapshot = walink_stats();
+    WL_CHECK(snapshot != 0);
+    const auto* stats = reinterpret_cast<const WlStats*>(static_cast<uintptr_t>(walink::wl_get_payload32(snapshot)));
+    WL_CHECK(stats->version == WL_STATS_VERSION);
+    WL_CHECK(stats->live_blocks == walink::wl_stats().live_blocks);
+    WL_CHECK(stats->live_by_kind[WL_STATS_BYTES] >= 1);
+    walink_free(value);
+}
+
+} // namespace
+
+int main() {
+    walink_test::init();
+    walink_test::run("live blocks by kind", test_live_blocks_by_kind);
+    walink_test::run("kinds follow tags", test_kinds_follow_tags);
+    walink_test::run("size histogram", test_size_histogram);
+    walink_test::run("double free refused before the block is reused", test_double_free_before_reuse);
+    walink_test::run("recycled block is not freed again", test_recycled_block_is_not_freed_again);
+    walink_test::run("invalid frees", test_invalid_frees);
+    walink_test::run("arena allocations are not counted", test_arena_allocations_are_not_counted);
+    walink_test::run("walink_stats snapshot", test_snapshot_export);
+    return walink_test::finish("walink_stats_test");
+}
@@ -0,0 +1,132 @@
+#include "walink.h"
+#include "walink_export.h"
+#include "walink_trace.h"
+
+#include <string>
+#include <string_view>
+
+#include "native_test.h"
+
+// WL_EXPORT call tracing of a WALINK_TRACE build (walink_trace.h). The Node
+// integration tests run against the default wasm build, where
+// walink_trace_buffer() is 0, so the records themselves are checked here.
+
+namespace {
+
+std::string trace_concat(std::string_view a, std::string_view b) {
+    std::string out(a);
+    out += b;
+    return out;
+}
+
+int32_t g_touched = 0;
+
+void trace_touch(int32_t value) {
+    g_touched = value;
+}
+
+} // namespace
+
+WL_EXPORT(trace_concat, trace_concat);
+WL_EXPORT(trace_touch, trace_touch);
+
+namespace {
+
+const WlTraceRing& ring() {
+    const WL_VALUE buffer = walink_trace_buffer();
+    return *reinterpret_cast<const WlTraceRing*>(static_cast<uintptr_t>(walink::wl_get_payload32(buffer)));
+}
+
+const WlTraceRecord& record(uint32_t i) {
+    return ring().records[i & (ring().capacity - 1)];
+}
+
+// Calls an export through its packed entry point, as the batch path does.
+WL_VALUE call(const char* name, const WL_VALUE* args, uint32_t argc) {
+    const walink::ExportInfo* info = walink::wl_export_find(name);
+    return info->invoke(args, argc);
+}
+
+void test_ring_header() {
+    const WL_VALUE buffer = walink_trace_buffer();
+    WL_CHECK(buffer != 0);
+    WL_CHECK(walink::wl_get_meta(buffer) == 0);
+    WL_CHECK(ring().capacity == WL_TRACE_CAPACITY);
+    WL_CHECK(ring().record_size == sizeof(WlTraceRecord));
+}
+
+void test_phases_in_order() {
+    const walink::ExportInfo* info = walink::wl_export_find("trace_concat");
+    WL_CHECK(info != nullptr);
+
+    const uint32_t start = ring().count;
+    const WL_VALUE args[2] = {walink::wl_make_string("foo", true), walink::wl_make_string("barbaz", true)};
+    const WL_VALUE result = call("trace_concat", args, 2);
+    WL_CHECK(walink::wl_to_string(result, true) == "foobarbaz");
+    WL_CHECK(ring().count == start + 4);
+
+    const uint32_t phases[4] = {WL_TRACE_BEGIN, WL_TRACE_ARGS, WL_TRACE_RETURN, WL_TRACE_END};
+    for (uint32_t i = 0; i < 4; ++i) {
+        WL_CHECK(record(start + i).export_id == info->id);
+        WL_CHECK(record(start + i).phase == phases[i]);
+        if (i > 0) {
+            WL_CHECK(record(start + i).time >= record(start + i - 1).time);
+        }
+    }
+    // container bytes of both arguments in, of the result out
+    WL_CHECK(record(start).bytes_in == 9);
+    WL_CHECK(record(start + 3).bytes_out == 9);
+}
+
+void test_void_export() {
+    const walink::ExportInfo* info = walink::wl_export_find("trace_touch");
+    const uint32_t start = ring().count;
+    const WL_VALUE arg = walink::wl_from_sint32(5);
+    WL_CHECK(call("trace_touch", &arg, 1) == walink::wl_null());
+    WL_CHECK(g_touched == 5);
+
+    WL_CHECK(ring().count == start + 4);
+    WL_CHECK(record(start).export_id == info->id);
+    WL_CHECK(record(start).bytes_in == 0);
+    WL_CHECK(record(start + 2).phase == WL_TRACE_RETURN);
+    WL_CHECK(record(start + 3).phase == WL_TRACE_END);
+    WL_CHECK(record(start + 3).bytes_out == 0);
+}
+
+void test_rejected_call() {
+    const uint32_t start = ring().count;
+    const WL_VALUE args[2] = {walink::wl_from_bool(true), walink::wl_from_bool(false)};
+    const WL_VALUE result = call("trace_concat", args, 2);
+    WL_CHECK(walink::wl_get_tag(result) == WL_TAG_ERROR);
+    walink_free(result);
+
+    // never reached the function: no ARGS / RETURN
+    WL_CHECK(ring().count == start + 2);
+    WL_CHECK(record(start).phase == WL_TRACE_BEGIN);
+    WL_CHECK(record(start + 1).phase == WL_TRACE_END);
+}
+
+void test_ring_wraps() {
+    const uint32_t start = ring().count;
+    const WL_VALUE arg = walink::wl_from_sint32(1);
+    const uint32_t calls = WL_TRACE_CAPACITY / 4 + 3;
+    for (uint32_t i = 0; i < calls; ++i) {
+        call("trace_touch", &arg, 1);
+    }
+    WL_CHECK(ring().count == start + calls * 4);
+    // the newest records overwrote the oldest ones in place
+    WL_CHECK(record(ring().count - 1).phase == WL_TRACE_END);
+    WL_CHECK(record(ring().count - 4).phase == WL_TRACE_BEGIN);
+}
+
+} // namespace
+
+int main() {
+    walink_test::init();
+    walink_test::run("ring header", test_ring_header);
+    walink_test::run("phases in order", test_phases_in_order);
+    walink_test::run("void export", test_void_export);
+    walink_test::run("rejected call", test_rejected_call);
+    walink_test::run("ring wraps", test_ring_wraps);
+    return walink_test::finish("walink_trace_test");
+}
@@ -1,83 +1,192 @@
 #include "walink.h"
+#include "walink_export.h"
+#include "walink_flat.h"
+#include "walink_handle.h"
+#include "walink_msgpack.h"
+#include "walink_stream.h"
+#include "walink_symbol.h"
+#include "walink_task.h"
+#include "walink_utf.h"
 
 #include <stdint.h>
 #include <stddef.h>
+#include <span>
+#include <string>
 #include <string_view>
+#include <vector>
 
 // Test-only C API implementations used for integration tests.
 // 라이브러리 코드와 분리하기 위해 별도 TU 및 빌드 타깃에서만 사용됩니다.
 // 메모리 할당/해제, 문자열/에러 생성은 walink 라이브러리의 공유 헬퍼를 사용합니다.
 
-namespace walink {
+namespace {
 
-// walink 라이브러리 쪽에서 정의된 헬퍼 함수들 (cpp/src/walink.cpp)
-// 여기서는 선언만 하고, 구현은 libwalink 에서 가져옵니다.
+// Scalar helpers are header-only (walink::codec<T>), so these compile down to
+// shifts and masks without a local copy.
+using walink::wl_from_sint32;
+using walink::wl_get_tag;
+using walink::wl_is_address;
+using walink::wl_to_sint32;
 
-BaseContainer*    wl_alloc_container(uint64_t size) noexcept;
-void              wl_free_container(BaseContainer* c) noexcept;
-Float64Container* wl_alloc_f64(double v) noexcept;
-void              wl_free_f64(Float64Container* c) noexcept;
+// --- Batchable test functions (walink_call_batch) ---------------------------
 
-WL_VALUE          wl_make_string(std::string_view sv,
-                                 bool free_flag_for_receiver) noexcept;
-WL_VALUE          wl_make_error(std::string_view msg) noexcept;
+constexpr uint32_t WL_TEST_BATCH_ADD_SINT32 = 1;
 
-} // namespace walink_internal
+WL_VALUE wl_batch_add_sint32(const WL_VALUE* args, uint32_t argc) {
+    if (argc != 2) {
+        return walink::wl_make_error("wl_batch_add_sint32: expected 2 arguments");
+    }
+    return wl_from_sint32(static_cast<std::int32_t>(wl_to_sint32(args[0]) + wl_to_sint32(args[1])));
+}
 
-namespace {
+WL_BATCH_REGISTER(WL_TEST_BATCH_ADD_SINT32, wl_batch_add_sint32);
 
-// --- Local WL_VALUE helpers (thin wrappers, no allocation logic) ------------
+constexpr uint32_t WL_TEST_BATCH_HALF_F64 = 2;
 
-inline uint32_t wl_get_meta(WL_VALUE v) noexcept {
-    return static_cast<uint32_t>(v >> 32);
+// FLOAT64 result through a scratch slot; walink_call_batch detaches it.
+WL_VALUE wl_batch_half_f64(const WL_VALUE* args, uint32_t argc) {
+    if (argc != 1) {
+        return walink::wl_make_error("wl_batch_half_f64: expected 1 argument");
+    }
+    return walink::wl_from_f64(wl_to_sint32(args[0]) / 2.0);
 }
 
-inline uint32_t wl_get_payload32(WL_VALUE v) noexcept {
-    return static_cast<uint32_t>(v & 0xffffffffu);
+WL_BATCH_REGISTER(WL_TEST_BATCH_HALF_F64, wl_batch_half_f64);
+
+constexpr uint32_t WL_TEST_BATCH_ADD_F64 = 3;
+
+// FLOAT64 arguments by address (copied behind the call list by WalinkBatch).
+WL_VALUE wl_batch_add_f64(const WL_VALUE* args, uint32_t argc) {
+    if (argc != 2) {
+        return walink::wl_make_error("wl_batch_add_f64: expected 2 arguments");
+    }
+    return walink::wl_from_f64(walink::wl_to_f64(args[0], true) + walink::wl_to_f64(args[1], true));
 }
 
-inline WL_VALUE wl_make(uint32_t meta, uint32_t payload) noexcept {
-    return (static_cast<WL_VALUE>(meta) << 32) | static_cast<WL_VALUE>(payload);
+WL_BATCH_REGISTER(WL_TEST_BATCH_ADD_F64, wl_batch_add_f64);
+
+// --- MessagePack visitor (walink_msgpack.h) ---------------------------------
+
+struct NumberSumVisitor : walink::msgpack::Visitor {
+    double sum = 0;
+    uint32_t count = 0;
+
+    bool on_int(int64_t v) noexcept { sum += static_cast<double>(v); ++count; return true; }
+    bool on_uint(uint64_t v) noexcept { sum += static_cast<double>(v); ++count; return true; }
+    bool on_double(double v) noexcept { sum += v; ++count; return true; }
+};
+
+// --- Handles (walink_handle.h) ----------------------------------------------
+
+// Stand-in for a large wasm-resident object; counts live instances so tests
+// can check that the last release destroys it.
+struct Counter {
+    static inline int32_t live = 0;
+    int64_t value;
+
+    explicit Counter(int64_t start) noexcept : value(start) { ++live; }
+    ~Counter() { --live; }
+};
+
+// --- Chunked streams (walink_stream.h) --------------------------------------
+
+// Source: `remaining` bytes of the pattern (i * 7 + 3) & 0xff.
+struct PatternSource {
+    uint32_t remaining;
+    uint32_t offset = 0;
+
+    walink::Result<uint32_t> read(std::span<uint8_t> buf) noexcept {
+        const uint32_t n = remaining < buf.size() ? remaining : static_cast<uint32_t>(buf.size());
+        for (uint32_t i = 0; i < n; ++i) {
+            buf[i] = static_cast<uint8_t>((offset + i) * 7u + 3u);
+        }
+        offset += n;
+        remaining -= n;
+        return n;
+    }
+};
+
+// Sink: counts bytes and sums them; closing returns {"bytes", "sum"}.
+struct ChecksumSink {
+    uint64_t bytes = 0;
+    uint64_t sum = 0;
+
+    walink::Error write(std::span<const uint8_t> chunk) noexcept {
+        for (const uint8_t b : chunk) {
+            sum += b;
+        }
+        bytes += chunk.size();
+        return {walink::Errc::ok, nullptr};
+    }
+
+    WL_VALUE finish() noexcept {
+        walink::msgpack::Writer writer(32);
+        writer.write_map_header(2)
+            .write_str("bytes").write_uint(bytes)
+            .write_str("sum").write_uint(sum);
+        return writer.finish();
+    }
+};
+
+// --- Auto-marshalled exports (walink_export.h) ------------------------------
+
+std::string concat_strings(std::string_view a, std::string_view b) {
+    std::string out;
+    out.reserve(a.size() + b.size());
+    out.append(a).append(b);
+    return out;
 }
 
-inline uint32_t wl_get_tag(WL_VALUE v) noexcept {
-    const auto meta = wl_get_meta(v);
-    return (meta & WL_META_TAG_MASK);
+double dot_f64(std::span<const double> a, std::span<const double> b) {
+    const size_t n = a.size() < b.size() ? a.size() : b.size();
+    double sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
 }
 
-inline bool wl_is_address(WL_VALUE v) noexcept {
-    return (wl_get_meta(v) & WL_META_IS_ADDRESS) != 0;
+int32_t clamp_sint32(int32_t v, int32_t lo, int32_t hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
 }
 
-inline uint32_t wl_build_meta(uint32_t tag,
-                              bool is_address,
-                              bool free_flag = false,
-                              bool user_defined = false) noexcept {
-    uint32_t meta = (tag & WL_META_TAG_MASK);
-    if (user_defined) {
-        meta |= WL_META_USER_DEFINED;
-    }
-    if (is_address) {
-        meta |= WL_META_IS_ADDRESS;
-    }
-    if (free_flag) {
-        meta |= WL_META_FREE_FLAG;
+// Status names come back as interned symbols: no allocation per call.
+walink::Symbol status_name(int32_t code) {
+    switch (code) {
+        case 0: return walink::wl_to_symbol(WL_SYMBOL("ok"));
+        case 1: return walink::wl_to_symbol(WL_SYMBOL("not_found"));
+        default: return walink::wl_to_symbol(WL_SYMBOL("denied"));
     }
-    return meta;
 }
 
-inline WL_VALUE wl_from_sint32(int32_t value) noexcept {
-    const uint32_t payload = static_cast<uint32_t>(value);
-    const uint32_t meta = wl_build_meta(WL_TAG_SINT32, /*is_address*/ false);
-    return wl_make(meta, payload);
+// Sum of 0..n-1, one budget unit per element: each walink_poll advances it
+// `budget` elements.
+walink::Task sum_below(uint32_t n) {
+    double sum = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        sum += i;
+        co_await walink::wl_step();
+    }
+    co_return walink::wl_from_f64(sum);
 }
 
-inline int32_t wl_to_sint32(WL_VALUE v) noexcept {
-    return static_cast<int32_t>(wl_get_payload32(v));
+// Ends with an ERROR result after `steps` units of work.
+walink::Task fail_after(uint32_t steps) {
+    for (uint32_t i = 0; i < steps; ++i) {
+        co_await walink::wl_step();
+    }
+    co_return walink::wl_make_error("fail_after: gave up");
 }
 
 } // namespace
 
+WL_EXPORT(wl_concat_strings, concat_strings);
+WL_EXPORT(wl_dot_f64, dot_f64);
+WL_EXPORT(wl_clamp_sint32, clamp_sint32);
+WL_EXPORT(wl_status_name, status_name);
+WL_EXPORT(wl_sum_below, sum_below);
+WL_EXPORT(wl_fail_after, fail_after);
+
 extern "C" {
 
 // --- Test-only exported APIs -------------------------------------------------
@@ -105,6 +214,66 @@ WL_VALUE wl_add_sint32(WL_VALUE a, WL_VALUE b) {
     return wl_from_sint32(result);
 }
 
+WL_VALUE wl_add_f64(WL_VALUE a, WL_VALUE b) {
+    const auto av = walink::wl_try_to_f64(a, true);
+    const auto bv = walink::wl_try_to_f64(b, true);
+    if (!av || !bv) {
+        return walink::wl_make_error(!av ? av.error() : bv.error());
+    }
+    return walink::wl_from_f64(*av + *bv);
+}
+
+WL_VALUE wl_add_sint64(WL_VALUE a, WL_VALUE b) {
+    const auto av = walink::wl_try_to_sint64(a, true);
+    const auto bv = walink::wl_try_to_sint64(b, true);
+    if (!av || !bv) {
+        return walink::wl_make_error(!av ? av.error() : bv.error());
+    }
+    return walink::wl_from_sint64(static_cast<int64_t>(static_cast<uint64_t>(*av) + static_cast<uint64_t>(*bv)));
+}
+
+WL_VALUE wl_scale_f64_array(WL_VALUE arr, WL_VALUE factor) {
+    // Released on every return below if the host handed over ownership.
+    const walink::ContainerRef owned_arr(arr, {}, walink::wl_has_free_flag(arr));
+    const auto in = walink::wl_try_view_array<double>(arr);
+    if (!in) {
+        return walink::wl_make_error(in.error());
+    }
+    const auto f = walink::wl_try_to_f64(factor, true);
+    if (!f) {
+        return walink::wl_make_error(f.error());
+    }
+
+    auto out = walink::wl_new_array<double>(static_cast<uint32_t>(in->size()), /*free_flag_for_receiver*/ true);
+    if (!out.value) {
+        return walink::wl_make_error("wl_scale_f64_array: allocation failed");
+    }
+    for (size_t i = 0; i < in->size(); ++i) {
+        out.items[i] = (*in)[i] * *f;
+    }
+    return out.value;
+}
+
+// Sums every number inside a msgpack value (parsed in place) and returns
+// {"sum": <double>, "count": <uint>} serialized directly into a container.
+WL_VALUE wl_msgpack_sum(WL_VALUE obj) {
+    NumberSumVisitor visitor;
+    const walink::msgpack::Status status = walink::msgpack::parse(obj, visitor);
+    if (walink::wl_has_free_flag(obj)) {
+        // the block is reused by the result writer below
+        walink::wl_recycle(obj);
+    }
+    if (status != walink::msgpack::Status::ok) {
+        return walink::wl_make_error("wl_msgpack_sum: invalid msgpack");
+    }
+
+    walink::msgpack::Writer writer(32);
+    writer.write_map_header(2)
+        .write_str("sum").write_double(visitor.sum)
+        .write_str("count").write_uint(visitor.count);
+    return writer.finish();
+}
+
 WL_VALUE wl_make_hello_string() {
     constexpr std::string_view msg = "hello from wasm";
     return walink::wl_make_string(msg, /*free_flag_for_receiver*/ true);
@@ -120,4 +289,132 @@ WL_VALUE wl_echo_string(WL_VALUE str_value) {
     return str_value;
 }
 
-} // extern "C"
\ No newline at end of file
+WL_VALUE wl_string_byte_length(WL_VALUE str_value) {
+    const uint32_t tag = wl_get_tag(str_value);
+    const bool is_addr = wl_is_address(str_value);
+
+    if (tag != WL_TAG_STRING || !is_addr) {
+        return walink::wl_make_error("wl_string_byte_length: invalid tag");
+    }
+
+    // Borrowed in place (no copy); freed on scope exit if the host handed over ownership.
+    const auto str = walink::wl_try_borrow_string(str_value, /*allow_free*/ true);
+    if (!str) {
+        return walink::wl_make_error(str.error());
+    }
+    return wl_from_sint32(static_cast<int32_t>(str->bytes().size()));
+}
+
+// Returns a BYTES source stream of `total` pattern bytes in `chunk`-byte pieces.
+WL_VALUE wl_stream_pattern(WL_VALUE total, WL_VALUE chunk) {
+    auto* source = new (std::nothrow) PatternSource{walink::wl_to_uint32(total)};
+    if (!source) {
+        return walink::wl_make_error("wl_stream_pattern: allocation failed");
+    }
+    const WL_VALUE stream = walink::wl_make_stream(source, WL_TAG_BYTES, walink::wl_to_uint32(chunk));
+    return stream ? stream : walink::wl_make_error("wl_stream_pattern: allocation failed");
+}
+
+// Returns a BYTES sink stream; walink_stream_close yields {"bytes", "sum"}.
+WL_VALUE wl_stream_checksum(WL_VALUE chunk) {
+    auto* sink = new (std::nothrow) ChecksumSink{};
+    if (!sink) {
+        return walink::wl_make_error("wl_stream_checksum: allocation failed");
+    }
+    const WL_VALUE stream = walink::wl_make_stream(sink, WL_TAG_BYTES, walink::wl_to_uint32(chunk));
+    return stream ? stream : walink::wl_make_error("wl_stream_checksum: allocation failed");
+}
+
+// Returns a HANDLE to a new Counter starting at `start` (one host reference).
+WL_VALUE wl_handle_make_counter(WL_VALUE start) {
+    const auto sv = walink::wl_try_to_sint64(start, true);
+    if (!sv) {
+        return walink::wl_make_error(sv.error());
+    }
+    const WL_VALUE handle = walink::wl_new_handle<Counter>(*sv);
+    return handle ? handle : walink::wl_make_error("wl_handle_make_counter: allocation failed");
+}
+
+// Adds `delta` to a borrowed Counter handle and returns the new value.
+WL_VALUE wl_handle_counter_add(WL_VALUE handle, WL_VALUE delta) {
+    const auto dv = walink::wl_try_to_sint64(delta, true);
+    if (!dv) {
+        return walink::wl_make_error(dv.error());
+    }
+    const auto counter = walink::wl_try_handle<Counter>(handle);
+    if (!counter) {
+        return walink::wl_make_error(counter.error());
+    }
+    (*counter)->value += *dv;
+    return walink::wl_from_sint64((*counter)->value);
+}
+
+// Number of Counter objects not yet destroyed.
+WL_VALUE wl_handle_live_counters() {
+    return wl_from_sint32(Counter::live);
+}
+
+// Returns a FLAT record with `count` entries under "items", so the host can
+// check that reading "id" / "name" does not depend on the record size.
+WL_VALUE wl_flat_record(WL_VALUE count) {
+    namespace flat = walink::flat;
+    const uint32_t n = walink::wl_to_uint32(count);
+
+    flat::Builder b;
+    std::vector<flat::Ref> items;
+    items.reserve(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        std::string label = "item-" + std::to_string(i);
+        items.push_back(b.map({
+            {"index", flat::Builder::uint32(i)},
+            {"label", b.string(label)},
+            {"weight", b.float64(i * 0.5)},
+        }));
+    }
+    const uint8_t blob[] = {1, 2, 3};
+    const flat::Ref root = b.map({
+        {"id", b.int64(-42)},
+        {"name", b.string("flat record")},
+        {"active", flat::Builder::boolean(true)},
+        {"ratio", flat::Builder::float32(0.25f)},
+        {"blob", b.bytes(blob)},
+        {"missing", flat::Builder::null()},
+        {"items", b.array(items)},
+    });
+    return b.finish(root);
+}
+
+// Wraps a borrowed STRING body in a fixed header/trailer with one copy per piece.
+WL_VALUE wl_gather_response(WL_VALUE body) {
+    const auto str = walink::wl_try_borrow_string(body, /*allow_free*/ true);
+    if (!str) {
+        return walink::wl_make_error(str.error());
+    }
+    const WL_VALUE out = walink::wl_make_string({"<header>", str->str(), "</trailer>"}, true);
+    return out ? out : walink::wl_make_error("wl_gather_response: allocation failed");
+}
+
+// IOVEC over static segments; the host releases only the segment list.
+WL_VALUE wl_iovec_greeting() {
+    static constexpr std::string_view kHello = "hello, ";
+    static constexpr std::string_view kEmpty = "";
+    static constexpr std::string_view kWorld = "iovec";
+    const WL_VALUE out = walink::wl_make_iovec({kHello, kEmpty, kWorld}, true);
+    return out ? out : walink::wl_make_error("wl_iovec_greeting: allocation failed");
+}
+
+// `str` repeated `times` times, returned as STRING or STRING16 (wl_make_text).
+WL_VALUE wl_text_repeat(WL_VALUE str, WL_VALUE times) {
+    const auto piece = walink::wl_try_borrow_string(str, /*allow_free*/ true);
+    if (!piece) {
+        return walink::wl_make_error(piece.error());
+    }
+    std::string out;
+    for (uint32_t i = walink::wl_to_uint32(times); i > 0; --i) {
+        out.append(piece->str());
+    }
+    const WL_VALUE v = walink::wl_make_text(out, true);
+    return v ? v : walink::wl_make_error("wl_text_repeat: allocation failed");
+}
+
+} // extern "C"
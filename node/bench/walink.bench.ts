@@ -0,0 +1,194 @@
+import { readFile, writeFile } from "node:fs/promises";
+import path from "node:path";
+import { fileURLToPath } from "node:url";
+
+import { afterAll, beforeAll, describe, expect, it } from "vitest";
+
+import { WalinkTrace, type WlValue } from "../src";
+import { createWalinkWithSampleApi, WalinkWithSampleApi } from "../test/walinkSampleApi";
+
+// JS -> wasm -> JS 왕복 비용을 tag / payload 크기별로 측정합니다.
+//
+//   pnpm bench
+//   WALINK_BENCH_OUT=bench-node.jsonl WALINK_BENCH_TIME_MS=500 pnpm bench
+//
+// 결과는 cpp/bench 의 `--json` 출력과 같은 형식(JSON Lines)으로
+// WALINK_BENCH_OUT 에 기록됩니다 (target: "node").
+
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = path.dirname(__filename);
+
+const timeBudgetMs = Number(process.env.WALINK_BENCH_TIME_MS ?? 200);
+const sizes = [16, 1024, 65536];
+
+interface BenchResult {
+  suite: string;
+  target: string;
+  name: string;
+  iterations: number;
+  ns_per_op: number;
+  bytes_per_op: number;
+}
+
+const results: BenchResult[] = [];
+
+// Warms the case up, then runs it in doubling batches until the time budget
+// is spent and records the mean.
+function measure(name: string, bytesPerOp: number, fn: () => unknown): BenchResult {
+  for (let i = 0; i < 200; i++) {
+    fn();
+  }
+  const budget = BigInt(Math.round(timeBudgetMs * 1e6));
+  const start = process.hrtime.bigint();
+  let elapsed = 0n;
+  let iterations = 0;
+  let batch = 1;
+  while (elapsed < budget) {
+    for (let i = 0; i < batch; i++) {
+      fn();
+    }
+    iterations += batch;
+    elapsed = process.hrtime.bigint() - start;
+    if (batch < 1 << 16) {
+      batch *= 2;
+    }
+  }
+  const result: BenchResult = {
+    suite: "walink.bench",
+    target: "node",
+    name,
+    iterations,
+    ns_per_op: Number(elapsed) / iterations,
+    bytes_per_op: bytesPerOp,
+  };
+  results.push(result);
+  return result;
+}
+
+function asciiPayload(size: number): string {
+  let s = "";
+  for (let i = 0; i < size; i++) {
+    s += String.fromCharCode(0x61 + (i % 26));
+  }
+  return s;
+}
+
+// 3-byte UTF-8 characters, rounded up to at least `size` bytes (the 1KiB
+// case must reach WL_STRING16_MIN_BYTES)
+function textPayload(size: number): string {
+  return "가".repeat(Math.ceil(size / 3));
+}
+
+async function loadWasmInstance(): Promise<WebAssembly.Instance> {
+  const wasmPath = path.resolve(__dirname, "../../cpp/build/walink_test.wasm");
+  const bytes = await readFile(wasmPath);
+
+  const wasmImports = {
+    emscripten_notify_memory_growth: () => {},
+    // -DWALINK_TRACE=ON 빌드에서만 import 됨
+    ...WalinkTrace.imports(),
+  };
+  const result = await WebAssembly.instantiate(bytes, {
+    'env': wasmImports,
+    'wasi_snapshot_preview1': wasmImports,
+  });
+  return result.instance;
+}
+
+describe("walink round-trip benchmarks", () => {
+  let walink: WalinkWithSampleApi;
+  let utf16: WalinkWithSampleApi;
+
+  beforeAll(async () => {
+    const instance = await loadWasmInstance();
+    walink = createWalinkWithSampleApi(instance);
+    utf16 = createWalinkWithSampleApi(instance, undefined, undefined, true);
+  });
+
+  afterAll(async () => {
+    console.table(results.map(({ name, iterations, ns_per_op, bytes_per_op }) => ({
+      name,
+      iterations,
+      "ns/op": ns_per_op.toFixed(1),
+      "MB/s": bytes_per_op === 0 ? "" : ((bytes_per_op * 1e3) / ns_per_op).toFixed(1),
+    })));
+    const out = process.env.WALINK_BENCH_OUT;
+    if (out) {
+      await writeFile(out, results.map((r) => JSON.stringify(r)).join("\n") + "\n");
+    }
+  });
+
+  it("direct scalars", () => {
+    expect(walink.roundtripBool(true)).toBe(true);
+    measure("BOOLEAN roundtrip_bool", 0, () => walink.roundtripBool(true));
+    measure("SINT32 add_sint32", 0, () => walink.addSint32(1, 2));
+  });
+
+  it("scratch slot scalars", () => {
+    measure("FLOAT64 add_f64", 0, () => walink.addF64(1.5, 2.25));
+    measure("SINT64 add_sint64", 0, () => walink.addSint64(2n ** 40n, 1n));
+  });
+
+  it("decode() switch on direct values", () => {
+    const values: WlValue[] = [
+      walink.toWlBool(true),
+      walink.toWlSint32(-7),
+      walink.toWlUint8(200),
+      walink.toWlFloat32(0.5),
+    ];
+    expect(values.map((v) => walink.decode(v))).toEqual([true, -7, 200, 0.5]);
+    measure("decode() x4 direct tags", 0, () => {
+      for (const v of values) {
+        walink.decode(v);
+      }
+    });
+  });
+
+  it("STRING echo", () => {
+    for (const size of sizes) {
+      const str = asciiPayload(size);
+      expect(walink.callRaw("wl_echo_string", walink.toWlString(str))).toBe(str);
+      measure(`STRING echo_string ${size}B`, size, () => walink.callRaw("wl_echo_string", walink.toWlString(str)));
+    }
+  });
+
+  // wl_make_text answers with STRING16 from WL_STRING16_MIN_BYTES up;
+  // utf16Strings only changes the argument side
+  it("non-ASCII text", () => {
+    for (const size of sizes) {
+      const str = textPayload(size);
+      const bytes = new TextEncoder().encode(str).length;
+      expect(walink.textRepeat(str, 1)).toBe(str);
+      expect(utf16.textRepeat(str, 1)).toBe(str);
+      measure(`text_repeat non-ASCII ${size}B (STRING in)`, bytes, () => walink.textRepeat(str, 1));
+      measure(`text_repeat non-ASCII ${size}B (STRING16 in)`, bytes, () => utf16.textRepeat(str, 1));
+    }
+  });
+
+  it("BYTES in", () => {
+    for (const size of sizes) {
+      const bytes = new TextEncoder().encode(asciiPayload(size));
+      expect(walink.utf8Valid(bytes)).toBe(true);
+      measure(`BYTES utf8_validate ${size}B`, size, () => walink.utf8Valid(bytes));
+    }
+  });
+
+  it("ARRAY_FLOAT64 scale", () => {
+    for (const size of sizes) {
+      const values = new Float64Array(size / 8).fill(0.25);
+      expect(walink.scaleF64Array(values, 2)[0]).toBe(0.5);
+      measure(`ARRAY_FLOAT64 scale_f64_array ${size}B`, size, () => walink.scaleF64Array(values, 2));
+    }
+  });
+
+  it("MSGPACK sum", () => {
+    for (const keys of [8, 512]) {
+      const obj: Record<string, number> = {};
+      for (let i = 0; i < keys; i++) {
+        obj[`k${i}`] = i;
+      }
+      expect(walink.msgpackSum(obj)).toEqual({ sum: (keys * (keys - 1)) / 2, count: keys });
+      measure(`MSGPACK msgpack_sum ${keys} keys`, 0, () => walink.msgpackSum(obj));
+    }
+  });
+});
@@ -7,3 +7,13 @@ export {
 export * as wlvalue from './wlvalue';
 
 export * from './walink';
+
+export * from './walinkRing';
+
+export * from './walinkStream';
+
+export * from './walinkHandle';
+
+export * from './walinkFlat';
+
+export * from './walinkTrace';
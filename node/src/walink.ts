@@ -2,7 +2,13 @@ import {
   type WlValue,
   type WlAddress,
   WlTag,
+  WL_META_ARENA_FLAG,
+  WL_SCRATCH_SLOT_COUNT,
+  hasArenaFlag,
   hasFreeFlag,
+  isAddress,
+  isSlot64Tag,
+  getMeta,
   getTag,
   getValueOrAddr,
   toBool,
@@ -24,8 +30,15 @@ import {
   makeMeta,
   makeValue,
   getAddress,
+  type WlTypedArray,
+  isArrayTag,
+  typedArrayConstructorOf,
+  typedArrayTagOf,
 } from './wlvalue';
 
+import { WlFlatView } from './walinkFlat';
+import { WalinkTrace } from './walinkTrace';
+
 import { pack, unpack } from 'msgpackr';
 import {TextEncoder} from "util";
 
@@ -82,7 +95,7 @@ export class BaseContainerView extends BaseContainer {
 
   constructor(public readonly addr: WlAddress, cap?: number) {
     super();
-    if (cap) {
+    if (cap !== undefined) {
       this.addr.view.setUint32(0, cap, true);
       this.addr.view.setUint32(4, 0, true);
     }
@@ -109,6 +122,69 @@ export class BaseContainerView extends BaseContainer {
   }
 }
 
+// Zero-copy typed array backed directly by wasm memory.
+// `array` is valid until release() is called (and until wasm memory grows).
+export class WlTypedArrayView<T extends WlTypedArray = WlTypedArray> {
+  private released = false;
+
+  constructor(
+    public readonly value: WlValue,
+    public readonly array: T,
+    private readonly onRelease: (value: WlValue) => void,
+  ) {}
+
+  // Copy the elements out of wasm memory.
+  copy(): T {
+    return this.array.slice() as T;
+  }
+
+  release(): void {
+    if (!this.released) {
+      this.released = true;
+      this.onRelease(this.value);
+    }
+  }
+}
+
+// Zero-copy segment list of an IOVEC value. Each segment aliases wasm memory
+// owned by the wasm side; views are valid until release() (and until wasm
+// memory grows). Hand `segments` to a vectored write, or concat() them.
+export class WlIovecView {
+  private released = false;
+
+  constructor(
+    public readonly value: WlValue,
+    public readonly segments: Uint8Array[],
+    private readonly onRelease: (value: WlValue) => void,
+  ) {}
+
+  get byteLength(): number {
+    let total = 0;
+    for (const seg of this.segments) {
+      total += seg.length;
+    }
+    return total;
+  }
+
+  // One copy of all segments, in order.
+  concat(): Uint8Array {
+    const out = new Uint8Array(this.byteLength);
+    let offset = 0;
+    for (const seg of this.segments) {
+      out.set(seg, offset);
+      offset += seg.length;
+    }
+    return out;
+  }
+
+  release(): void {
+    if (!this.released) {
+      this.released = true;
+      this.onRelease(this.value);
+    }
+  }
+}
+
 // ---- High-level core wasm exports interface (library-agnostic) ----
 
 export interface WalinkCoreExports {
@@ -117,36 +193,404 @@ export interface WalinkCoreExports {
   walink_alloc(size: number): WlValue;
   // WL_VALUE walink_free(WL_VALUE value);
   walink_free(value: WlValue): WlValue;
+  // WL_VALUE walink_call_batch(WL_VALUE calls, WL_VALUE results);
+  walink_call_batch?(calls: WlValue, results: WlValue): WlValue;
+  // Standalone (reactor) wasm: runs static initializers, e.g. WL_BATCH_REGISTER.
+  _initialize?(): void;
+  // WL_VALUE walink_scratch_slots();
+  walink_scratch_slots?(): WlValue;
+  // WL_VALUE walink_memory_generation();  (memory size in 64KiB pages, as uint32)
+  walink_memory_generation?(): WlValue;
+  // WL_VALUE walink_reserve(uint32_t bytes);  (generation, or 0 when memory cannot grow)
+  walink_reserve?(bytes: number): WlValue;
+  // WL_VALUE walink_arena_alloc(uint32_t size);
+  walink_arena_alloc?(size: number): WlValue;
+  // WL_VALUE walink_arena_reset();
+  walink_arena_reset?(): WlValue;
+  // WL_VALUE walink_arena_enable(uint32_t enabled);
+  walink_arena_enable?(enabled: number): WlValue;
+  // WL_VALUE walink_manifest();  (WL_EXPORT signature manifest, MSGPACK)
+  walink_manifest?(): WlValue;
+  // WL_VALUE walink_recycle(WL_VALUE value);
+  walink_recycle?(value: WlValue): WlValue;
+  // WL_VALUE walink_free_many(WL_VALUE values, uint32_t recycle);
+  walink_free_many?(values: WlValue, recycle: number): WlValue;
+  // WL_VALUE walink_stats();  (0 unless built with WALINK_STATS)
+  walink_stats?(): WlValue;
+  // WL_VALUE walink_trace_buffer();  (0 unless built with WALINK_TRACE)
+  walink_trace_buffer?(): WlValue;
+  // WL_VALUE walink_symbol_lookup(WL_VALUE sym);
+  walink_symbol_lookup?(sym: WlValue): WlValue;
+  // WL_VALUE walink_poll(WL_VALUE pending, uint32_t budget);
+  walink_poll?(pending: WlValue, budget: number): WlValue;
+  // WL_VALUE walink_cancel(WL_VALUE pending);
+  walink_cancel?(pending: WlValue): WlValue;
+  // WL_VALUE walink_utf8_validate(WL_VALUE value);
+  walink_utf8_validate?(value: WlValue): WlValue;
+  // WL_VALUE walink_string_to_utf16(WL_VALUE value);
+  walink_string_to_utf16?(value: WlValue): WlValue;
 }
 
+// WlStatsKind order (cpp/include/walink_stats.h).
+export const WL_STATS_KINDS = [
+  'host', 'bytes', 'string', 'msgpack', 'array', 'flat', 'iovec', 'error', 'scalar', 'recycled', 'other',
+] as const;
+
+export type WalinkStatsKind = (typeof WL_STATS_KINDS)[number];
+
+// Snapshot of the module's allocation counters (WlStats).
+export interface WalinkStats {
+  liveBlocks: number;
+  liveBytes: number;
+  peakBytes: number;
+  allocCount: number;
+  freeCount: number;
+  // frees of blocks that were not live (double frees, foreign pointers)
+  badFreeCount: number;
+  // walink_free of non-address values
+  invalidFreeCount: number;
+  liveByKind: Record<WalinkStatsKind, number>;
+  // sizeHistogram[i]: allocations of at most 16 << i bytes (last: larger)
+  sizeHistogram: number[];
+}
+
+// One WL_EXPORT entry of walink_manifest().
+// Tag NULL means "any WL_VALUE" for params (passed through unchanged) and
+// "no value / raw" for results.
+export interface WalinkManifestEntry {
+  name: string;
+  params: WlTag[];
+  result: WlTag;
+}
+
+export type WalinkStub = (...args: any[]) => unknown;
+
+// Ownership mode for containers crossing the boundary.
+// - 'free'  : every container carries the free flag and is released with walink_free.
+// - 'arena' : containers are bump-allocated in the wasm per-call arena and released
+//             all at once by walink_arena_reset (see Walink.call / Walink.arenaReset).
+export type WalinkOwnership = 'free' | 'arena';
+
 export interface WalinkOptions {
   exports: WalinkCoreExports;
+  ownership?: WalinkOwnership;
+  // Hand received containers back with walink_recycle instead of walink_free,
+  // so the next call's result (or argument) reuses the same block.
+  // Ignored when the module does not export walink_recycle.
+  recycle?: boolean;
+  // Pass non-ASCII string arguments as STRING16 (UTF-16 code units, no host
+  // transcoding). ASCII strings always go as STRING. The module must accept
+  // STRING16 where it takes strings (wl_try_borrow_string does).
+  utf16Strings?: boolean;
+  // Grow wasm memory once up front so about this many bytes of allocations
+  // fit without memory.grow (see Walink.reserve).
+  reserve?: number;
+  // Defaults for resolving PENDING results (see WalinkResolveOptions).
+  pollBudget?: number;
+  pollSliceMs?: number;
+}
+
+// How Walink.resolve drives a PENDING task.
+export interface WalinkResolveOptions {
+  // work units per walink_poll (wl_step costs); default 1024
+  budget?: number;
+  // time spent polling before yielding to the event loop; default 4ms
+  sliceMs?: number;
+  // abort: the task is cancelled (walink_cancel) and the promise rejects
+  signal?: AbortSignal;
 }
 
+const WasmPageSize = 65536;
+
+// Lets timers and I/O run between two slices of a PENDING task.
+const yieldToEventLoop: () => Promise<void> =
+  typeof setImmediate === 'function'
+    ? () => new Promise((resolve) => setImmediate(resolve))
+    : () => new Promise((resolve) => setTimeout(resolve, 0));
+
+// Exports objects whose `_initialize` has already been called.
+const initializedExports = new WeakSet<object>();
+
 // Core Walink runtime: generic WL_VALUE helpers bound to a wasm instance.
 export class Walink {
   protected readonly exports: WalinkCoreExports;
   protected readonly memory: WebAssembly.Memory;
+  public readonly ownership: WalinkOwnership;
+  public readonly recycling: boolean;
+  public readonly utf16Strings: boolean;
+  public readonly pollBudget: number;
+  public readonly pollSliceMs: number;
   private readonly textEncoder: TextEncoder;
   private readonly textDecoder: TextDecoder;
+  private readonly utf16Decoder: TextDecoder;
+  // host->wasm scratch slot table (0: not resolved yet, -1: unsupported)
+  private scratchBase = 0;
+  private scratchCursor = 0;
+  // SYMBOL id -> decoded string (ids are stable for the instance's lifetime)
+  private readonly symbolNames: string[] = [];
+  // frees collected inside deferFrees (null: release right away)
+  private pendingFrees: WlValue[] | null = null;
+  // host-owned ARRAY_UINT64 list handed to walink_free_many (0n: not allocated yet)
+  private freeList: WlValue = 0n;
+  private freeListCap = 0;
+  // views over all of wasm memory, rebuilt only when it grows (see memoryView)
+  private heapBuffer: ArrayBufferLike | null = null;
+  private heapView = new DataView(new ArrayBuffer(0));
+  private heapBytes = new Uint8Array(0);
 
   constructor(options: WalinkOptions) {
     this.exports = options.exports;
     this.memory = options.exports.memory;
+    this.ownership = options.ownership ?? 'free';
+    this.recycling = (options.recycle ?? false) && typeof this.exports.walink_recycle === 'function';
     this.textEncoder = new TextEncoder();
     this.textDecoder = new TextDecoder('utf-8');
+    this.utf16Decoder = new TextDecoder('utf-16le');
+    this.utf16Strings = options.utf16Strings ?? false;
+    this.pollBudget = options.pollBudget ?? 1024;
+    this.pollSliceMs = options.pollSliceMs ?? 4;
+
+    if (typeof this.exports._initialize === 'function' && !initializedExports.has(this.exports)) {
+      initializedExports.add(this.exports);
+      this.exports._initialize();
+    }
+
+    if (this.ownership === 'arena') {
+      if (!this.exports.walink_arena_alloc || !this.exports.walink_arena_reset || !this.exports.walink_arena_enable) {
+        throw new Error('walink: arena ownership requires walink_arena_alloc/walink_arena_reset/walink_arena_enable exports');
+      }
+      this.exports.walink_arena_enable(1);
+    }
+
+    if (options.reserve) {
+      this.reserve(options.reserve);
+    }
   }
 
-  public wlValueGetAddress(value: WlValue): WlAddress {
-    return getAddress(this.memory.buffer, value);
+  // Meta for a container handed over to wasm: free flag, or arena flag in arena mode.
+  protected ownedMeta(tag: WlTag): number {
+    if (this.ownership === 'arena') {
+      return makeMeta(tag, true, false, false, true);
+    }
+    return makeMeta(tag, true, true, false);
   }
 
-  public wlValueAllocate(meta: number, size: number): WlAddress {
-    const wlValue = this.exports.walink_alloc(size);
+  // Release a received value according to its ownership bits.
+  // Arena-owned values are left alone; they go away with the next arena reset.
+  protected release(value: WlValue): void {
+    if (hasFreeFlag(value)) {
+      if (this.pendingFrees !== null) {
+        this.pendingFrees.push(value);
+      } else if (this.recycling) {
+        this.exports.walink_recycle!(value);
+      } else {
+        this.exports.walink_free(value);
+      }
+    }
+  }
+
+  // Run `fn` with every release() deferred, then free all of them with one
+  // walink_free_many crossing. Runs `fn` directly when the module does not
+  // export walink_free_many or when already deferring.
+  deferFrees<T>(fn: () => T): T {
+    if (this.pendingFrees !== null || !this.exports.walink_free_many) {
+      return fn();
+    }
+    this.pendingFrees = [];
+    try {
+      return fn();
+    } finally {
+      const pending = this.pendingFrees;
+      this.pendingFrees = null;
+      this.freeMany(pending);
+    }
+  }
+
+  // decode() each value with their frees batched (see deferFrees). If one
+  // throws (an ERROR result), the values after it are still released.
+  decodeMany(values: readonly WlValue[]): unknown[] {
+    const out = new Array<unknown>(values.length);
+    this.deferFrees(() => {
+      let i = 0;
+      try {
+        for (; i < values.length; ++i) {
+          out[i] = this.decode(values[i]);
+        }
+      } catch (e) {
+        for (++i; i < values.length; ++i) {
+          this.release(values[i]);
+        }
+        throw e;
+      }
+    });
+    return out;
+  }
+
+  private freeMany(values: WlValue[]): void {
+    if (values.length === 0) {
+      return;
+    }
+    const bytes = values.length * 8;
+    if (this.freeListCap < bytes) {
+      if (this.freeList !== 0n) {
+        this.freeHostContainer(this.freeList);
+      }
+      this.freeListCap = Math.max(bytes, 2 * this.freeListCap, 64 * 8);
+      this.freeList = this.newHostContainer(WlTag.ARRAY_UINT64, this.freeListCap);
+    }
+    const ptr = getValueOrAddr(this.freeList);
+    this.memoryView().setUint32(ptr + 4, bytes, true);
+    new BigUint64Array(this.heapBuffer!, ptr + BaseContainerSize, values.length).set(values);
+    this.exports.walink_free_many!(this.freeList, this.recycling ? 1 : 0);
+  }
+
+  // Allocation counters of a WALINK_STATS build; undefined otherwise (or when
+  // the module predates walink_stats). Cheap enough to poll periodically.
+  stats(): WalinkStats | undefined {
+    const value = this.exports.walink_stats ? this.exports.walink_stats() : 0n;
+    if (value === 0n) {
+      return undefined;
+    }
+    const dv = new DataView(this.memory.buffer, getValueOrAddr(value));
+    if (dv.getUint32(0, true) !== 1) {
+      throw new Error(`walink: unsupported WlStats version ${dv.getUint32(0, true)}`);
+    }
+    const liveByKind = {} as Record<WalinkStatsKind, number>;
+    WL_STATS_KINDS.forEach((kind, i) => {
+      liveByKind[kind] = dv.getUint32(48 + i * 4, true);
+    });
+    const sizeHistogram: number[] = [];
+    for (let i = 0; i < 16; ++i) {
+      sizeHistogram.push(Number(dv.getBigUint64(96 + i * 8, true)));
+    }
+    return {
+      liveBlocks: dv.getUint32(4, true),
+      liveBytes: dv.getUint32(8, true),
+      peakBytes: dv.getUint32(12, true),
+      allocCount: Number(dv.getBigUint64(16, true)),
+      freeCount: Number(dv.getBigUint64(24, true)),
+      badFreeCount: Number(dv.getBigUint64(32, true)),
+      invalidFreeCount: Number(dv.getBigUint64(40, true)),
+      liveByKind,
+      sizeHistogram,
+    };
+  }
+
+  // Reader over the WALINK_TRACE call ring, with export names from the
+  // manifest; undefined in builds without tracing. A traced module imports
+  // env.walink_trace_now (see WalinkTrace.imports()).
+  trace(): WalinkTrace | undefined {
+    const ring = this.exports.walink_trace_buffer ? this.exports.walink_trace_buffer() : 0n;
+    if (ring === 0n) {
+      return undefined;
+    }
+    const names = this.exports.walink_manifest ? this.loadManifest().map((entry) => entry.name) : [];
+    return new WalinkTrace(this.memory, ring, names);
+  }
+
+  // Release every arena allocation made since the previous reset.
+  // Values decoded with copying decoders stay valid; views into wasm memory do not.
+  arenaReset(): void {
+    if (this.ownership === 'arena') {
+      this.exports.walink_arena_reset!();
+    }
+  }
+
+  // Run one host->wasm call (including decoding its results) and reset the arena afterwards.
+  call<T>(fn: () => T): T {
+    try {
+      return fn();
+    } finally {
+      this.arenaReset();
+    }
+  }
+
+  // DataView over all of wasm memory. Cached: memory.grow replaces
+  // memory.buffer, so one identity check revalidates it. Fetch it again after
+  // any wasm call that may allocate instead of holding on to it.
+  memoryView(): DataView {
+    if (this.memory.buffer !== this.heapBuffer) {
+      this.refreshHeap();
+    }
+    return this.heapView;
+  }
+
+  // Uint8Array over all of wasm memory (same caching as memoryView).
+  memoryBytes(): Uint8Array {
+    if (this.memory.buffer !== this.heapBuffer) {
+      this.refreshHeap();
+    }
+    return this.heapBytes;
+  }
+
+  // Memory size in 64KiB pages, the same number walink_memory_generation()
+  // reports; it changes exactly when memory grows (and views detach).
+  memoryGeneration(): number {
+    return this.memory.buffer.byteLength / WasmPageSize;
+  }
+
+  // Grow wasm memory now so about `bytes` more of allocations fit without
+  // memory.grow (walink_reserve), keeping growth and view rebuilding off the
+  // per-call path. Returns false when memory cannot grow that far or the
+  // module lacks walink_reserve.
+  reserve(bytes: number): boolean {
+    if (!this.exports.walink_reserve) {
+      return false;
+    }
+    const ok = this.exports.walink_reserve(bytes) !== 0n;
+    this.refreshHeap();
+    return ok;
+  }
+
+  private refreshHeap(): void {
+    this.heapBuffer = this.memory.buffer;
+    this.heapView = new DataView(this.heapBuffer);
+    this.heapBytes = new Uint8Array(this.heapBuffer);
+  }
+
+  // Data pointer of an address-based value.
+  private addressOf(value: WlValue): number {
+    if (!isAddress(value)) {
+      throw new Error('Expected address-based value');
+    }
+    return getValueOrAddr(value);
+  }
+
+  // Data of the container behind `value`, aliasing wasm memory (valid until
+  // the next call that may grow memory).
+  private containerBytes(value: WlValue): Uint8Array {
+    const ptr = this.addressOf(value);
+    const size = this.memoryView().getUint32(ptr + 4, true);
+    return this.heapBytes.subarray(ptr + BaseContainerSize, ptr + BaseContainerSize + size);
+  }
+
+  private allocRaw(meta: number, size: number): number {
+    const wlValue = (meta & WL_META_ARENA_FLAG) !== 0
+      ? this.exports.walink_arena_alloc!(size)
+      : this.exports.walink_alloc(size);
     if (!wlValue) {
       throw new Error(`memory allocate failed (size: ${size})`);
     }
-    const ptr = getValueOrAddr(wlValue);
+    return getValueOrAddr(wlValue);
+  }
+
+  // BaseContainer with `cap` set and size 0; returns its address. The
+  // encoders' path: no WlAddress / BaseContainerView objects.
+  private allocContainer(meta: number, cap: number): number {
+    const ptr = this.allocRaw(meta, BaseContainerSize + cap);
+    // after the allocation, which may have grown memory
+    const dv = this.memoryView();
+    dv.setUint32(ptr, cap, true);
+    dv.setUint32(ptr + 4, 0, true);
+    return ptr;
+  }
+
+  public wlValueGetAddress(value: WlValue): WlAddress {
+    return getAddress(this.memory.buffer, value);
+  }
+
+  public wlValueAllocate(meta: number, size: number): WlAddress {
+    const ptr = this.allocRaw(meta, size);
     return {
       meta: meta,
       ptr: ptr,
@@ -159,11 +603,34 @@ export class Walink {
     return new BaseContainerView(addr, cap);
   }
 
+  // Heap container kept by the host across calls (neither free nor arena flag).
+  // Release it with freeHostContainer.
+  newHostContainer(tag: WlTag, cap: number): WlValue {
+    const meta = makeMeta(tag, true, false, false);
+    return makeValue(meta, this.allocContainer(meta, cap));
+  }
+
+  freeHostContainer(value: WlValue): void {
+    this.exports.walink_free(value);
+  }
+
+  // Run a batch of registered functions in one crossing (see WalinkBatch).
+  callBatch(calls: WlValue, results: WlValue): WlValue {
+    if (!this.exports.walink_call_batch) {
+      throw new Error('walink: module does not export walink_call_batch');
+    }
+    return this.exports.walink_call_batch(calls, results);
+  }
+
+  batch(): WalinkBatch {
+    return new WalinkBatch(this);
+  }
+
   toWlBaseContainerValue(meta: number, bytes: Uint8Array): WlValue {
-    const baseContainer = this.newBaseContainer(meta, bytes.length);
-    baseContainer.size = bytes.length;
-    baseContainer.viewAsUint8Array.set(bytes);
-    return makeValue(baseContainer.addr.meta, baseContainer.addr.ptr);
+    const ptr = this.allocContainer(meta, bytes.length);
+    this.heapView.setUint32(ptr + 4, bytes.length, true);
+    this.heapBytes.set(bytes, ptr + BaseContainerSize);
+    return makeValue(meta, ptr);
   }
 
   fromWlBaseContainer(value: WlValue, autoFree: boolean): BaseContainer {
@@ -174,9 +641,7 @@ export class Walink {
     }
     const copiedBuffer = new Uint8Array(view.size);
     copiedBuffer.set(view.viewAsUint8Array);
-    if (hasFreeFlag(value)) {
-      this.exports.walink_free(value);
-    }
+    this.release(value);
     return new CopiedBaseContainer(copiedBuffer);
   }
 
@@ -213,25 +678,98 @@ export class Walink {
     return fromFloat32(v);
   }
 
+  // Address of the next host->wasm scratch slot, or -1 when the module has no scratch table.
+  protected scratchSlot(): number {
+    if (this.scratchBase === 0) {
+      this.scratchBase = this.exports.walink_scratch_slots
+        ? getValueOrAddr(this.exports.walink_scratch_slots())
+        : -1;
+    }
+    if (this.scratchBase < 0) {
+      return -1;
+    }
+    const ptr = this.scratchBase + this.scratchCursor * 8;
+    this.scratchCursor = (this.scratchCursor + 1) % WL_SCRATCH_SLOT_COUNT;
+    return ptr;
+  }
+
+  // float64/sint64/uint64 go through a scratch slot (no walink_alloc / walink_free);
+  // older modules without walink_scratch_slots fall back to an owned container.
+  private toWlSlot64(tag: WlTag, write: (view: DataView, offset: number) => void): WlValue {
+    const ptr = this.scratchSlot();
+    if (ptr >= 0) {
+      write(this.memoryView(), ptr);
+      return makeValue(makeMeta(tag, true, false, false), ptr);
+    }
+    const meta = this.ownedMeta(tag);
+    const owned = this.allocRaw(meta, 8);
+    write(this.memoryView(), owned);
+    return makeValue(meta, owned);
+  }
+
   toWlFloat64(v: number): WlValue {
-    const meta = makeMeta(WlTag.FLOAT64, true, true, false);
-    const result = this.wlValueAllocate(meta, 8);
-    result.view.setFloat64(0, v);
-    return makeValue(result.meta, result.ptr);
+    return this.toWlSlot64(WlTag.FLOAT64, (view, offset) => view.setFloat64(offset, v, true));
+  }
+
+  toWlSint64(v: bigint | number): WlValue {
+    return this.toWlSlot64(WlTag.SINT64, (view, offset) => view.setBigInt64(offset, BigInt(v), true));
+  }
+
+  toWlUint64(v: bigint | number): WlValue {
+    return this.toWlSlot64(WlTag.UINT64, (view, offset) => view.setBigUint64(offset, BigInt(v), true));
   }
 
   toWlBytes(bytes: Uint8Array): WlValue {
-    const meta = makeMeta(WlTag.BYTES, true, true, false);
+    const meta = this.ownedMeta(WlTag.BYTES);
     return this.toWlBaseContainerValue(meta, bytes);
   }
 
+  // Encodes straight into wasm memory. The first attempt assumes ASCII
+  // (str.length bytes); on the first non-ASCII character the rest goes either
+  // to a STRING16 (utf16Strings) or to a container sized for the worst case.
   toWlString(str: string): WlValue {
-    const meta = makeMeta(WlTag.STRING, true, true, false);
-    return this.toWlBaseContainerValue(meta, this.textEncoder.encode(str));
+    const meta = this.ownedMeta(WlTag.STRING);
+    const first = this.allocContainer(meta, str.length);
+    const firstData = first + BaseContainerSize;
+    const { read, written } = this.textEncoder.encodeInto(
+      str, this.heapBytes.subarray(firstData, firstData + str.length));
+    const firstValue = makeValue(meta, first);
+    if (read === str.length) {
+      this.heapView.setUint32(first + 4, written, true);
+      return firstValue;
+    }
+    if (this.utf16Strings) {
+      this.release(firstValue);
+      return this.toWlString16(str);
+    }
+    // each remaining UTF-16 code unit takes at most 3 UTF-8 bytes
+    const cap = written + (str.length - read) * 3;
+    const second = this.allocContainer(meta, cap);
+    const secondData = second + BaseContainerSize;
+    const heap = this.heapBytes;
+    heap.copyWithin(secondData, firstData, firstData + written);
+    const rest = this.textEncoder.encodeInto(
+      str.substring(read), heap.subarray(secondData + written, secondData + cap));
+    this.heapView.setUint32(second + 4, written + rest.written, true);
+    this.release(firstValue);
+    return makeValue(meta, second);
+  }
+
+  // UTF-16 code units copied as-is (no transcoding on the host).
+  toWlString16(str: string): WlValue {
+    const meta = this.ownedMeta(WlTag.STRING16);
+    const ptr = this.allocContainer(meta, str.length * 2);
+    this.heapView.setUint32(ptr + 4, str.length * 2, true);
+    // container data is 8-aligned
+    const units = new Uint16Array(this.heapBuffer!, ptr + BaseContainerSize, str.length);
+    for (let i = 0; i < str.length; ++i) {
+      units[i] = str.charCodeAt(i);
+    }
+    return makeValue(meta, ptr);
   }
 
   toWlMsgpack(obj: unknown): WlValue {
-    const meta = makeMeta(WlTag.MSGPACK, true, true, false);
+    const meta = this.ownedMeta(WlTag.MSGPACK);
     // Accept either a pre-serialized Uint8Array or a plain JS object.
     // If it's an object, automatically serialize it with msgpackr.pack.
     if (obj instanceof Uint8Array) {
@@ -242,6 +780,24 @@ export class Walink {
     return this.toWlBaseContainerValue(meta, bytes);
   }
 
+  // Copy a typed array into a new wasm array container (one memcpy).
+  toWlTypedArray(array: WlTypedArray): WlValue {
+    const bytes = new Uint8Array(array.buffer, array.byteOffset, array.byteLength);
+    return this.toWlBaseContainerValue(this.ownedMeta(typedArrayTagOf(array)), bytes);
+  }
+
+  // Allocate an array container and return a typed array over it to fill in place.
+  newWlTypedArray<T extends WlTypedArray = WlTypedArray>(tag: WlTag, length: number): WlTypedArrayView<T> {
+    const ctor = typedArrayConstructorOf(tag);
+    const meta = this.ownedMeta(tag);
+    const ptr = this.allocContainer(meta, length * ctor.BYTES_PER_ELEMENT);
+    this.heapView.setUint32(ptr + 4, length * ctor.BYTES_PER_ELEMENT, true);
+    const value = makeValue(meta, ptr);
+    const array = new ctor(this.heapBuffer!, ptr + BaseContainerSize, length) as T;
+    // Ownership moves to wasm once the value is passed; nothing to release here.
+    return new WlTypedArrayView<T>(value, array, () => {});
+  }
+
   // ---- Public validated scalar decoders (use low-level to* from wlvalue after tag check) ----
   fromWlBool(value: WlValue): boolean {
     if (getTag(value) !== WlTag.BOOLEAN) {
@@ -305,13 +861,72 @@ export class Walink {
     if (getTag(value) !== WlTag.FLOAT64) {
       throw new Error(`Expected FLOAT64 tag, got 0x${getTag(value).toString(16)}`);
     }
-    const addr = this.wlValueGetAddress(value);
-    return addr.view.getFloat64(0, true);
+    const result = this.memoryView().getFloat64(this.addressOf(value), true);
+    this.release(value);
+    return result;
+  }
+
+  fromWlSint64(value: WlValue): bigint {
+    if (getTag(value) !== WlTag.SINT64) {
+      throw new Error(`Expected SINT64 tag, got 0x${getTag(value).toString(16)}`);
+    }
+    const result = this.memoryView().getBigInt64(this.addressOf(value), true);
+    this.release(value);
+    return result;
+  }
+
+  fromWlUint64(value: WlValue): bigint {
+    if (getTag(value) !== WlTag.UINT64) {
+      throw new Error(`Expected UINT64 tag, got 0x${getTag(value).toString(16)}`);
+    }
+    const result = this.memoryView().getBigUint64(this.addressOf(value), true);
+    this.release(value);
+    return result;
+  }
+
+  // Zero-copy: the returned view aliases wasm memory; call release() when done.
+  fromWlTypedArray<T extends WlTypedArray = WlTypedArray>(value: WlValue): WlTypedArrayView<T> {
+    const tag = getTag(value);
+    if (!isArrayTag(tag)) {
+      throw new Error(`Expected typed array tag, got 0x${tag.toString(16)}`);
+    }
+    const ctor = typedArrayConstructorOf(tag);
+    const data = this.containerBytes(value);
+    const array = new ctor(data.buffer, data.byteOffset, data.length / ctor.BYTES_PER_ELEMENT) as T;
+    return new WlTypedArrayView<T>(value, array, (v) => this.release(v));
+  }
+
+  // Zero-copy: fields are read from wasm memory on access; call release() when done.
+  fromWlFlat(value: WlValue): WlFlatView {
+    const tag = getTag(value);
+    if (tag !== WlTag.FLAT) {
+      throw new Error(`Expected FLAT tag, got 0x${tag.toString(16)}`);
+    }
+    return new WlFlatView(this.memory, this.addressOf(value), () => this.release(value));
+  }
+
+  // Zero-copy: segment views alias wasm memory; call release() when done.
+  fromWlIovec(value: WlValue): WlIovecView {
+    const tag = getTag(value);
+    if (tag !== WlTag.IOVEC) {
+      throw new Error(`Expected IOVEC tag, got 0x${tag.toString(16)}`);
+    }
+    const dv = this.memoryView();
+    const base = this.addressOf(value) + BaseContainerSize;
+    const count = dv.getUint32(base, true);
+    const segments: Uint8Array[] = [];
+    for (let i = 0; i < count; ++i) {
+      const ptr = dv.getUint32(base + 4 + i * 8, true);
+      const len = dv.getUint32(base + 8 + i * 8, true);
+      segments.push(this.heapBytes.subarray(ptr, ptr + len));
+    }
+    return new WlIovecView(value, segments, (v) => this.release(v));
   }
 
   fromWlBytes(value: WlValue): Uint8Array {
-    const container = this.fromWlBaseContainer(value, true);
-    return container.viewAsUint8Array;
+    const bytes = this.containerBytes(value).slice();
+    this.release(value);
+    return bytes;
   }
 
   fromWlMsgpack<T = any>(value: WlValue): T {
@@ -319,35 +934,241 @@ export class Walink {
     if (tag !== WlTag.MSGPACK) {
       throw new Error(`Expected MSGPACK tag, got 0x${tag.toString(16)}`);
     }
-    const container = this.fromWlBaseContainer(value, false);
+    const bytes = this.containerBytes(value);
     try {
       // unpack returns any; cast to Record<string, any> for callers
-      return unpack(container.viewAsUint8Array) as T;
+      return unpack(bytes) as T;
     } catch (e) {
       // If msgpack parsing fails, surface as an error
       throw new Error(`fromWlMsgpack: msgpack unpack failed: ${(e as Error).message}`);
     } finally {
-      if (hasFreeFlag(value)) {
-        this.exports.walink_free(value);
-      }
+      this.release(value);
     }
   }
 
+  // STRING or STRING16.
   fromWlString(value: WlValue, ignoreTag?: boolean): string {
     const tag = getTag(value);
+    if (tag === WlTag.STRING16) {
+      return this.fromWlString16(value);
+    }
     if (!ignoreTag && tag !== WlTag.STRING) {
       throw new Error(`Expected STRING tag, got 0x${tag.toString(16)}`);
     }
-    const container = this.fromWlBaseContainer(value, false);
+    const bytes = this.containerBytes(value);
     try {
-      return this.textDecoder.decode(container.viewAsUint8Array);
+      return this.textDecoder.decode(bytes);
     } finally {
-      if (hasFreeFlag(value)) {
-        this.exports.walink_free(value);
+      this.release(value);
+    }
+  }
+
+  fromWlString16(value: WlValue): string {
+    const tag = getTag(value);
+    if (tag !== WlTag.STRING16) {
+      throw new Error(`Expected STRING16 tag, got 0x${tag.toString(16)}`);
+    }
+    const bytes = this.containerBytes(value);
+    try {
+      return this.utf16Decoder.decode(bytes);
+    } finally {
+      this.release(value);
+    }
+  }
+
+  // Interned string behind a SYMBOL value. Only the first occurrence of an id
+  // crosses the boundary (walink_symbol_lookup); later ones hit the cache.
+  fromWlSymbol(value: WlValue): string {
+    const tag = getTag(value);
+    if (tag !== WlTag.SYMBOL || isAddress(value)) {
+      throw new Error(`Expected SYMBOL tag, got 0x${tag.toString(16)}`);
+    }
+    const id = getValueOrAddr(value);
+    const cached = this.symbolNames[id];
+    if (cached !== undefined) {
+      return cached;
+    }
+    if (!this.exports.walink_symbol_lookup) {
+      throw new Error('walink: module does not export walink_symbol_lookup');
+    }
+    const name = this.exports.walink_symbol_lookup(value);
+    if (getTag(name) === WlTag.ERROR) {
+      this.decode(name);
+    }
+    // owned by the intern table (no free flag), so fromWlString does not release it
+    const text = this.fromWlString(name);
+    this.symbolNames[id] = text;
+    return text;
+  }
+
+  // ---- PENDING tasks (walink_task.h) ----
+
+  // One slice of the task behind `pending`: its result once it finished, or
+  // `pending` itself while it is still running (raw, not decoded).
+  poll(pending: WlValue, budget: number = this.pollBudget): WlValue {
+    if (!this.exports.walink_poll) {
+      throw new Error('walink: module does not export walink_poll');
+    }
+    return this.exports.walink_poll(pending, budget >>> 0);
+  }
+
+  // Destroy an unfinished task. False when it already finished or was cancelled.
+  cancel(pending: WlValue): boolean {
+    if (!this.exports.walink_cancel) {
+      throw new Error('walink: module does not export walink_cancel');
+    }
+    return this.fromWlBool(this.exports.walink_cancel(pending));
+  }
+
+  // Drive a PENDING task to completion and decode its result. Polls for up to
+  // `sliceMs` at a time, then yields to the event loop, so a long wasm job
+  // does not hold up other work. Any other value is decoded as is.
+  async resolve(value: WlValue, options: WalinkResolveOptions = {}): Promise<unknown> {
+    const budget = options.budget ?? this.pollBudget;
+    const sliceMs = options.sliceMs ?? this.pollSliceMs;
+    const signal = options.signal;
+    while (getTag(value) === WlTag.PENDING && !isAddress(value)) {
+      if (signal?.aborted) {
+        this.cancel(value);
+        throw signal.reason ?? new Error('walink: task aborted');
+      }
+      const deadline = performance.now() + sliceMs;
+      do {
+        value = this.poll(value, budget);
+      } while (getTag(value) === WlTag.PENDING && performance.now() < deadline);
+      if (getTag(value) === WlTag.PENDING) {
+        await yieldToEventLoop();
+      }
+    }
+    return this.decode(value);
+  }
+
+  // ---- WL_EXPORT manifest ----
+
+  loadManifest(): WalinkManifestEntry[] {
+    if (!this.exports.walink_manifest) {
+      throw new Error('walink: module does not export walink_manifest');
+    }
+    return this.fromWlMsgpack<WalinkManifestEntry[]>(this.exports.walink_manifest());
+  }
+
+  // Build one host stub per WL_EXPORT from the manifest. Each stub has its
+  // encoders/decoder resolved up front, so a call does no tag dispatch.
+  bindExports(): Record<string, WalinkStub> {
+    const raw = this.exports as unknown as Record<string, (...args: WlValue[]) => WlValue>;
+    const stubs: Record<string, WalinkStub> = {};
+    for (const entry of this.loadManifest()) {
+      const fn = raw[entry.name];
+      if (typeof fn !== 'function') {
+        throw new Error(`walink: manifest lists ${entry.name} but the module does not export it`);
+      }
+      stubs[entry.name] = this.makeStub(fn, entry);
+    }
+    return stubs;
+  }
+
+  private makeStub(fn: (...args: WlValue[]) => WlValue, entry: WalinkManifestEntry): WalinkStub {
+    const enc = entry.params.map((tag) => this.encoderFor(tag));
+    const dec = this.decoderFor(entry.result);
+    switch (enc.length) {
+      case 0:
+        return () => dec(fn());
+      case 1: {
+        const [e0] = enc;
+        return (a0) => dec(fn(e0(a0)));
+      }
+      case 2: {
+        const [e0, e1] = enc;
+        return (a0, a1) => dec(fn(e0(a0), e1(a1)));
+      }
+      case 3: {
+        const [e0, e1, e2] = enc;
+        return (a0, a1, a2) => dec(fn(e0(a0), e1(a1), e2(a2)));
       }
+      default:
+        return (...args) => dec(fn(...enc.map((e, i) => e(args[i]))));
     }
   }
 
+  encoderFor(tag: WlTag): (v: any) => WlValue {
+    switch (tag) {
+      case WlTag.NULL:
+        return (v: WlValue) => v;
+      case WlTag.BOOLEAN:
+        return (v: boolean) => this.toWlBool(v);
+      case WlTag.SINT8:
+        return (v: number) => this.toWlSint8(v);
+      case WlTag.UINT8:
+        return (v: number) => this.toWlUint8(v);
+      case WlTag.SINT16:
+        return (v: number) => this.toWlSint16(v);
+      case WlTag.UINT16:
+        return (v: number) => this.toWlUint16(v);
+      case WlTag.SINT32:
+        return (v: number) => this.toWlSint32(v);
+      case WlTag.UINT32:
+        return (v: number) => this.toWlUint32(v);
+      case WlTag.FLOAT32:
+        return (v: number) => this.toWlFloat32(v);
+      case WlTag.FLOAT64:
+        return (v: number) => this.toWlFloat64(v);
+      case WlTag.SINT64:
+        return (v: bigint | number) => this.toWlSint64(v);
+      case WlTag.UINT64:
+        return (v: bigint | number) => this.toWlUint64(v);
+      case WlTag.BYTES:
+        return (v: Uint8Array) => this.toWlBytes(v);
+      case WlTag.STRING:
+        return (v: string) => this.toWlString(v);
+      case WlTag.MSGPACK:
+        return (v: unknown) => this.toWlMsgpack(v);
+      case WlTag.HANDLE:
+        // borrowed: a WlHandle wrapper or its raw value
+        return (v: { value: WlValue } | WlValue) => (typeof v === 'bigint' ? v : v.value);
+      default:
+        if (isArrayTag(tag)) {
+          return (v: WlTypedArray) => this.toWlTypedArray(v);
+        }
+        throw new Error(`walink: no encoder for tag 0x${tag.toString(16)}`);
+    }
+  }
+
+  // Results carrying any other tag than the declared one (ERROR in practice)
+  // go through decode(), which turns ERROR into an exception.
+  decoderFor(tag: WlTag): (v: WlValue) => unknown {
+    let decodeTagged: (v: WlValue) => unknown;
+    switch (tag) {
+      case WlTag.NULL:
+        decodeTagged = (v) => (isAddress(v) ? v : undefined);
+        break;
+      case WlTag.BOOLEAN:
+        decodeTagged = (v) => this.fromWlBool(v);
+        break;
+      case WlTag.SINT32:
+        decodeTagged = (v) => this.fromWlSint32(v);
+        break;
+      case WlTag.UINT32:
+        decodeTagged = (v) => this.fromWlUint32(v);
+        break;
+      case WlTag.FLOAT64:
+        decodeTagged = (v) => this.fromWlFloat64(v);
+        break;
+      case WlTag.STRING:
+        decodeTagged = (v) => this.fromWlString(v);
+        break;
+      case WlTag.SYMBOL:
+        decodeTagged = (v) => this.fromWlSymbol(v);
+        break;
+      case WlTag.PENDING:
+        // always a Promise: an ERROR from wl_spawn rejects it
+        return (v) => this.resolve(v);
+      default:
+        decodeTagged = (v) => this.decode(v);
+        break;
+    }
+    return (v) => (getTag(v) === tag ? decodeTagged(v) : this.decode(v));
+  }
+
   // ---- Generic decode helper for common tags ----
 
   decode(value: WlValue): unknown {
@@ -371,12 +1192,57 @@ export class Walink {
         return this.fromWlFloat32(value);
       case WlTag.FLOAT64:
         return this.fromWlFloat64(value);
+      case WlTag.SINT64:
+        return this.fromWlSint64(value);
+      case WlTag.UINT64:
+        return this.fromWlUint64(value);
       case WlTag.BYTES:
         return this.fromWlBytes(value);
       case WlTag.STRING:
         return this.fromWlString(value);
+      case WlTag.STRING16:
+        return this.fromWlString16(value);
       case WlTag.MSGPACK:
         return this.fromWlMsgpack(value);
+      case WlTag.SYMBOL:
+        return this.fromWlSymbol(value);
+      case WlTag.PENDING:
+        return this.resolve(value);
+      case WlTag.IOVEC: {
+        // generic decode gathers into one copy
+        const view = this.fromWlIovec(value);
+        try {
+          return view.concat();
+        } finally {
+          view.release();
+        }
+      }
+      case WlTag.FLAT: {
+        const view = this.fromWlFlat(value);
+        try {
+          return view.toJS();
+        } finally {
+          view.release();
+        }
+      }
+      case WlTag.ARRAY_SINT8:
+      case WlTag.ARRAY_UINT8:
+      case WlTag.ARRAY_SINT16:
+      case WlTag.ARRAY_UINT16:
+      case WlTag.ARRAY_SINT32:
+      case WlTag.ARRAY_UINT32:
+      case WlTag.ARRAY_FLOAT32:
+      case WlTag.ARRAY_FLOAT64:
+      case WlTag.ARRAY_SINT64:
+      case WlTag.ARRAY_UINT64: {
+        // generic decode copies so the result outlives the container
+        const view = this.fromWlTypedArray(value);
+        try {
+          return view.copy();
+        } finally {
+          view.release();
+        }
+      }
       case WlTag.ERROR:
         const text = this.fromWlString(value, true);
         throw new Error(text);
@@ -386,6 +1252,142 @@ export class Walink {
   }
 }
 
+// Host-side builder for walink_call_batch.
+// Calls are staged in JS and written into reusable wasm-side buffers, so run()
+// costs a single boundary crossing however many calls were queued.
+// 64-bit scalar arguments are read out of their scratch slots by add() and
+// written behind the call list, so any number of them can be queued; other
+// argument values must stay valid until run() returns. 64-bit scalar results
+// come back owned rather than in scratch slots, so decode (or free) every
+// result.
+export class WalinkBatch {
+  private fnIds: number[] = [];
+  private args: WlValue[][] = [];
+  private scalars: Array<Array<bigint | undefined>> = [];
+  private byteLength = 0;
+  private scalarBytes = 0;
+  private calls: WlValue = 0n;
+  private callsCap = 0;
+  private results: WlValue = 0n;
+  private resultsCap = 0;
+
+  constructor(private readonly walink: Walink) {}
+
+  get length(): number {
+    return this.fnIds.length;
+  }
+
+  // Queue a call; returns its index in the array returned by run().
+  add(fnId: number, ...args: WlValue[]): number {
+    this.fnIds.push(fnId);
+    this.args.push(args);
+    this.scalars.push(this.captureScalars(args));
+    this.byteLength += 8 + args.length * 8;
+    return this.fnIds.length - 1;
+  }
+
+  // Execute all queued calls and return their raw results, in order.
+  run(): WlValue[] {
+    const count = this.fnIds.length;
+    if (count === 0) {
+      return [];
+    }
+    this.reserve(this.byteLength + this.scalarBytes, count * 8);
+
+    // The captured 64-bit scalars go past the call list (outside the
+    // container's size, inside its capacity), where wasm reads them like
+    // scratch slots.
+    const calls = this.walink.memoryView();
+    const callsPtr = getValueOrAddr(this.calls);
+    calls.setUint32(callsPtr + 4, this.byteLength, true);
+    let offset = callsPtr + BaseContainerSize;
+    let scalar = offset + this.byteLength;
+    for (let i = 0; i < count; i++) {
+      const args = this.args[i];
+      const scalars = this.scalars[i];
+      calls.setUint32(offset, this.fnIds[i], true);
+      calls.setUint32(offset + 4, args.length, true);
+      offset += 8;
+      for (let j = 0; j < args.length; j++) {
+        let arg = args[j];
+        const bits = scalars[j];
+        if (bits !== undefined) {
+          calls.setBigUint64(scalar, bits, true);
+          arg = makeValue(getMeta(arg), scalar);
+          scalar += 8;
+        }
+        calls.setBigUint64(offset, arg, true);
+        offset += 8;
+      }
+    }
+    this.clear();
+
+    const ret = this.walink.callBatch(this.calls, this.results);
+    if (getTag(ret) === WlTag.ERROR) {
+      this.walink.decode(ret);
+    }
+
+    // Re-read after the call: wasm memory may have grown.
+    const results = this.walink.memoryView();
+    const resultsPtr = getValueOrAddr(this.results);
+    const n = results.getUint32(resultsPtr + 4, true) / 8;
+    const out: WlValue[] = new Array(n);
+    for (let i = 0; i < n; i++) {
+      out[i] = results.getBigUint64(resultsPtr + BaseContainerSize + i * 8, true);
+    }
+    return out;
+  }
+
+  clear(): void {
+    this.fnIds = [];
+    this.args = [];
+    this.scalars = [];
+    this.byteLength = 0;
+    this.scalarBytes = 0;
+  }
+
+  // Free the wasm-side buffers. The batch can still be reused afterwards.
+  dispose(): void {
+    if (this.callsCap) {
+      this.walink.freeHostContainer(this.calls);
+      this.callsCap = 0;
+    }
+    if (this.resultsCap) {
+      this.walink.freeHostContainer(this.results);
+      this.resultsCap = 0;
+    }
+  }
+
+  // Same capture as WalinkRing: scratch slots are reused by later calls.
+  private captureScalars(args: WlValue[]): Array<bigint | undefined> {
+    const view = this.walink.memoryView();
+    return args.map((arg) => {
+      if (!isAddress(arg) || !isSlot64Tag(getTag(arg)) || hasFreeFlag(arg) || hasArenaFlag(arg)) {
+        return undefined;
+      }
+      this.scalarBytes += 8;
+      return view.getBigUint64(getValueOrAddr(arg), true);
+    });
+  }
+
+  private reserve(callsBytes: number, resultsBytes: number): void {
+    if (this.callsCap < callsBytes) {
+      if (this.callsCap) {
+        this.walink.freeHostContainer(this.calls);
+      }
+      this.callsCap = Math.max(callsBytes, this.callsCap * 2);
+      this.calls = this.walink.newHostContainer(WlTag.BYTES, this.callsCap);
+    }
+    if (this.resultsCap < resultsBytes) {
+      if (this.resultsCap) {
+        this.walink.freeHostContainer(this.results);
+      }
+      this.resultsCap = Math.max(resultsBytes, this.resultsCap * 2);
+      this.results = this.walink.newHostContainer(WlTag.BYTES, this.resultsCap);
+    }
+  }
+}
+
 // Convenience helper to build Walink from a raw WebAssembly.Instance
 export function createWalinkFromInstance(instance: WebAssembly.Instance): Walink {
   const exports = instance.exports as unknown as WalinkCoreExports;
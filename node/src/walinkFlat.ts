@@ -0,0 +1,244 @@
+// ---- FLAT objects (must mirror cpp/include/walink_flat.h) ----
+
+export enum WlFlatType {
+  NULL = 0,
+  BOOLEAN = 1,
+  INT32 = 2,
+  UINT32 = 3,
+  FLOAT32 = 4,
+  FLOAT64 = 5,
+  INT64 = 6,
+  UINT64 = 7,
+  STRING = 8,
+  BYTES = 9,
+  ARRAY = 10,
+  MAP = 11,
+}
+
+const BaseContainerSize = 8;
+const SlotSize = 8;
+const EntrySize = 12;
+
+const textEncoder = new TextEncoder();
+const textDecoder = new TextDecoder('utf-8');
+
+// Lazy reader over a FLAT container in wasm memory.
+//
+// Nothing is decoded up front: each get()/at() reads one slot, and a map
+// lookup is a binary search over the sorted keys, so the cost follows the
+// fields touched rather than the payload size. Nodes alias wasm memory and
+// are valid until release() (arena mode: until the next arena reset).
+export class WlFlatView {
+  private released = false;
+  private dataView: DataView;
+  // encoded lookup keys, reused across get() calls on this view
+  private readonly keyBytes = new Map<string, Uint8Array>();
+  public readonly root: WlFlatNode;
+
+  constructor(
+    private readonly memory: WebAssembly.Memory,
+    // BaseContainer address
+    private readonly ptr: number,
+    private readonly onRelease: () => void,
+  ) {
+    this.dataView = new DataView(memory.buffer);
+    this.root = new WlFlatNode(this, this.u32(0), this.u32(4));
+  }
+
+  get byteLength(): number {
+    return this.view().getUint32(this.ptr + 4, true);
+  }
+
+  // Full materialization (same result as Walink.decode on a FLAT value).
+  toJS(): unknown {
+    return this.root.toJS();
+  }
+
+  release(): void {
+    if (!this.released) {
+      this.released = true;
+      this.onRelease();
+    }
+  }
+
+  // ---- raw access for WlFlatNode (offsets relative to the container data) ----
+
+  address(offset: number): number {
+    return this.ptr + BaseContainerSize + offset;
+  }
+
+  u32(offset: number): number {
+    return this.view().getUint32(this.address(offset), true);
+  }
+
+  bytes(offset: number, length: number): Uint8Array {
+    return new Uint8Array(this.view().buffer, this.address(offset), length);
+  }
+
+  slotAt(offset: number): WlFlatNode {
+    return new WlFlatNode(this, this.u32(offset), this.u32(offset + 4));
+  }
+
+  encodeKey(key: string): Uint8Array {
+    let bytes = this.keyBytes.get(key);
+    if (bytes === undefined) {
+      bytes = textEncoder.encode(key);
+      this.keyBytes.set(key, bytes);
+    }
+    return bytes;
+  }
+
+  view(): DataView {
+    if (this.released) {
+      throw new Error('walink flat: view already released');
+    }
+    // memory.grow detaches the old buffer
+    if (this.dataView.buffer !== this.memory.buffer) {
+      this.dataView = new DataView(this.memory.buffer);
+    }
+    return this.dataView;
+  }
+}
+
+function compareBytes(a: Uint8Array, b: Uint8Array): number {
+  const n = Math.min(a.length, b.length);
+  for (let i = 0; i < n; ++i) {
+    if (a[i] !== b[i]) {
+      return a[i] - b[i];
+    }
+  }
+  return a.length - b.length;
+}
+
+export class WlFlatNode {
+  constructor(
+    private readonly doc: WlFlatView,
+    public readonly type: WlFlatType,
+    // direct value or node offset, depending on type
+    private readonly payload: number,
+  ) {}
+
+  // Element / entry count of an array or map; 0 otherwise.
+  get length(): number {
+    return this.type === WlFlatType.ARRAY || this.type === WlFlatType.MAP ? this.doc.u32(this.payload) : 0;
+  }
+
+  // Map field, or undefined when absent (or not a map).
+  get(key: string): WlFlatNode | undefined {
+    if (this.type !== WlFlatType.MAP) {
+      return undefined;
+    }
+    const wanted = this.doc.encodeKey(key);
+    let lo = 0;
+    let hi = this.length;
+    while (lo < hi) {
+      const mid = (lo + hi) >>> 1;
+      const entry = this.payload + 4 + mid * EntrySize;
+      const cmp = compareBytes(this.keyBytesAt(entry), wanted);
+      if (cmp === 0) {
+        return this.doc.slotAt(entry + 4);
+      }
+      if (cmp < 0) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return undefined;
+  }
+
+  // Array element, or undefined when out of range (or not an array).
+  at(index: number): WlFlatNode | undefined {
+    if (this.type !== WlFlatType.ARRAY || index < 0 || index >= this.length) {
+      return undefined;
+    }
+    return this.doc.slotAt(this.payload + 4 + index * SlotSize);
+  }
+
+  // Walks a path of keys / indices; undefined as soon as a step is missing.
+  path(...steps: (string | number)[]): WlFlatNode | undefined {
+    let node: WlFlatNode | undefined = this;
+    for (const step of steps) {
+      node = typeof step === 'number' ? node.at(step) : node.get(step);
+      if (node === undefined) {
+        return undefined;
+      }
+    }
+    return node;
+  }
+
+  // Map keys in stored (sorted) order.
+  keys(): string[] {
+    if (this.type !== WlFlatType.MAP) {
+      return [];
+    }
+    const out: string[] = [];
+    for (let i = 0; i < this.length; ++i) {
+      out.push(textDecoder.decode(this.keyBytesAt(this.payload + 4 + i * EntrySize)));
+    }
+    return out;
+  }
+
+  // Scalar, string or a copy of bytes; arrays and maps are materialized.
+  get value(): unknown {
+    const dv = this.doc.view();
+    switch (this.type) {
+      case WlFlatType.NULL:
+        return null;
+      case WlFlatType.BOOLEAN:
+        return this.payload !== 0;
+      case WlFlatType.INT32:
+        return this.payload | 0;
+      case WlFlatType.UINT32:
+        return this.payload >>> 0;
+      case WlFlatType.FLOAT32: {
+        const tmp = new DataView(new ArrayBuffer(4));
+        tmp.setUint32(0, this.payload, true);
+        return tmp.getFloat32(0, true);
+      }
+      case WlFlatType.FLOAT64:
+        return dv.getFloat64(this.doc.address(this.payload), true);
+      case WlFlatType.INT64:
+        return dv.getBigInt64(this.doc.address(this.payload), true);
+      case WlFlatType.UINT64:
+        return dv.getBigUint64(this.doc.address(this.payload), true);
+      case WlFlatType.STRING:
+        return textDecoder.decode(this.blob());
+      case WlFlatType.BYTES:
+        return this.blob().slice();
+      default:
+        return this.toJS();
+    }
+  }
+
+  toJS(): unknown {
+    switch (this.type) {
+      case WlFlatType.ARRAY: {
+        const out: unknown[] = [];
+        for (let i = 0; i < this.length; ++i) {
+          out.push(this.at(i)!.toJS());
+        }
+        return out;
+      }
+      case WlFlatType.MAP: {
+        const out: Record<string, unknown> = {};
+        for (let i = 0; i < this.length; ++i) {
+          const entry = this.payload + 4 + i * EntrySize;
+          out[textDecoder.decode(this.keyBytesAt(entry))] = this.doc.slotAt(entry + 4).toJS();
+        }
+        return out;
+      }
+      default:
+        return this.value;
+    }
+  }
+
+  private blob(): Uint8Array {
+    return this.doc.bytes(this.payload + 4, this.doc.u32(this.payload));
+  }
+
+  private keyBytesAt(entry: number): Uint8Array {
+    const key = this.doc.u32(entry);
+    return this.doc.bytes(key + 4, this.doc.u32(key));
+  }
+}
@@ -0,0 +1,81 @@
+import { type WlValue, WlTag, getTag, isAddress } from './wlvalue';
+
+import { Walink, WalinkCoreExports } from './walink';
+
+// ---- Generational handles (must mirror cpp/include/walink_handle.h) ----
+
+export interface WalinkHandleExports extends WalinkCoreExports {
+  // WL_VALUE walink_handle_retain(WL_VALUE handle);
+  walink_handle_retain(handle: WlValue): WlValue;
+  // WL_VALUE walink_handle_release(WL_VALUE handle);
+  walink_handle_release(handle: WlValue): WlValue;
+  // WL_VALUE walink_handle_valid(WL_VALUE handle);
+  walink_handle_valid(handle: WlValue): WlValue;
+}
+
+// Safety net for handles that are dropped without release(): the reference
+// is given back when the wrapper is collected. Explicit release() is still
+// the rule; collection timing is up to the GC.
+const finalizer =
+  typeof FinalizationRegistry === 'function'
+    ? new FinalizationRegistry<{ exports: WalinkHandleExports; value: WlValue }>(({ exports, value }) => {
+        exports.walink_handle_release(value);
+      })
+    : undefined;
+
+// Host side of a HANDLE value: one reference to an object living in wasm.
+//
+// The wrapper owns the reference returned by the wasm function and passes the
+// raw value back as a borrowed argument (Walink.encoderFor(WlTag.HANDLE)
+// accepts a WlHandle directly). release() gives the reference back exactly
+// once; after the last release the slot's generation changes, so any copy of
+// the raw value is rejected by wasm with a stale-handle error.
+export class WlHandle {
+  private released = false;
+
+  constructor(
+    private readonly walink: Walink,
+    private readonly exports: WalinkHandleExports,
+    public readonly value: WlValue,
+  ) {
+    if (isAddress(value) || getTag(value) !== WlTag.HANDLE) {
+      // ERROR results (e.g. a failed create) surface as exceptions here.
+      walink.decode(value);
+      throw new Error(`Expected HANDLE tag, got 0x${getTag(value).toString(16)}`);
+    }
+    finalizer?.register(this, { exports, value }, this);
+  }
+
+  // False once this wrapper or any other owner has dropped the last reference.
+  get valid(): boolean {
+    return !this.released && this.walink.fromWlBool(this.exports.walink_handle_valid(this.value));
+  }
+
+  // A second, independently released wrapper for the same object.
+  retain(): WlHandle {
+    this.ensureLive();
+    if (!this.walink.fromWlBool(this.exports.walink_handle_retain(this.value))) {
+      throw new Error('walink handle: stale handle');
+    }
+    return new WlHandle(this.walink, this.exports, this.value);
+  }
+
+  release(): void {
+    this.ensureLive();
+    this.released = true;
+    finalizer?.unregister(this);
+    this.exports.walink_handle_release(this.value);
+  }
+
+  dispose(): void {
+    if (!this.released) {
+      this.release();
+    }
+  }
+
+  private ensureLive(): void {
+    if (this.released) {
+      throw new Error('walink handle: already released');
+    }
+  }
+}
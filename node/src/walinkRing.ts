@@ -0,0 +1,309 @@
+import {
+  type WlValue,
+  WlTag,
+  getTag,
+  getMeta,
+  getValueOrAddr,
+  hasArenaFlag,
+  hasFreeFlag,
+  isAddress,
+  isSlot64Tag,
+  makeValue,
+} from './wlvalue';
+
+import { Walink, WalinkCoreExports } from './walink';
+
+// ---- Shared-memory request/response ring (must mirror cpp/include/walink_ring.h) ----
+
+export const WL_RING_MAX_ARGS = 6;
+
+// WlRingChannel fields (byte offsets)
+const CHANNEL_CAPACITY = 0;
+const CHANNEL_REQUEST_OFFSET = 4;
+const CHANNEL_RESPONSE_OFFSET = 8;
+const CHANNEL_STOP = 12;
+const CHANNEL_DOORBELL = 16;
+
+// ring header / entries (byte offsets from the ring start)
+const RING_HEAD = 0;
+const RING_TAIL = 64;
+const RING_ENTRIES = 128;
+
+// WlRingRequest: id u64, fn_id u32, argc u32, args[6] u64, scalars[6] u64, reserved[2]
+const REQUEST_SIZE = 128;
+const REQUEST_ARGS = 16;
+const REQUEST_SCALARS = 64;
+
+// WlRingResponse: id u64, result u64, scalar u64, reserved u64
+const RESPONSE_SIZE = 32;
+const RESPONSE_RESULT = 8;
+
+export interface WalinkRingExports extends WalinkCoreExports {
+  // WL_VALUE walink_ring_create(uint32_t capacity);
+  walink_ring_create(capacity: number): WlValue;
+  // WL_VALUE walink_ring_run(WL_VALUE channel);
+  walink_ring_run(channel: WlValue): WlValue;
+  // WL_VALUE walink_ring_stop(WL_VALUE channel);
+  walink_ring_stop(channel: WlValue): WlValue;
+  // WL_VALUE walink_ring_destroy(WL_VALUE channel);
+  walink_ring_destroy(channel: WlValue): WlValue;
+}
+
+// Worker-instance exports used to give a second instance its own stack/TLS.
+export interface WalinkRingWorkerExports {
+  walink_ring_run(channel: WlValue): WlValue;
+  emscripten_stack_set_limits?(base: number, end: number): void;
+  _emscripten_stack_restore?(sp: number): void;
+  _emscripten_tls_init?(): number;
+}
+
+interface PendingCall {
+  resolve: (v: unknown) => void;
+  reject: (e: unknown) => void;
+}
+
+interface QueuedCall {
+  id: bigint;
+  fnId: number;
+  args: WlValue[];
+  // value of each scratch-slot 64-bit arg, captured at post() time
+  scalars: Array<bigint | undefined>;
+}
+
+// Host (main thread) side of a ring channel.
+//
+// post() writes a request into shared memory and returns a promise without
+// calling into wasm. A worker running walink_ring_run on a second instance
+// over the same Memory executes the requests, and responses are collected
+// asynchronously through Atomics.waitAsync on the response tail; collecting
+// does call into this instance (decode, walink_free of owned results).
+//
+// Only one host thread may post to / drain a given channel (SPSC). Requests
+// that do not fit are queued in JS and written as the worker catches up.
+export class WalinkRing {
+  private readonly pending = new Map<bigint, PendingCall>();
+  private readonly backlog: QueuedCall[] = [];
+  private nextId = 1n;
+  private waiting = false;
+  private stopped = false;
+  // Views are rebuilt when memory.grow replaces the buffer object.
+  private cachedBuffer: ArrayBufferLike | null = null;
+  private i32!: Int32Array;
+  private view!: DataView;
+
+  constructor(
+    private readonly walink: Walink,
+    private readonly exports: WalinkRingExports,
+    public readonly channel: WlValue,
+  ) {}
+
+  static create(walink: Walink, exports: WalinkRingExports, capacity = 256): WalinkRing {
+    const channel = exports.walink_ring_create(capacity);
+    if (getTag(channel) === WlTag.ERROR) {
+      walink.decode(channel);
+    }
+    return new WalinkRing(walink, exports, channel);
+  }
+
+  private get base(): number {
+    return getValueOrAddr(this.channel);
+  }
+
+  private views(): void {
+    const buffer = this.exports.memory.buffer;
+    if (buffer !== this.cachedBuffer) {
+      this.cachedBuffer = buffer;
+      this.i32 = new Int32Array(buffer);
+      this.view = new DataView(buffer);
+    }
+  }
+
+  private u32(offset: number): number {
+    return Atomics.load(this.i32, offset >> 2) >>> 0;
+  }
+
+  private ringBase(fieldOffset: number): number {
+    return this.base + this.view.getUint32(this.base + fieldOffset, true);
+  }
+
+  // Queue fn_id(args...) on the worker. Args follow the walink_call_batch
+  // rules; float64/sint64/uint64 scratch-slot values are copied into the
+  // request entry, so they do not need to outlive this call.
+  post(fnId: number, ...args: WlValue[]): Promise<unknown> {
+    if (this.stopped) {
+      return Promise.reject(new Error('walink ring: stopped'));
+    }
+    if (args.length > WL_RING_MAX_ARGS) {
+      return Promise.reject(new Error(`walink ring: at most ${WL_RING_MAX_ARGS} arguments`));
+    }
+    const id = this.nextId++;
+    const promise = new Promise<unknown>((resolve, reject) => {
+      this.pending.set(id, { resolve, reject });
+    });
+    const call: QueuedCall = { id, fnId, args, scalars: this.captureScalars(args) };
+    if (this.backlog.length > 0 || !this.tryWrite(call)) {
+      this.backlog.push(call);
+    }
+    this.scheduleDrain();
+    return promise;
+  }
+
+  // Ask the worker loop to exit, including when it is blocked on a full
+  // response ring; pending calls are rejected. Calls still in the JS backlog
+  // never reached the ring, so their owned arguments are released here.
+  stop(): void {
+    this.stopped = true;
+    this.views();
+    Atomics.store(this.i32, (this.base + CHANNEL_STOP) >> 2, 1);
+    Atomics.add(this.i32, (this.base + CHANNEL_DOORBELL) >> 2, 1);
+    Atomics.notify(this.i32, (this.base + CHANNEL_DOORBELL) >> 2);
+    for (const p of this.pending.values()) {
+      p.reject(new Error('walink ring: stopped'));
+    }
+    this.pending.clear();
+    for (const call of this.backlog) {
+      for (const arg of call.args) {
+        if (hasFreeFlag(arg)) {
+          this.exports.walink_free(arg);
+        }
+      }
+    }
+    this.backlog.length = 0;
+  }
+
+  // Releases the channel memory and the owned values still queued in it.
+  // The worker must have returned from walink_ring_run.
+  dispose(): void {
+    if (!this.stopped) {
+      this.stop();
+    }
+    this.exports.walink_ring_destroy(this.channel);
+  }
+
+  // Scratch slots are reused by later calls, so 64-bit scalars are read at
+  // post() time; tryWrite stores them inline in the request entry.
+  private captureScalars(args: WlValue[]): Array<bigint | undefined> {
+    this.views();
+    return args.map((arg) =>
+      isAddress(arg) && isSlot64Tag(getTag(arg)) && !hasFreeFlag(arg) && !hasArenaFlag(arg)
+        ? this.view.getBigUint64(getValueOrAddr(arg), true)
+        : undefined,
+    );
+  }
+
+  private tryWrite(call: QueuedCall): boolean {
+    this.views();
+    const ring = this.ringBase(CHANNEL_REQUEST_OFFSET);
+    const capacity = this.view.getUint32(this.base + CHANNEL_CAPACITY, true);
+    const tail = this.u32(ring + RING_TAIL);
+    const head = this.u32(ring + RING_HEAD);
+    if (((tail - head) >>> 0) >= capacity) {
+      return false;
+    }
+
+    const entry = ring + RING_ENTRIES + (tail & (capacity - 1)) * REQUEST_SIZE;
+    const view = this.view;
+    view.setBigUint64(entry, call.id, true);
+    view.setUint32(entry + 8, call.fnId, true);
+    view.setUint32(entry + 12, call.args.length, true);
+    for (let i = 0; i < call.args.length; i++) {
+      let arg = call.args[i];
+      const bits = call.scalars[i];
+      if (bits !== undefined) {
+        const scalar = entry + REQUEST_SCALARS + i * 8;
+        view.setBigUint64(scalar, bits, true);
+        arg = makeValue(getMeta(arg), scalar);
+      }
+      view.setBigUint64(entry + REQUEST_ARGS + i * 8, arg, true);
+    }
+
+    Atomics.store(this.i32, (ring + RING_TAIL) >> 2, (tail + 1) | 0);
+    Atomics.add(this.i32, (this.base + CHANNEL_DOORBELL) >> 2, 1);
+    Atomics.notify(this.i32, (this.base + CHANNEL_DOORBELL) >> 2);
+    return true;
+  }
+
+  // Decode every ready response, then refill the request ring from the backlog.
+  private drain(): void {
+    this.views();
+    const ring = this.ringBase(CHANNEL_RESPONSE_OFFSET);
+    const capacity = this.view.getUint32(this.base + CHANNEL_CAPACITY, true);
+    const start = this.u32(ring + RING_HEAD);
+    const tail = this.u32(ring + RING_TAIL);
+    let head = start;
+
+    while (head !== tail) {
+      const entry = ring + RING_ENTRIES + (head & (capacity - 1)) * RESPONSE_SIZE;
+      const id = this.view.getBigUint64(entry, true);
+      const result = this.view.getBigUint64(entry + RESPONSE_RESULT, true);
+      const call = this.pending.get(id);
+      this.pending.delete(id);
+      // Decode before releasing the entry: 64-bit results point into it.
+      try {
+        const value = this.walink.decode(result);
+        call?.resolve(value);
+      } catch (e) {
+        call?.reject(e);
+      }
+      head = (head + 1) >>> 0;
+      Atomics.store(this.i32, (ring + RING_HEAD) >> 2, head | 0);
+    }
+    if (head !== start) {
+      // a worker blocked on a full response ring waits on the doorbell
+      Atomics.add(this.i32, (this.base + CHANNEL_DOORBELL) >> 2, 1);
+      Atomics.notify(this.i32, (this.base + CHANNEL_DOORBELL) >> 2);
+    }
+
+    while (this.backlog.length > 0 && this.tryWrite(this.backlog[0])) {
+      this.backlog.shift();
+    }
+  }
+
+  private scheduleDrain(): void {
+    if (this.waiting || this.stopped || this.pending.size === 0) {
+      return;
+    }
+    this.views();
+    const ring = this.ringBase(CHANNEL_RESPONSE_OFFSET);
+    const tailIndex = (ring + RING_TAIL) >> 2;
+    const seen = Atomics.load(this.i32, tailIndex);
+    const head = Atomics.load(this.i32, (ring + RING_HEAD) >> 2);
+
+    const resume = () => {
+      this.waiting = false;
+      this.drain();
+      this.scheduleDrain();
+    };
+
+    this.waiting = true;
+    if (seen !== head) {
+      queueMicrotask(resume);
+      return;
+    }
+    const wait = Atomics.waitAsync(this.i32, tailIndex, seen);
+    if (wait.async) {
+      wait.value.then(resume);
+    } else {
+      queueMicrotask(resume);
+    }
+  }
+}
+
+// Worker-thread entry: prepare a second instance (own stack, TLS) over the
+// shared Memory and run the ring loop until stopped. `stackTop`/`stackEnd`
+// are the high/low ends of a block allocated by the main instance (the stack
+// grows down).
+// Do not call `_initialize` on the worker instance: static initializers have
+// already run on the shared memory.
+export function runWalinkRingWorker(
+  exports: WalinkRingWorkerExports,
+  channel: WlValue,
+  stackTop: number,
+  stackEnd: number,
+): number {
+  exports._emscripten_stack_restore?.(stackTop);
+  exports.emscripten_stack_set_limits?.(stackTop, stackEnd);
+  exports._emscripten_tls_init?.();
+  const processed = exports.walink_ring_run(channel);
+  return getValueOrAddr(processed);
+}
@@ -0,0 +1,153 @@
+import {
+  type WlValue,
+  WlTag,
+  getTag,
+  getValueOrAddr,
+  isAddress,
+} from './wlvalue';
+
+import { pack, unpack } from 'msgpackr';
+
+import { Walink, WalinkCoreExports } from './walink';
+
+// ---- Chunked streams (must mirror cpp/include/walink_stream.h) ----
+
+const BaseContainerSize = 8;
+
+const textEncoder = new TextEncoder();
+const textDecoder = new TextDecoder('utf-8');
+
+export interface WalinkStreamExports extends WalinkCoreExports {
+  // WL_VALUE walink_stream_buffer(WL_VALUE stream);
+  walink_stream_buffer(stream: WlValue): WlValue;
+  // WL_VALUE walink_stream_read(WL_VALUE stream);
+  walink_stream_read(stream: WlValue): WlValue;
+  // WL_VALUE walink_stream_write(WL_VALUE stream, uint32_t size);
+  walink_stream_write(stream: WlValue, size: number): WlValue;
+  // WL_VALUE walink_stream_close(WL_VALUE stream);
+  walink_stream_close(stream: WlValue): WlValue;
+}
+
+// Host side of a STREAM value returned by a wasm function.
+//
+// Every chunk goes through the stream's fixed working buffer in wasm memory,
+// so a body of any size needs at most `chunkSize` bytes there. Chunks are
+// copied out (readChunk) or in (write) on each crossing; views are re-created
+// per call, so memory growth between calls is harmless.
+//
+// The stream must be closed exactly once (close / dispose); it is never
+// released by walink_free.
+export class WalinkStream {
+  private closed = false;
+  private readonly bufferPtr: number;
+  public readonly contentTag: WlTag;
+  public readonly chunkSize: number;
+
+  constructor(
+    private readonly walink: Walink,
+    private readonly exports: WalinkStreamExports,
+    public readonly value: WlValue,
+  ) {
+    if (!isAddress(value) || getTag(value) !== WlTag.STREAM) {
+      // ERROR results (e.g. a failed open) surface as exceptions here.
+      walink.decode(value);
+      throw new Error(`Expected STREAM tag, got 0x${getTag(value).toString(16)}`);
+    }
+    const buffer = exports.walink_stream_buffer(value);
+    if (getTag(buffer) === WlTag.ERROR) {
+      walink.decode(buffer);
+    }
+    this.bufferPtr = getValueOrAddr(buffer);
+    this.contentTag = getTag(buffer);
+    this.chunkSize = new DataView(exports.memory.buffer).getUint32(this.bufferPtr, true);
+  }
+
+  // Copy of the next chunk, or null at end of stream.
+  readChunk(): Uint8Array | null {
+    this.ensureOpen();
+    const ret = this.exports.walink_stream_read(this.value);
+    if (getTag(ret) !== WlTag.UINT32) {
+      this.walink.decode(ret);
+    }
+    const size = getValueOrAddr(ret);
+    if (size === 0) {
+      return null;
+    }
+    return new Uint8Array(this.exports.memory.buffer, this.bufferPtr + BaseContainerSize, size).slice();
+  }
+
+  *chunks(): Generator<Uint8Array> {
+    for (let chunk = this.readChunk(); chunk !== null; chunk = this.readChunk()) {
+      yield chunk;
+    }
+  }
+
+  // Reads to the end and concatenates (bounded memory on the wasm side only).
+  readAll(): Uint8Array {
+    const parts: Uint8Array[] = [];
+    let total = 0;
+    for (const chunk of this.chunks()) {
+      parts.push(chunk);
+      total += chunk.length;
+    }
+    const out = new Uint8Array(total);
+    let offset = 0;
+    for (const part of parts) {
+      out.set(part, offset);
+      offset += part.length;
+    }
+    return out;
+  }
+
+  // readAll() interpreted by the content tag (string / msgpack / bytes).
+  readAllDecoded(): unknown {
+    const bytes = this.readAll();
+    switch (this.contentTag) {
+      case WlTag.STRING:
+        return textDecoder.decode(bytes);
+      case WlTag.MSGPACK:
+        return unpack(bytes);
+      default:
+        return bytes;
+    }
+  }
+
+  // Sends `data` to a sink stream in chunkSize pieces.
+  write(data: Uint8Array | string): void {
+    this.ensureOpen();
+    const bytes = typeof data === 'string' ? textEncoder.encode(data) : data;
+    for (let offset = 0; offset < bytes.length; offset += this.chunkSize) {
+      const piece = bytes.subarray(offset, Math.min(offset + this.chunkSize, bytes.length));
+      new Uint8Array(this.exports.memory.buffer, this.bufferPtr + BaseContainerSize, piece.length).set(piece);
+      const ret = this.exports.walink_stream_write(this.value, piece.length);
+      if (getTag(ret) === WlTag.ERROR) {
+        this.walink.decode(ret);
+      }
+    }
+  }
+
+  // Serializes `obj` once and streams the msgpack bytes.
+  writeMsgpack(obj: unknown): void {
+    this.write(pack(obj as any) as Uint8Array);
+  }
+
+  // Releases the stream; returns the decoded close result (undefined for null).
+  close(): unknown {
+    this.ensureOpen();
+    this.closed = true;
+    const result = this.exports.walink_stream_close(this.value);
+    return getTag(result) === WlTag.NULL ? undefined : this.walink.decode(result);
+  }
+
+  dispose(): void {
+    if (!this.closed) {
+      this.close();
+    }
+  }
+
+  private ensureOpen(): void {
+    if (this.closed) {
+      throw new Error('walink stream: already closed');
+    }
+  }
+}
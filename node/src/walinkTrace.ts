@@ -0,0 +1,223 @@
+// ---- WL_EXPORT call tracing (must mirror cpp/include/walink_trace.h) ----
+
+import { type WlValue, getValueOrAddr } from './wlvalue';
+
+export enum WlTracePhase {
+  BEGIN = 0,
+  ARGS = 1,
+  RETURN = 2,
+  END = 3,
+}
+
+const RingHeaderWords = 4;
+const RecordWords = 6;
+
+// Log2 latency histogram: bucket 0 counts durations under 1 µs, bucket i
+// durations in [2^(i-1), 2^i) µs; the last bucket takes everything longer.
+export class WlLatencyHistogram {
+  public readonly buckets: number[] = new Array<number>(32).fill(0);
+  public count = 0;
+  // milliseconds
+  public sum = 0;
+  public max = 0;
+
+  add(ms: number): void {
+    const us = ms * 1000;
+    const bucket = us < 1 ? 0 : Math.min(31, Math.floor(Math.log2(us)) + 1);
+    this.buckets[bucket]++;
+    this.count++;
+    this.sum += ms;
+    if (ms > this.max) {
+      this.max = ms;
+    }
+  }
+
+  get mean(): number {
+    return this.count === 0 ? 0 : this.sum / this.count;
+  }
+
+  // Upper bound (ms) of the bucket holding the p-th quantile (0 < p <= 1).
+  percentile(p: number): number {
+    let seen = 0;
+    const rank = Math.ceil(p * this.count);
+    for (let i = 0; i < this.buckets.length; ++i) {
+      seen += this.buckets[i];
+      if (seen >= rank && seen > 0) {
+        return Math.min(2 ** i / 1000, this.max);
+      }
+    }
+    return this.max;
+  }
+}
+
+// Per-export aggregate of the traced calls.
+export interface WlTraceExportStats {
+  id: number;
+  name: string;
+  calls: number;
+  // calls that ended before reaching the user function (ERROR results)
+  failed: number;
+  total: WlLatencyHistogram;
+  // argument marshalling (BEGIN..ARGS)
+  decode: WlLatencyHistogram;
+  // the user function (ARGS..RETURN)
+  fn: WlLatencyHistogram;
+  // result marshalling (RETURN..END)
+  encode: WlLatencyHistogram;
+  bytesIn: number;
+  bytesOut: number;
+}
+
+interface OpenCall {
+  begin: number;
+  args: number;
+  ret: number;
+  bytesIn: number;
+}
+
+// Reader over the WlTraceRing of a WALINK_TRACE build (see Walink.trace()).
+//
+// The ring is read in place through typed-array views on wasm memory; poll()
+// consumes the records written since the previous poll and folds completed
+// calls into per-export histograms. Poll at least every capacity / 4 calls,
+// or the oldest records are overwritten (counted in `lost`). Calls are
+// matched per export id, so a recursive call of the same export is not
+// told apart from its caller.
+export class WalinkTrace {
+  // u32 index of the ring header in wasm memory
+  private readonly head: number;
+  // records consumed so far (same wrapping counter as the ring's `count`)
+  private readIndex: number;
+  private u32: Uint32Array;
+  private f64: Float64Array;
+  private readonly open = new Map<number, OpenCall>();
+  public readonly byExport = new Map<number, WlTraceExportStats>();
+  public lost = 0;
+
+  // env imports a WALINK_TRACE module needs (merge into the `env` import object).
+  static imports(): { walink_trace_now: () => number } {
+    return { walink_trace_now: () => performance.now() };
+  }
+
+  constructor(
+    private readonly memory: WebAssembly.Memory,
+    // walink_trace_buffer() result
+    ring: WlValue,
+    // export names by manifest index
+    private readonly names: readonly string[] = [],
+  ) {
+    this.head = getValueOrAddr(ring) >>> 2;
+    this.u32 = new Uint32Array(memory.buffer);
+    this.f64 = new Float64Array(memory.buffer);
+    this.readIndex = this.u32[this.head + 1];
+  }
+
+  get capacity(): number {
+    return this.views().u32[this.head];
+  }
+
+  // Zero-copy views over all of wasm memory; record i of the ring starts at
+  // u32[ringWord + 4 + (i % capacity) * 6], its time at f64[thatWord / 2 + 1].
+  views(): { u32: Uint32Array; f64: Float64Array; ringWord: number } {
+    // memory.grow detaches the old buffer
+    if (this.u32.buffer !== this.memory.buffer) {
+      this.u32 = new Uint32Array(this.memory.buffer);
+      this.f64 = new Float64Array(this.memory.buffer);
+    }
+    return { u32: this.u32, f64: this.f64, ringWord: this.head };
+  }
+
+  // Folds new records into byExport; returns how many were read.
+  poll(): number {
+    const { u32, f64 } = this.views();
+    const capacity = u32[this.head];
+    const count = u32[this.head + 1];
+    let pending = (count - this.readIndex) >>> 0;
+    if (pending > capacity) {
+      this.lost += pending - capacity;
+      this.readIndex = (count - capacity) >>> 0;
+      pending = capacity;
+      this.open.clear();
+    }
+    for (let n = 0; n < pending; ++n) {
+      const w = this.head + RingHeaderWords + ((this.readIndex + n) & (capacity - 1)) * RecordWords;
+      this.record(u32[w], u32[w + 1], f64[(w >>> 1) + 1], u32[w + 4], u32[w + 5]);
+    }
+    this.readIndex = count;
+    return pending;
+  }
+
+  // Aggregate for one export, by name.
+  get(name: string): WlTraceExportStats | undefined {
+    const id = this.names.indexOf(name);
+    return id < 0 ? undefined : this.byExport.get(id);
+  }
+
+  // Forget the aggregates (the ring itself is left alone).
+  reset(): void {
+    this.byExport.clear();
+    this.lost = 0;
+  }
+
+  private record(id: number, phase: number, time: number, bytesIn: number, bytesOut: number): void {
+    switch (phase) {
+      case WlTracePhase.BEGIN:
+        this.open.set(id, { begin: time, args: NaN, ret: NaN, bytesIn });
+        break;
+      case WlTracePhase.ARGS: {
+        const call = this.open.get(id);
+        if (call) {
+          call.args = time;
+        }
+        break;
+      }
+      case WlTracePhase.RETURN: {
+        const call = this.open.get(id);
+        if (call) {
+          call.ret = time;
+        }
+        break;
+      }
+      case WlTracePhase.END: {
+        const call = this.open.get(id);
+        if (!call) {
+          break;
+        }
+        this.open.delete(id);
+        const stats = this.statsFor(id);
+        stats.calls++;
+        stats.bytesIn += call.bytesIn;
+        stats.bytesOut += bytesOut;
+        stats.total.add(time - call.begin);
+        if (Number.isNaN(call.ret)) {
+          stats.failed++;
+        } else {
+          stats.decode.add(call.args - call.begin);
+          stats.fn.add(call.ret - call.args);
+          stats.encode.add(time - call.ret);
+        }
+        break;
+      }
+    }
+  }
+
+  private statsFor(id: number): WlTraceExportStats {
+    let stats = this.byExport.get(id);
+    if (stats === undefined) {
+      stats = {
+        id,
+        name: this.names[id] ?? `#${id}`,
+        calls: 0,
+        failed: 0,
+        total: new WlLatencyHistogram(),
+        decode: new WlLatencyHistogram(),
+        fn: new WlLatencyHistogram(),
+        encode: new WlLatencyHistogram(),
+        bytesIn: 0,
+        bytesOut: 0,
+      };
+      this.byExport.set(id, stats);
+    }
+    return stats;
+  }
+}
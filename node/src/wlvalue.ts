@@ -4,6 +4,7 @@ export type WlValue = bigint;
 
 export enum WlTag {
     // direct values (is-address = 0)
+    NULL = 0x00,
     BOOLEAN = 0x10,
     SINT8 = 0x11,
     UINT8 = 0x21,
@@ -15,9 +16,36 @@ export enum WlTag {
 
     // address-based values (is-address = 1)
     FLOAT64 = 0x31,
+    SINT64 = 0x18,
+    UINT64 = 0x28,
     BYTES = 0x01,
     STRING = 0x02,
+    // UTF-16LE code units; decoded like STRING (Walink.fromWlString16)
+    STRING16 = 0x03,
     MSGPACK = 0x0100,
+    // typed numeric arrays: ARRAY_BASE | element scalar tag
+    ARRAY_SINT8 = 0x0211,
+    ARRAY_UINT8 = 0x0221,
+    ARRAY_SINT16 = 0x0212,
+    ARRAY_UINT16 = 0x0222,
+    ARRAY_SINT32 = 0x0214,
+    ARRAY_UINT32 = 0x0224,
+    ARRAY_FLOAT32 = 0x0230,
+    ARRAY_FLOAT64 = 0x0231,
+    ARRAY_SINT64 = 0x0218,
+    ARRAY_UINT64 = 0x0228,
+    // chunked stream handle (see walinkStream.ts)
+    STREAM = 0x0300,
+    // offset-indexed object read lazily from wasm memory (see walinkFlat.ts)
+    FLAT = 0x0600,
+    // list of borrowed byte segments in wasm memory (Walink.fromWlIovec)
+    IOVEC = 0x0700,
+    // generational handle to a wasm-resident object (see walinkHandle.ts)
+    HANDLE = 0x0400,
+    // interned string id, resolved once via walink_symbol_lookup
+    SYMBOL = 0x0500,
+    // resumable wasm-side task, driven by walink_poll (Walink.resolve)
+    PENDING = 0x0800,
     ERROR = 0x7fffff0,
 }
 
@@ -25,13 +53,19 @@ export enum WlTag {
 // bit 31: user-defined tag flag
 // bit 30: is-address flag (1: payload is address, 0: direct value)
 // bit 29: free flag (1: receiver must walink_free the address)
-// bit 28: reserved
+// bit 28: arena flag (1: address lives in the per-call arena, released by walink_arena_reset)
 // bit 27-0: 28-bit tag value
 export const WL_META_USER_DEFINED = 0x80000000;
 export const WL_META_IS_ADDRESS = 0x40000000;
 export const WL_META_FREE_FLAG = 0x20000000;
+export const WL_META_ARENA_FLAG = 0x10000000;
 export const WL_META_TAG_MASK = 0x0fffffff;
 
+export const WL_TAG_ARRAY_BASE = 0x0200;
+
+// 8-byte scratch slots per direction for float64/sint64/uint64 (see walink_scratch_slots)
+export const WL_SCRATCH_SLOT_COUNT = 64;
+
 const U32_MASK = 0xffffffffn;
 
 export interface WlAddress {
@@ -40,6 +74,64 @@ export interface WlAddress {
     view: DataView; // data view
 }
 
+// ---- Typed numeric arrays ----
+
+export type WlTypedArray =
+    | Int8Array
+    | Uint8Array
+    | Int16Array
+    | Uint16Array
+    | Int32Array
+    | Uint32Array
+    | Float32Array
+    | Float64Array
+    | BigInt64Array
+    | BigUint64Array;
+
+interface WlTypedArrayConstructor {
+    readonly BYTES_PER_ELEMENT: number;
+    new (buffer: ArrayBufferLike, byteOffset: number, length: number): WlTypedArray;
+}
+
+const typedArrayConstructors = new Map<WlTag, WlTypedArrayConstructor>([
+    [WlTag.ARRAY_SINT8, Int8Array],
+    [WlTag.ARRAY_UINT8, Uint8Array],
+    [WlTag.ARRAY_SINT16, Int16Array],
+    [WlTag.ARRAY_UINT16, Uint16Array],
+    [WlTag.ARRAY_SINT32, Int32Array],
+    [WlTag.ARRAY_UINT32, Uint32Array],
+    [WlTag.ARRAY_FLOAT32, Float32Array],
+    [WlTag.ARRAY_FLOAT64, Float64Array],
+    [WlTag.ARRAY_SINT64, BigInt64Array],
+    [WlTag.ARRAY_UINT64, BigUint64Array],
+]);
+
+export function isArrayTag(tag: WlTag): boolean {
+    return typedArrayConstructors.has(tag);
+}
+
+// 64-bit scalars passed by address (a scratch slot unless owned).
+export function isSlot64Tag(tag: WlTag): boolean {
+    return tag === WlTag.FLOAT64 || tag === WlTag.SINT64 || tag === WlTag.UINT64;
+}
+
+export function typedArrayConstructorOf(tag: WlTag): WlTypedArrayConstructor {
+    const ctor = typedArrayConstructors.get(tag);
+    if (!ctor) {
+        throw new Error(`Not a typed array tag: 0x${tag.toString(16)}`);
+    }
+    return ctor;
+}
+
+export function typedArrayTagOf(array: WlTypedArray): WlTag {
+    for (const [tag, ctor] of typedArrayConstructors) {
+        if (array instanceof (ctor as unknown as Function)) {
+            return tag;
+        }
+    }
+    throw new Error('Unsupported typed array type');
+}
+
 // ---- Low-level helpers: encode/decode WL_VALUE ----
 
 export function getMeta(value: WlValue): number {
@@ -71,6 +163,7 @@ export function makeMeta(
     isAddress = false,
     freeFlag = false,
     userDefined = false,
+    arenaFlag = false,
 ): number {
     let meta = Number(tag) & WL_META_TAG_MASK;
     if (userDefined) {
@@ -82,6 +175,9 @@ export function makeMeta(
     if (freeFlag) {
         meta |= WL_META_FREE_FLAG;
     }
+    if (arenaFlag) {
+        meta |= WL_META_ARENA_FLAG;
+    }
     return meta >>> 0;
 }
 
@@ -104,6 +200,10 @@ export function hasFreeFlag(value: WlValue): boolean {
     return (getMeta(value) & WL_META_FREE_FLAG) !== 0;
 }
 
+export function hasArenaFlag(value: WlValue): boolean {
+    return (getMeta(value) & WL_META_ARENA_FLAG) !== 0;
+}
+
 export function isAddress(value: WlValue): boolean {
     return (getMeta(value) & WL_META_IS_ADDRESS) !== 0;
 }
@@ -4,7 +4,8 @@ import { fileURLToPath } from "node:url";
 
 import { beforeAll, describe, expect, it } from "vitest";
 
-import { createWalinkWithSampleApi, WalinkWithSampleApi } from "./walinkSampleApi";
+import { WalinkTrace, WlFlatType, wlvalue } from "../src";
+import { createWalinkWithSampleApi, WalinkTestExports, WalinkWithSampleApi } from "./walinkSampleApi";
 
 const __filename = fileURLToPath(import.meta.url);
 const __dirname = path.dirname(__filename);
@@ -17,6 +18,8 @@ async function loadWasmInstance(): Promise<WebAssembly.Instance> {
     emscripten_notify_memory_growth: (memoryIndex) => {
       console.log('emscripten_notify_memory_growth: ', memoryIndex);
     },
+    // -DWALINK_TRACE=ON 빌드에서만 import 됨
+    ...WalinkTrace.imports(),
   };
   const result = await WebAssembly.instantiate(bytes, {
     'env': wasmImports,
@@ -43,6 +46,45 @@ describe("walink wasm integration", () => {
     expect(walink.addSint32(-10, 5)).toBe(-5);
   });
 
+  it("runs many calls in one walink_call_batch crossing", () => {
+    const pairs: Array<[number, number]> = [];
+    for (let i = 0; i < 1000; i++) {
+      pairs.push([i, -2 * i]);
+    }
+    expect(walink.addSint32Batch(pairs)).toEqual(pairs.map(([a, b]) => a + b));
+  });
+
+  it("keeps more 64-bit batch results than there are scratch slots", () => {
+    const values = Array.from({ length: 200 }, (_, i) => i);
+    expect(walink.halfF64Batch(values)).toEqual(values.map((v) => v / 2));
+  });
+
+  it("keeps more 64-bit batch arguments than there are scratch slots", () => {
+    // 2 * 150 개의 toWlFloat64 인자: scratch slot 은 run() 전에 몇 바퀴 돈다
+    const pairs: Array<[number, number]> = Array.from({ length: 150 }, (_, i) => [i + 0.5, i * 0.25]);
+    expect(walink.addF64Batch(pairs)).toEqual(pairs.map(([a, b]) => a + b));
+  });
+
+  it("adds float64 values through scratch slots", () => {
+    expect(walink.addF64(1.5, 2.25)).toBe(3.75);
+    expect(walink.addF64(-0.1, 0.1)).toBe(0);
+  });
+
+  it("adds sint64 values beyond the 32-bit range", () => {
+    expect(walink.addSint64(2n ** 40n, 1n)).toBe(2n ** 40n + 1n);
+    expect(walink.addSint64(-(2n ** 62n), -5n)).toBe(-(2n ** 62n) - 5n);
+  });
+
+  it("transfers float64 arrays as typed arrays", () => {
+    const input = new Float64Array([1, 2.5, -3]);
+    expect(Array.from(walink.scaleF64Array(input, 2))).toEqual([2, 5, -6]);
+    expect(walink.scaleF64Array(new Float64Array(0), 2).length).toBe(0);
+  });
+
+  it("parses and writes msgpack inside wasm without intermediate copies", () => {
+    expect(walink.msgpackSum({ a: 1, b: [2, 3.5, { c: -4 }], d: "text", e: null })).toEqual({ sum: 2.5, count: 4 });
+  });
+
   it("creates hello string from wasm", () => {
     const str = walink.makeHelloString();
     expect(str).toBe("hello from wasm");
@@ -52,4 +94,465 @@ describe("walink wasm integration", () => {
     const str = walink.echoHelloString();
     expect(str).toBe("hello from wasm");
   });
-});
\ No newline at end of file
+
+  it("reads host strings in place through a borrowed view", () => {
+    expect(walink.stringByteLength("hello")).toBe(5);
+    expect(walink.stringByteLength("héllo")).toBe(6);
+    expect(walink.stringByteLength("")).toBe(0);
+  });
+
+  it("reads a source stream chunk by chunk through a fixed buffer", () => {
+    const stream = walink.openPatternStream(100_000, 4096);
+    try {
+      expect(stream.contentTag).toBe(wlvalue.WlTag.BYTES);
+      expect(stream.chunkSize).toBe(4096);
+      const chunks = Array.from(stream.chunks());
+      expect(chunks.length).toBe(Math.ceil(100_000 / 4096));
+      expect(chunks.every((c) => c.length <= 4096)).toBe(true);
+
+      let offset = 0;
+      for (const chunk of chunks) {
+        for (let i = 0; i < chunk.length; i++, offset++) {
+          expect(chunk[i]).toBe((offset * 7 + 3) & 0xff);
+        }
+      }
+      expect(offset).toBe(100_000);
+      expect(stream.readChunk()).toBeNull();
+    } finally {
+      stream.dispose();
+    }
+  });
+
+  it("writes to a sink stream and returns its close result", () => {
+    const data = new Uint8Array(10_000).map((_, i) => i & 0xff);
+    const stream = walink.openChecksumStream(1000);
+    stream.write(data);
+    stream.write("abc");
+    const expectedSum = data.reduce((a, b) => a + b, 0) + 97 + 98 + 99;
+    expect(stream.close()).toEqual({ bytes: 10_003, sum: expectedSum });
+    expect(() => stream.close()).toThrow("already closed");
+  });
+
+  it("rejects reads from a sink stream", () => {
+    const stream = walink.openChecksumStream(16);
+    try {
+      expect(() => stream.readChunk()).toThrow("walink_stream_read: stream is not readable");
+    } finally {
+      stream.dispose();
+    }
+  });
+
+  it("keeps a wasm-resident object behind a handle across calls", () => {
+    const before = walink.liveCounters();
+    const counter = walink.makeCounter(10);
+    expect(wlvalue.getTag(counter.value)).toBe(wlvalue.WlTag.HANDLE);
+    expect(walink.counterAdd(counter, 5)).toBe(15);
+    expect(walink.counterAdd(counter, -20)).toBe(-5);
+    expect(walink.liveCounters()).toBe(before + 1);
+    counter.release();
+    expect(walink.liveCounters()).toBe(before);
+    expect(() => counter.release()).toThrow("already released");
+  });
+
+  it("rejects a stale handle after its last release", () => {
+    const counter = walink.makeCounter(1);
+    const raw = counter.value;
+    const extra = counter.retain();
+    counter.release();
+    expect(extra.valid).toBe(true);
+    expect(walink.counterAdd(raw, 1)).toBe(2);
+    extra.release();
+    expect(() => walink.counterAdd(raw, 1)).toThrow("stale handle");
+    // the slot is reused with a new generation
+    const next = walink.makeCounter(7);
+    try {
+      expect(next.value).not.toBe(raw);
+      expect(() => walink.counterAdd(raw, 1)).toThrow("stale handle");
+      expect(walink.counterAdd(next, 1)).toBe(8);
+    } finally {
+      next.dispose();
+    }
+  });
+
+  it("reads FLAT record fields lazily from wasm memory", () => {
+    const record = walink.flatRecord(10_000);
+    try {
+      const root = record.root;
+      expect(root.type).toBe(WlFlatType.MAP);
+      expect(root.get("id")!.value).toBe(-42n);
+      expect(root.get("name")!.value).toBe("flat record");
+      expect(root.get("ratio")!.value).toBe(0.25);
+      expect(root.get("missing")!.value).toBeNull();
+      expect(root.get("absent")).toBeUndefined();
+      expect(root.get("items")!.length).toBe(10_000);
+      expect(root.path("items", 9_999, "label")!.value).toBe("item-9999");
+      expect(root.path("items", 10_000)).toBeUndefined();
+      expect(root.keys()).toEqual(["active", "blob", "id", "items", "missing", "name", "ratio"]);
+    } finally {
+      record.release();
+    }
+    expect(() => record.root.get("id")).toThrow("already released");
+  });
+
+  it("decodes a FLAT value into plain objects", () => {
+    expect(walink.decode(walink.flatRecordValue(2))).toEqual({
+      active: true,
+      blob: new Uint8Array([1, 2, 3]),
+      id: -42n,
+      items: [
+        { index: 0, label: "item-0", weight: 0 },
+        { index: 1, label: "item-1", weight: 0.5 },
+      ],
+      missing: null,
+      name: "flat record",
+      ratio: 0.25,
+    });
+  });
+
+  it("builds a string from segments without concatenating first", () => {
+    expect(walink.gatherResponse("body")).toBe("<header>body</trailer>");
+    expect(walink.gatherResponse("")).toBe("<header></trailer>");
+  });
+
+  it("reads an IOVEC result as a list of views", () => {
+    const iov = walink.iovecGreeting();
+    try {
+      const decoder = new TextDecoder();
+      expect(iov.segments.map((seg) => decoder.decode(seg))).toEqual(["hello, ", "", "iovec"]);
+      expect(iov.byteLength).toBe(12);
+      expect(decoder.decode(iov.concat())).toBe("hello, iovec");
+    } finally {
+      iov.release();
+    }
+    expect(new TextDecoder().decode(walink.decode(walink.iovecGreetingValue()) as Uint8Array)).toBe("hello, iovec");
+  });
+
+  it("returns long non-ASCII text as STRING16 and short or ASCII text as STRING", () => {
+    const { WlTag } = wlvalue;
+    const ascii = walink.textRepeatValue("ab", 1000);
+    expect(wlvalue.getTag(ascii)).toBe(WlTag.STRING);
+    expect(walink.fromWlString(ascii)).toBe("ab".repeat(1000));
+
+    const short = walink.textRepeatValue("ü", 3);
+    expect(wlvalue.getTag(short)).toBe(WlTag.STRING);
+    expect(walink.fromWlString(short)).toBe("üüü");
+
+    const wide = walink.textRepeatValue("日本 🎌 ", 200);
+    expect(wlvalue.getTag(wide)).toBe(WlTag.STRING16);
+    expect(walink.decode(wide)).toBe("日本 🎌 ".repeat(200));
+    expect(walink.textRepeat("çà", 600)).toBe("çà".repeat(600));
+  });
+
+  it("validates UTF-8 inside wasm", () => {
+    expect(walink.utf8Valid(new TextEncoder().encode("plain ascii, ünïcödé, 🎌"))).toBe(true);
+    expect(walink.utf8Valid(new Uint8Array([0x61, 0xc0, 0xaf]))).toBe(false); // overlong '/'
+    expect(walink.utf8Valid(new Uint8Array([0xed, 0xa0, 0x80]))).toBe(false); // surrogate
+    expect(walink.utf8Valid(new Uint8Array([0xe2, 0x82]))).toBe(false); // truncated
+  });
+
+  it("reserves linear memory so cached views survive allocations", () => {
+    expect(walink.callRaw("walink_memory_generation")).toBe(walink.memoryGeneration());
+
+    expect(walink.reserve(8 << 20)).toBe(true);
+    const generation = walink.memoryGeneration();
+    expect(walink.callRaw("walink_memory_generation")).toBe(generation);
+    const view = walink.memoryView();
+
+    // 예약한 범위 안의 할당은 memory.grow 없이 처리된다 (view 재생성 없음)
+    const payload = "x".repeat(64 * 1024);
+    const values = [];
+    for (let i = 0; i < 32; i++) {
+      values.push(walink.toWlString(payload));
+    }
+    expect(walink.memoryGeneration()).toBe(generation);
+    expect(walink.memoryView()).toBe(view);
+    for (const value of values) {
+      walink.freeHostContainer(value);
+    }
+
+    // 4GiB 를 넘는 예약은 실패하고 memory 는 그대로
+    expect(walink.reserve(0xffffffff)).toBe(false);
+    expect(walink.memoryGeneration()).toBe(generation);
+  });
+
+  it("reports allocation counters in a WALINK_STATS build", () => {
+    const before = walink.stats();
+    if (before === undefined) {
+      // 기본 빌드: export 는 있지만 0 을 돌려준다.
+      // 카운터 자체는 native 테스트 (cpp/tests/native/walink_stats_test.cc) 에서 검사
+      expect(walink.callRawValue("walink_stats")).toBe(0n);
+      return;
+    }
+    const value = walink.makeHelloStringValue();
+    const during = walink.stats()!;
+    expect(during.liveByKind.string).toBe(before.liveByKind.string + 1);
+    expect(during.allocCount).toBeGreaterThan(before.allocCount);
+    expect(walink.fromWlString(value)).toBe("hello from wasm");
+
+    const after = walink.stats()!;
+    expect(after.liveByKind.string).toBe(before.liveByKind.string);
+    expect(after.liveBytes).toBe(before.liveBytes);
+    expect(after.peakBytes).toBeGreaterThanOrEqual(during.liveBytes);
+
+    // double free 는 거부되고 카운트된다
+    expect(walink.callRaw("walink_free", value)).toBe(false);
+    expect(walink.stats()!.badFreeCount).toBe(after.badFreeCount + 1);
+  });
+
+  it("traces WL_EXPORT calls phase by phase in a WALINK_TRACE build", () => {
+    const trace = walink.trace();
+    if (trace === undefined) {
+      // 기본 빌드: export 는 있지만 0 을 돌려준다.
+      // record 자체는 native 테스트 (cpp/tests/native/walink_trace_test.cc) 에서 검사
+      expect(walink.callRawValue("walink_trace_buffer")).toBe(0n);
+      return;
+    }
+    trace.poll();
+    trace.reset();
+    const stubs = walink.bindExports();
+    for (let i = 0; i < 10; i++) {
+      expect(stubs.wl_concat_strings("foo", "barbaz")).toBe("foobarbaz");
+    }
+    expect(() => walink.callRaw("wl_concat_strings", walink.toWlBool(true), walink.toWlBool(false))).toThrow();
+    expect(trace.poll()).toBe(42);
+
+    const stats = trace.get("wl_concat_strings")!;
+    expect(stats.calls).toBe(11);
+    expect(stats.failed).toBe(1);
+    expect(stats.fn.count).toBe(10);
+    expect(stats.bytesIn).toBe(90);
+    expect(stats.total.percentile(0.5)).toBeGreaterThanOrEqual(0);
+    expect(trace.lost).toBe(0);
+  });
+
+  it("lists WL_EXPORT signatures in the manifest", () => {
+    const { WlTag } = wlvalue;
+    expect(walink.loadManifest()).toEqual(
+      expect.arrayContaining([
+        { name: "wl_concat_strings", params: [WlTag.STRING, WlTag.STRING], result: WlTag.STRING },
+        { name: "wl_dot_f64", params: [WlTag.ARRAY_FLOAT64, WlTag.ARRAY_FLOAT64], result: WlTag.FLOAT64 },
+        { name: "wl_clamp_sint32", params: [WlTag.SINT32, WlTag.SINT32, WlTag.SINT32], result: WlTag.SINT32 },
+        { name: "wl_sum_below", params: [WlTag.UINT32], result: WlTag.PENDING },
+      ]),
+    );
+  });
+
+  it("calls WL_EXPORT functions through manifest-generated stubs", () => {
+    const stubs = walink.bindExports();
+    expect(stubs.wl_concat_strings("foo", "bär")).toBe("foobär");
+    expect(stubs.wl_dot_f64(new Float64Array([1, 2, 3]), new Float64Array([4, 5, 6]))).toBe(32);
+    expect(stubs.wl_clamp_sint32(15, 0, 10)).toBe(10);
+    expect(stubs.wl_clamp_sint32(-3, 0, 10)).toBe(0);
+  });
+
+  it("returns interned symbols as one value per string", () => {
+    const { WlTag } = wlvalue;
+    const first = walink.statusNameValue(1);
+    const second = walink.statusNameValue(1);
+    expect(wlvalue.getTag(first)).toBe(WlTag.SYMBOL);
+    expect(second).toBe(first);
+    expect(walink.decode(first)).toBe("not_found");
+    expect(walink.fromWlSymbol(second)).toBe("not_found");
+
+    const stubs = walink.bindExports();
+    expect([0, 1, 2, 0].map((code) => stubs.wl_status_name(code))).toEqual(["ok", "not_found", "denied", "ok"]);
+  });
+
+  it("rejects mismatched argument tags in WL_EXPORT wrappers", () => {
+    expect(() =>
+      walink.callRaw("wl_clamp_sint32", walink.toWlBool(true), walink.toWlSint32(0), walink.toWlSint32(1)),
+    ).toThrow("wl_clamp_sint32: argument type mismatch");
+  });
+
+  it("runs PENDING tasks one poll budget at a time", () => {
+    const { WlTag } = wlvalue;
+    const pending = walink.sumBelowValue(1000);
+    expect(wlvalue.getTag(pending)).toBe(WlTag.PENDING);
+    expect(wlvalue.isAddress(pending)).toBe(false);
+    // 첫 poll 은 10 step 만 진행하고 같은 PENDING 값을 돌려줌
+    expect(walink.poll(pending, 10)).toBe(pending);
+
+    let result = pending;
+    let polls = 0;
+    while (wlvalue.getTag(result) === WlTag.PENDING) {
+      result = walink.poll(result, 100);
+      polls++;
+    }
+    expect(polls).toBeGreaterThanOrEqual(10);
+    expect(walink.decode(result)).toBe(499500);
+    // 끝난 task 의 PENDING 값은 stale handle 과 같이 취급
+    expect(() => walink.decode(walink.poll(pending, 1))).toThrow("walink_poll: task already finished or cancelled");
+  });
+
+  it("resolves PENDING results between event loop turns", async () => {
+    let timerFired = false;
+    setTimeout(() => {
+      timerFired = true;
+    }, 0);
+    const result = await walink.resolve(walink.sumBelowValue(1_000_000), { budget: 100, sliceMs: 0 });
+    expect(result).toBe(499999500000);
+    expect(timerFired).toBe(true);
+
+    const stubs = walink.bindExports();
+    const promise = stubs.wl_sum_below(10);
+    expect(promise).toBeInstanceOf(Promise);
+    await expect(promise).resolves.toBe(45);
+    await expect(stubs.wl_fail_after(5)).rejects.toThrow("fail_after: gave up");
+  });
+
+  it("cancels a PENDING task when the signal aborts", async () => {
+    const controller = new AbortController();
+    const pending = walink.sumBelowValue(0xffffffff);
+    const promise = walink.resolve(pending, { budget: 1000, sliceMs: 1, signal: controller.signal });
+    controller.abort(new Error("stop"));
+    await expect(promise).rejects.toThrow("stop");
+    expect(walink.cancel(pending)).toBe(false);
+    expect(() => walink.decode(walink.poll(pending))).toThrow("walink_poll: task already finished or cancelled");
+  });
+});
+
+describe("walink arena ownership", () => {
+  let walink: WalinkWithSampleApi;
+
+  beforeAll(async () => {
+    const instance = await loadWasmInstance();
+    walink = createWalinkWithSampleApi(instance, "arena");
+  });
+
+  it("returns arena-owned containers instead of free-flagged ones", () => {
+    walink.call(() => {
+      const value = walink.makeHelloStringValue();
+      expect(wlvalue.hasArenaFlag(value)).toBe(true);
+      expect(wlvalue.hasFreeFlag(value)).toBe(false);
+      expect(walink.fromWlString(value)).toBe("hello from wasm");
+    });
+  });
+
+  it("reuses arena memory after reset", () => {
+    const first = walink.call(() => walink.makeHelloStringValue());
+    const second = walink.call(() => walink.makeHelloStringValue());
+    expect(wlvalue.getValueOrAddr(second)).toBe(wlvalue.getValueOrAddr(first));
+  });
+});
+
+describe("walink container recycling", () => {
+  let walink: WalinkWithSampleApi;
+
+  beforeAll(async () => {
+    const instance = await loadWasmInstance();
+    walink = createWalinkWithSampleApi(instance, "free", true);
+  });
+
+  it("reuses a recycled result container for the next call", () => {
+    expect(walink.recycling).toBe(true);
+    const first = walink.makeHelloStringValue();
+    expect(walink.fromWlString(first)).toBe("hello from wasm");
+    const second = walink.makeHelloStringValue();
+    expect(wlvalue.getValueOrAddr(second)).toBe(wlvalue.getValueOrAddr(first));
+    expect(walink.fromWlString(second)).toBe("hello from wasm");
+  });
+
+  it("serves host argument allocations from recycled blocks", () => {
+    const result = walink.makeHelloStringValue();
+    const recycled = wlvalue.getValueOrAddr(result);
+    expect(walink.fromWlString(result)).toBe("hello from wasm");
+
+    // 같은 크기의 host 인자는 방금 recycle 된 블록을 받는다 (walink_alloc)
+    const arg = walink.toWlString("hello from wasm");
+    expect(wlvalue.getValueOrAddr(arg)).toBe(recycled);
+    expect(walink.callRaw("wl_string_byte_length", arg)).toBe(15);
+  });
+});
+
+describe("walink UTF-16 string arguments", () => {
+  let walink: WalinkWithSampleApi;
+
+  beforeAll(async () => {
+    const instance = await loadWasmInstance();
+    walink = createWalinkWithSampleApi(instance, "free", false, true);
+  });
+
+  it("passes non-ASCII arguments as STRING16 and ASCII ones as STRING", () => {
+    const { WlTag } = wlvalue;
+    const ascii = walink.toWlString("plain");
+    expect(wlvalue.getTag(ascii)).toBe(WlTag.STRING);
+    expect(walink.decode(ascii)).toBe("plain");
+
+    const text = walink.toWlString("grüße 🎌");
+    expect(wlvalue.getTag(text)).toBe(WlTag.STRING16);
+    expect(walink.decode(text)).toBe("grüße 🎌");
+
+    // wasm side reads both through wl_try_borrow_string
+    const stubs = walink.bindExports();
+    expect(stubs.wl_concat_strings("foo", "bär")).toBe("foobär");
+    expect(walink.textRepeat("é🎌", 4)).toBe("é🎌".repeat(4));
+  });
+});
+
+describe("walink bulk free", () => {
+  let walink: WalinkWithSampleApi;
+  let raw: WalinkTestExports;
+  let frees = 0;
+  let bulkFrees = 0;
+
+  beforeAll(async () => {
+    const instance = await loadWasmInstance();
+    raw = instance.exports as unknown as WalinkTestExports;
+    // 경계 횡단 횟수를 세기 위해 free 계열 export 만 감싼다
+    walink = new WalinkWithSampleApi({
+      ...raw,
+      walink_free: (value) => {
+        frees++;
+        return raw.walink_free(value);
+      },
+      walink_free_many: (values, recycle) => {
+        bulkFrees++;
+        return raw.walink_free_many!(values, recycle);
+      },
+    });
+  });
+
+  it("drains many results with one walink_free_many crossing", () => {
+    const values = Array.from({ length: 10000 }, () => walink.makeHelloStringValue());
+    frees = 0;
+    bulkFrees = 0;
+    expect(walink.decodeMany(values)).toEqual(new Array(10000).fill("hello from wasm"));
+    expect(frees).toBe(0);
+    expect(bulkFrees).toBe(1);
+  });
+
+  it("still releases the values after an ERROR result", () => {
+    const values = [
+      walink.makeHelloStringValue(),
+      raw.wl_echo_string(walink.toWlSint32(1)),
+      walink.makeHelloStringValue(),
+    ];
+    frees = 0;
+    bulkFrees = 0;
+    expect(() => walink.decodeMany(values)).toThrow("wl_echo_string: invalid tag");
+    expect(frees).toBe(0);
+    expect(bulkFrees).toBe(1);
+  });
+
+  it("ignores scratch-slot scalars handed to the raw free exports", () => {
+    const { WlTag, getValueOrAddr } = wlvalue;
+    // wasm->host / host->wasm scratch slot 값 (free flag 없음, 정적 영역을 가리킴)
+    const fromWasm = raw.wl_add_f64(walink.toWlFloat64(1), walink.toWlFloat64(2));
+    const fromHost = walink.toWlFloat64(4);
+    expect(raw.walink_free(fromWasm)).toBe(walink.toWlBool(false));
+    raw.walink_recycle!(fromHost);
+
+    const list = walink.newHostContainer(WlTag.ARRAY_UINT64, 16);
+    const view = walink.memoryView();
+    const base = getValueOrAddr(list);
+    view.setUint32(base + 4, 16, true);
+    view.setBigUint64(base + 8, fromWasm, true);
+    view.setBigUint64(base + 16, fromHost, true);
+    expect(walink.decode(raw.walink_free_many!(list, 0))).toBe(2);
+    walink.freeHostContainer(list);
+
+    // heap 이 멀쩡하면 이후 할당 / 해제도 정상
+    expect(walink.addF64(1.5, 2.25)).toBe(3.75);
+    expect(walink.decodeMany(Array.from({ length: 100 }, () => walink.makeHelloStringValue()))).toHaveLength(100);
+  });
+});
@@ -3,26 +3,75 @@ import {
   type WlValue,
   createWalinkFromInstance,
   Walink,
-  WalinkCoreExports,
+  WalinkOwnership,
+  WalinkStream,
+  WalinkStreamExports,
+  WalinkHandleExports,
+  WlHandle,
+  WlFlatView,
+  WlIovecView,
 } from "../src";
 
+// walink_call_batch 에 등록된 테스트용 함수 id (cpp/tests/walink_test_api.cpp)
+export const WL_TEST_BATCH_ADD_SINT32 = 1;
+export const WL_TEST_BATCH_HALF_F64 = 2;
+export const WL_TEST_BATCH_ADD_F64 = 3;
+
 // wasm 테스트 모듈이 export 하는 테스트용 C API 시그니처
-export interface WalinkTestExports extends WalinkCoreExports {
+export interface WalinkTestExports extends WalinkStreamExports, WalinkHandleExports {
   wl_roundtrip_bool(value: WlValue): WlValue;
   wl_add_sint32(a: WlValue, b: WlValue): WlValue;
+  wl_add_f64(a: WlValue, b: WlValue): WlValue;
+  wl_add_sint64(a: WlValue, b: WlValue): WlValue;
+  wl_scale_f64_array(arr: WlValue, factor: WlValue): WlValue;
+  wl_msgpack_sum(obj: WlValue): WlValue;
   wl_make_hello_string(): WlValue;
   wl_echo_string(value: WlValue): WlValue;
+  wl_string_byte_length(value: WlValue): WlValue;
+  wl_stream_pattern(total: WlValue, chunk: WlValue): WlValue;
+  wl_stream_checksum(chunk: WlValue): WlValue;
+  wl_handle_make_counter(start: WlValue): WlValue;
+  wl_handle_counter_add(handle: WlValue, delta: WlValue): WlValue;
+  wl_handle_live_counters(): WlValue;
+  wl_status_name(code: WlValue): WlValue;
+  wl_flat_record(count: WlValue): WlValue;
+  wl_gather_response(body: WlValue): WlValue;
+  wl_iovec_greeting(): WlValue;
+  wl_text_repeat(str: WlValue, times: WlValue): WlValue;
+  wl_sum_below(n: WlValue): WlValue;
 }
 
 // 라이브러리 코어 Walink 위에 테스트용 샘플 API 래퍼를 올린 클래스
 export class WalinkWithSampleApi extends Walink {
   protected readonly testExports: WalinkTestExports;
 
-  constructor(exports: WalinkTestExports) {
-    super({ exports });
+  constructor(exports: WalinkTestExports, ownership?: WalinkOwnership, recycle?: boolean, utf16Strings?: boolean) {
+    super({ exports, ownership, recycle, utf16Strings });
     this.testExports = exports;
   }
 
+  // export 이름으로 raw WL_VALUE 인자를 그대로 넘겨 호출 (WL_EXPORT tag 검사 확인용)
+  callRaw(name: string, ...args: WlValue[]): unknown {
+    const fn = (this.testExports as unknown as Record<string, (...a: WlValue[]) => WlValue>)[name];
+    return this.decode(fn(...args));
+  }
+
+  // callRaw 와 같지만 결과 WL_VALUE 를 decode 하지 않고 그대로 돌려준다
+  callRawValue(name: string, ...args: WlValue[]): WlValue {
+    const fn = (this.testExports as unknown as Record<string, (...a: WlValue[]) => WlValue>)[name];
+    return fn(...args);
+  }
+
+  // WL_EXPORT(wl_status_name) 의 raw 결과 (SYMBOL 값, 해제 불필요)
+  statusNameValue(code: number): WlValue {
+    return this.testExports.wl_status_name(this.toWlSint32(code));
+  }
+
+  // WL_EXPORT(wl_sum_below) 의 raw 결과 (PENDING 값, walink_poll 로 진행)
+  sumBelowValue(n: number): WlValue {
+    return this.testExports.wl_sum_below(this.toWlUint32(n));
+  }
+
   roundtripBool(v: boolean): boolean {
     const input = this.toWlBool(v);
     const result = this.testExports.wl_roundtrip_bool(input);
@@ -37,6 +86,71 @@ export class WalinkWithSampleApi extends Walink {
     return this.fromWlSint32(result);
   }
 
+  addSint32Batch(pairs: Array<[number, number]>): number[] {
+    const batch = this.batch();
+    try {
+      for (const [a, b] of pairs) {
+        batch.add(WL_TEST_BATCH_ADD_SINT32, this.toWlSint32(a), this.toWlSint32(b));
+      }
+      return batch.run().map((result) => this.fromWlSint32(result));
+    } finally {
+      batch.dispose();
+    }
+  }
+
+  halfF64Batch(values: number[]): number[] {
+    const batch = this.batch();
+    try {
+      for (const v of values) {
+        batch.add(WL_TEST_BATCH_HALF_F64, this.toWlSint32(v));
+      }
+      return batch.run().map((result) => this.fromWlFloat64(result));
+    } finally {
+      batch.dispose();
+    }
+  }
+
+  addF64Batch(pairs: Array<[number, number]>): number[] {
+    const batch = this.batch();
+    try {
+      for (const [a, b] of pairs) {
+        batch.add(WL_TEST_BATCH_ADD_F64, this.toWlFloat64(a), this.toWlFloat64(b));
+      }
+      return batch.run().map((result) => this.fromWlFloat64(result));
+    } finally {
+      batch.dispose();
+    }
+  }
+
+  addF64(a: number, b: number): number {
+    const result = this.testExports.wl_add_f64(this.toWlFloat64(a), this.toWlFloat64(b));
+    return this.fromWlFloat64(result);
+  }
+
+  addSint64(a: bigint, b: bigint): bigint {
+    const result = this.testExports.wl_add_sint64(this.toWlSint64(a), this.toWlSint64(b));
+    return this.fromWlSint64(result);
+  }
+
+  scaleF64Array(values: Float64Array, factor: number): Float64Array {
+    const result = this.testExports.wl_scale_f64_array(this.toWlTypedArray(values), this.toWlFloat64(factor));
+    const view = this.fromWlTypedArray<Float64Array>(result);
+    try {
+      return view.copy();
+    } finally {
+      view.release();
+    }
+  }
+
+  msgpackSum(obj: unknown): { sum: number; count: number } {
+    const result = this.testExports.wl_msgpack_sum(this.toWlMsgpack(obj));
+    return this.fromWlMsgpack(result);
+  }
+
+  makeHelloStringValue(): WlValue {
+    return this.testExports.wl_make_hello_string();
+  }
+
   makeHelloString(): string {
     const value = this.testExports.wl_make_hello_string();
     return this.fromWlString(value);
@@ -47,11 +161,84 @@ export class WalinkWithSampleApi extends Walink {
     const echoed = this.testExports.wl_echo_string(hello);
     return this.fromWlString(echoed);
   }
+
+  stringByteLength(str: string): number {
+    const result = this.testExports.wl_string_byte_length(this.toWlString(str));
+    return this.fromWlSint32(result);
+  }
+
+  // total 바이트의 (i * 7 + 3) & 0xff 패턴을 chunk 단위로 읽는 source stream
+  openPatternStream(total: number, chunk: number): WalinkStream {
+    const value = this.testExports.wl_stream_pattern(this.toWlUint32(total), this.toWlUint32(chunk));
+    return new WalinkStream(this, this.testExports, value);
+  }
+
+  // 쓴 바이트 수와 합계를 close() 시 { bytes, sum } 으로 돌려주는 sink stream
+  openChecksumStream(chunk: number): WalinkStream {
+    const value = this.testExports.wl_stream_checksum(this.toWlUint32(chunk));
+    return new WalinkStream(this, this.testExports, value);
+  }
+
+  // wasm 메모리에 남아 있는 Counter 객체의 handle (start 부터 시작)
+  makeCounter(start: number): WlHandle {
+    const value = this.testExports.wl_handle_make_counter(this.toWlSint64(start));
+    return new WlHandle(this, this.testExports, value);
+  }
+
+  // handle 은 빌려주기만 하므로 호출 후에도 counter 의 참조는 그대로
+  counterAdd(counter: WlHandle | WlValue, delta: number): number {
+    const handle = typeof counter === "bigint" ? counter : counter.value;
+    return Number(this.decode(this.testExports.wl_handle_counter_add(handle, this.toWlSint64(delta))));
+  }
+
+  // items 가 count 개인 FLAT record (필드는 접근할 때만 읽음, 사용 후 release())
+  flatRecord(count: number): WlFlatView {
+    return this.fromWlFlat(this.testExports.wl_flat_record(this.toWlUint32(count)));
+  }
+
+  flatRecordValue(count: number): WlValue {
+    return this.testExports.wl_flat_record(this.toWlUint32(count));
+  }
+
+  // header + body + trailer 를 container 하나에 한 번씩만 복사해서 반환
+  gatherResponse(body: string): string {
+    return this.fromWlString(this.testExports.wl_gather_response(this.toWlString(body)));
+  }
+
+  // static segment 를 가리키는 IOVEC (segment 목록만 해제)
+  iovecGreeting(): WlIovecView {
+    return this.fromWlIovec(this.testExports.wl_iovec_greeting());
+  }
+
+  iovecGreetingValue(): WlValue {
+    return this.testExports.wl_iovec_greeting();
+  }
+
+  // str 를 times 번 반복 (긴 non-ASCII 결과는 STRING16 으로 반환됨)
+  textRepeat(str: string, times: number): string {
+    return this.fromWlString(this.textRepeatValue(str, times));
+  }
+
+  textRepeatValue(str: string, times: number): WlValue {
+    return this.testExports.wl_text_repeat(this.toWlString(str), this.toWlUint32(times));
+  }
+
+  // 코어 export walink_utf8_validate 로 bytes 가 올바른 UTF-8 인지 검사
+  utf8Valid(bytes: Uint8Array): boolean {
+    return this.fromWlBool(this.exports.walink_utf8_validate!(this.toWlBytes(bytes)));
+  }
+
+  liveCounters(): number {
+    return this.fromWlSint32(this.testExports.wl_handle_live_counters());
+  }
 }
 
 // 통합 테스트에서 사용할 편의 생성 함수
 export function createWalinkWithSampleApi(
   instance: WebAssembly.Instance,
+  ownership?: WalinkOwnership,
+  recycle?: boolean,
+  utf16Strings?: boolean,
 ): WalinkWithSampleApi {
   const exports = instance.exports as unknown as WalinkTestExports;
   if (!(exports.memory instanceof WebAssembly.Memory)) {
@@ -59,5 +246,5 @@ export function createWalinkWithSampleApi(
   }
   // walink_free 가 없는 경우도 방어적으로 체크할 수 있지만,
   // 현재 테스트 wasm 모듈은 항상 export 한다고 가정.
-  return new WalinkWithSampleApi(exports);
+  return new WalinkWithSampleApi(exports, ownership, recycle, utf16Strings);
 }
\ No newline at end of file
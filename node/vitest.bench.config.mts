@@ -0,0 +1,13 @@
+import { defineConfig } from "vitest/config";
+
+// pnpm bench: bench/*.bench.ts (JS <-> wasm 왕복 벤치마크)
+export default defineConfig({
+  test: {
+    globals: true,
+    environment: "node",
+    include: ["bench/**/*.bench.ts"],
+    testTimeout: 120_000,
+    // 측정이 서로 간섭하지 않도록 한 파일씩 실행
+    fileParallelism: false,
+  },
+});